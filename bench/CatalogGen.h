@@ -0,0 +1,166 @@
+#ifndef CATALOGGEN_H
+#define CATALOGGEN_H
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// =========================================================
+// SYNTHETIC CATALOG GENERATOR
+// Writes a resources.csv-compatible catalog of any size, shared
+// by cc_datagen and cc_bench_e2e.
+//
+// Shape:
+// - Topics follow a Zipf distribution (topicSkew 0 = uniform).
+// - Each resource sits on a level 0..depth-1; its prereqs are
+//   0..maxPrereqs resources from the level below (same topic 80%
+//   of the time), so curricula are at most 'depth' deep.
+// - Difficulty grows with the level; ratings lean towards 5.0 as
+//   ratingSkew grows (1 = uniform in [1, 5]).
+// - A few titles contain a comma and are written quoted.
+// Output depends only on the spec, seed included.
+// =========================================================
+
+namespace CatalogGen {
+
+    struct Spec {
+        size_t rows = 1000;
+        int topics = 24;
+        double topicSkew = 1.0;
+        int maxPrereqs = 3;
+        int depth = 6;
+        double ratingSkew = 2.0;
+        double quotedTitles = 0.02;
+        uint64_t seed = 42;
+    };
+
+    inline std::string topicName(int index) {
+        static const char* const base[] = {
+            "Arrays", "Linked Lists", "Stacks", "Queues", "Hashing", "Trees", "Binary Search Trees",
+            "Heaps", "Graphs", "Sorting", "Searching", "Recursion", "Dynamic Programming", "Greedy",
+            "Tries", "Backtracking", "Bit Manipulation", "Strings", "Complexity", "Pointers",
+            "Segment Trees", "Union Find", "Shortest Paths", "Geometry"
+        };
+        const int known = sizeof(base) / sizeof(base[0]);
+        if (index < known) return base[index];
+        return std::string(base[index % known]) + " " + std::to_string(index / known + 1);
+    }
+
+    // "10K" -> 10000, "2M" -> 2000000; 0 if the text is not a count
+    inline size_t parseCount(const std::string& text) {
+        char* end = nullptr;
+        double value = std::strtod(text.c_str(), &end);
+        if (end == text.c_str() || value < 0) return 0;
+        std::string suffix(end);
+        if (suffix == "K" || suffix == "k") value *= 1e3;
+        else if (suffix == "M" || suffix == "m") value *= 1e6;
+        else if (!suffix.empty()) return 0;
+        return static_cast<size_t>(value);
+    }
+
+    /**
+     * Writes the header row and spec.rows resources with IDs 1..rows.
+     */
+    inline void write(std::ostream& out, const Spec& spec) {
+        static const char* const adjectives[] = {
+            "Introduction to", "Practical", "Advanced", "Visual Guide to", "Mastering",
+            "Fundamentals of", "Deep Dive into", "Crash Course on"
+        };
+        static const char* const nouns[] = {
+            "Basics", "Patterns", "Techniques", "Problems", "Internals", "Tricks", "Applications", "Analysis"
+        };
+
+        std::mt19937_64 rng(spec.seed);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        const int topics = std::max(1, spec.topics);
+        const int depth = std::max(1, spec.depth);
+
+        // Zipf CDF over topics
+        std::vector<double> cdf(topics);
+        double total = 0;
+        for (int t = 0; t < topics; t++) {
+            total += 1.0 / std::pow(t + 1.0, spec.topicSkew);
+            cdf[t] = total;
+        }
+        std::vector<std::string> names(topics);
+        for (int t = 0; t < topics; t++) names[t] = topicName(t);
+
+        // IDs already written, per (topic, level), to draw prereqs from
+        std::vector<std::vector<int>> byLevel(static_cast<size_t>(topics) * depth);
+        std::vector<std::vector<int>> anyTopic(depth);
+
+        out << "ID,Title,URL,Topic,Difficulty,Rating,Prereqs,Duration\n";
+        std::string line, slug;
+        for (size_t i = 1; i <= spec.rows; i++) {
+            int id = static_cast<int>(i);
+            int topic = static_cast<int>(std::lower_bound(cdf.begin(), cdf.end(), unit(rng) * total) - cdf.begin());
+            topic = std::min(topic, topics - 1);
+            int level = static_cast<int>(unit(rng) * depth);
+            const std::string& topicText = names[topic];
+
+            const char* adjective = adjectives[rng() % 8];
+            const char* noun = nouns[rng() % 8];
+            std::string title = std::string(adjective) + " " + topicText + " " + noun + " " + std::to_string(id);
+            bool quoted = unit(rng) < spec.quotedTitles;
+            if (quoted) title = topicText + ", Part " + std::to_string(id);
+
+            slug.clear();
+            for (char c : topicText + " " + noun + " " + std::to_string(id)) {
+                slug += c == ' ' ? '+' : static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            }
+
+            int band = 100 / depth;
+            int difficulty = std::min(100, 1 + level * band + static_cast<int>(unit(rng) * band));
+            double rating = 1.0 + 4.0 * (1.0 - std::pow(unit(rng), std::max(0.01, spec.ratingSkew)));
+            int duration = 5 * (1 + static_cast<int>(unit(rng) * 24));
+
+            // Prereqs from the level below; duplicates are dropped
+            std::vector<int> prereqs;
+            if (level > 0) {
+                int wanted = static_cast<int>(unit(rng) * (spec.maxPrereqs + 1));
+                for (int p = 0; p < wanted; p++) {
+                    const std::vector<int>& pool = unit(rng) < 0.8
+                        ? byLevel[static_cast<size_t>(topic) * depth + level - 1] : anyTopic[level - 1];
+                    if (pool.empty()) continue;
+                    int pre = pool[rng() % pool.size()];
+                    if (std::find(prereqs.begin(), prereqs.end(), pre) == prereqs.end()) prereqs.push_back(pre);
+                }
+            }
+            byLevel[static_cast<size_t>(topic) * depth + level].push_back(id);
+            anyTopic[level].push_back(id);
+
+            line.clear();
+            line += std::to_string(id);
+            line += ',';
+            if (quoted) { line += '"'; line += title; line += '"'; } else line += title;
+            line += ",https://www.google.com/search?q=";
+            line += slug;
+            line += ',';
+            line += topicText;
+            line += ',';
+            line += std::to_string(difficulty);
+            line += ',';
+            char ratingText[8];
+            std::snprintf(ratingText, sizeof(ratingText), "%.1f", rating);
+            line += ratingText;
+            line += ',';
+            for (size_t p = 0; p < prereqs.size(); p++) {
+                if (p) line += ';';
+                line += std::to_string(prereqs[p]);
+            }
+            line += ',';
+            line += std::to_string(duration);
+            line += '\n';
+            out << line;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,132 @@
+// =========================================================
+// CSV SCANNER MICROBENCHMARK
+// Throughput (GB/s of CSV text) of the structural scanner kernels
+// against the std::getline + stringstream path they replace.
+//
+// Usage: cc_bench_csv_scan [csv file] [repetitions]
+// Without a file, a synthetic 500k-row catalog is generated.
+// =========================================================
+
+#include "../include/CSVParser.h"
+#include "../include/CSVScan.h"
+#include "../include/MappedFile.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+    typedef chrono::steady_clock Clock;
+
+    string syntheticCatalog(int rows) {
+        string text = "ID,Title,URL,Topic,Difficulty,Rating,Prereqs,Duration\n";
+        for (int i = 1; i <= rows; i++) {
+            text += to_string(i) + ",Resource title number " + to_string(i) +
+                    ",https://www.example.com/search?q=item+" + to_string(i) +
+                    ",Topic" + to_string(i % 50) + "," + to_string(i % 100) + ",4." + to_string(i % 10) + "," +
+                    (i > 2 ? to_string(i - 1) + ";" + to_string(i - 2) : string()) + "," + to_string(i % 90) + "\n";
+        }
+        return text;
+    }
+
+    // Best of 'reps' runs, in seconds
+    double bestOf(int reps, const function<void()>& body) {
+        double best = 1e30;
+        for (int r = 0; r < reps; r++) {
+            Clock::time_point start = Clock::now();
+            body();
+            best = min(best, chrono::duration<double>(Clock::now() - start).count());
+        }
+        return best;
+    }
+
+    void report(const string& name, size_t bytes, double seconds) {
+        cout << left << setw(34) << name << right << fixed << setprecision(2)
+             << setw(9) << bytes / seconds / 1e9 << " GB/s" << setw(11) << seconds * 1e3 << " ms" << endl;
+    }
+
+    void freeAll(vector<Resource*>& resources) {
+        for (auto* r : resources) delete r;
+        resources.clear();
+    }
+}
+
+int main(int argc, char* argv[]) {
+    string path = argc > 1 ? argv[1] : "";
+    int reps = argc > 2 ? max(1, atoi(argv[2])) : 3;
+
+    bool generated = path.empty();
+    if (generated) {
+        path = "cc_bench_csv_scan.tmp.csv";
+        ofstream(path, ios::binary) << syntheticCatalog(500000);
+    }
+
+    MappedFile file;
+    if (!file.open(path)) {
+        cerr << "Error: cannot open " << path << endl;
+        return 1;
+    }
+    const char* data = file.data();
+    size_t size = file.size();
+    cout << "Input: " << path << " (" << size / 1e6 << " MB), best of " << reps << endl << endl;
+
+    // 1. Tokenizing only: the original getline + stringstream split. The stream (and its
+    //    copy of the file) is set up once, untimed; each repetition rewinds it.
+    size_t checksum = 0;
+    istringstream in(string(data, size));
+    report("getline + stringstream split", size, bestOf(reps, [&] {
+        in.clear();
+        in.seekg(0);
+        string line, segment;
+        while (getline(in, line)) {
+            stringstream ss(line);
+            vector<string> row;
+            while (getline(ss, segment, ',')) row.push_back(segment);
+            checksum += row.size();
+        }
+    }));
+
+    // 2. Tokenizing only: walk every field boundary through each kernel's bitmaps
+    CSVScan::Kernel original = CSVScan::activeKernel();
+    for (CSVScan::Kernel kernel : CSVScan::availableKernels()) {
+        CSVScan::setKernel(kernel);
+        report(string("scan field ends (") + CSVScan::kernelName(kernel) + ")", size, bestOf(reps, [&] {
+            CSVScan::Cursor scan(data, size);
+            for (size_t pos = scan.next(0, CSVScan::MASK_FIELD_END); pos < size;
+                 pos = scan.next(pos + 1, CSVScan::MASK_FIELD_END)) {
+                checksum++;
+            }
+        }));
+    }
+    cout << endl;
+
+    // 3. Full load into Resource objects
+    vector<Resource*> resources;
+    report("loadResourcesStream (getline)", size, bestOf(reps, [&] {
+        resources = CSVParser::loadResourcesStream(path);
+        checksum += resources.size();
+        freeAll(resources);
+    }));
+    for (CSVScan::Kernel kernel : CSVScan::availableKernels()) {
+        CSVScan::setKernel(kernel);
+        report(string("parseRecords (") + CSVScan::kernelName(kernel) + ")", size, bestOf(reps, [&] {
+            CSVParser::parseRecords(data, size, resources, path, 1, true);
+            checksum += resources.size();
+            freeAll(resources);
+        }));
+    }
+    CSVScan::setKernel(original);
+
+    cout << endl << "(checksum " << checksum << ")" << endl;
+    file.close();
+    if (generated) remove(path.c_str());
+    return 0;
+}
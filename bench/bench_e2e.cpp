@@ -0,0 +1,308 @@
+// =========================================================
+// END-TO-END SCALING BENCHMARK (cc_bench_e2e)
+// For each catalog size: generate a synthetic catalog (CatalogGen.h),
+// parse it, build the engine, run every command type, tear down.
+// Prints one JSON document with per-size load/build times, memory
+// and per-command latency percentiles and throughput.
+//
+// Usage: cc_bench_e2e [options]
+//   --sizes LIST     Comma-separated row counts (default 1K,10K,100K)
+//   --reps N         Runs per command type (default 200; LIST runs reps/20)
+//   --analysis L     NONE|STATS|FULL appended to every command (default NONE)
+//   --workdir DIR    Where catalogs are written (default: current directory)
+//   --keep           Keep the generated catalogs
+//   --out FILE       Write the JSON there instead of stdout
+//   plus the generator options of cc_datagen (--topics, --depth, ...)
+//
+// On POSIX each size runs in a forked child, so memory numbers (peak
+// RSS in particular) belong to that size alone.
+// =========================================================
+
+#include "CatalogGen.h"
+#include "../include/CSVParser.h"
+#include "../include/CSVScan.h"
+#include "../include/ColumnStore.h"
+#include "../include/Engine.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#if !defined(_WIN32)
+    #include <sys/wait.h>
+    #include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+    typedef chrono::steady_clock Clock;
+
+    double millisSince(Clock::time_point start) {
+        return chrono::duration<double, milli>(Clock::now() - start).count();
+    }
+
+    // Swallows command output, counting bytes
+    class CountingBuffer : public streambuf {
+    public:
+        size_t bytes = 0;
+    protected:
+        int overflow(int c) override { bytes++; return c; }
+        streamsize xsputn(const char*, streamsize n) override { bytes += static_cast<size_t>(n); return n; }
+    };
+
+    // Resident and peak resident set size in MB (0 where /proc is unavailable)
+    void memoryUsage(double& rssMB, double& peakMB) {
+        rssMB = peakMB = 0;
+        ifstream status("/proc/self/status");
+        string key;
+        while (status >> key) {
+            double kb;
+            if (key == "VmRSS:" && status >> kb) rssMB = kb / 1024;
+            else if (key == "VmHWM:" && status >> kb) peakMB = kb / 1024;
+        }
+    }
+
+    struct Options {
+        vector<size_t> sizes;
+        int reps = 200;
+        string analysis = "NONE";
+        string workdir = ".";
+        bool keep = false;
+        CatalogGen::Spec spec;
+    };
+
+    struct CommandStats {
+        string name;
+        vector<double> micros;
+        size_t outputBytes = 0;
+        int failures = 0;
+    };
+
+    double percentile(const vector<double>& sorted, double p) {
+        if (sorted.empty()) return 0;
+        size_t rank = static_cast<size_t>(p / 100.0 * sorted.size() + 0.999999);
+        return sorted[min(sorted.size(), max<size_t>(rank, 1)) - 1];
+    }
+
+    // Commands of one type, each built from the catalog itself so every lookup can hit
+    vector<string> makeCommands(const string& type, const vector<Resource*>& data, int count, mt19937& rng) {
+        static const char* const levels[] = {"ALL", "BEGINNER", "INTERMEDIATE", "ADVANCED"};
+        vector<string> commands;
+        uniform_int_distribution<size_t> pick(0, data.size() - 1);
+        for (int i = 0; i < count; i++) {
+            const Resource* r = data[pick(rng)];
+            string topic = r->topic.str();
+            if (type == "LIST") {
+                commands.push_back(i % 2 ? "LIST|TOPIC" : "LIST|DIFFICULTY");
+            } else if (type == "SEARCH") {
+                string title(r->title);
+                commands.push_back("SEARCH|" + (i % 2 ? topic.substr(0, 3 + rng() % 4) : title.substr(0, 4 + rng() % 8)));
+            } else if (type == "PLAN") {
+                commands.push_back("PLAN|" + string(r->title));
+            } else if (type == "SUGGEST") {
+                commands.push_back("SUGGEST|10|" + string(levels[i % 4]));
+            } else if (type == "CRAM") {
+                commands.push_back("CRAM|" + topic + "|" + to_string(60 + 30 * (rng() % 8)));
+            }
+        }
+        return commands;
+    }
+
+    // Runs one size and prints its JSON result object
+    // Runs one catalog size and writes its JSON object. False if the catalog did not load in full.
+    bool runSize(size_t rows, const Options& options, ostream& json) {
+        CatalogGen::Spec spec = options.spec;
+        spec.rows = rows;
+        string path = options.workdir + "/cc_bench_e2e_" + to_string(rows) + ".csv";
+
+        Clock::time_point start = Clock::now();
+        {
+            ofstream out(path, ios::binary);
+            CatalogGen::write(out, spec);
+        }
+        double generateMs = millisSince(start);
+        double baseRss, basePeak;
+        memoryUsage(baseRss, basePeak);
+
+        // Load = parse into the engine's store; build = index every structure
+        Engine* engine = new Engine();
+        start = Clock::now();
+        vector<Resource*> data = CSVParser::loadResources(path, &engine->resources());
+        double parseMs = millisSince(start);
+        if (data.size() != rows) {
+            // Timings for a different row count would be reported under this size
+            cerr << "Error: loaded " << data.size() << " of " << rows << " generated rows from " << path << endl;
+            delete engine;
+            if (!options.keep) remove(path.c_str());
+            return false;
+        }
+        start = Clock::now();
+        engine->ingest(data);
+        engine->finishIngest();
+        engine->buildDeferredIndexes(); // CONTAINS/RANK indexes, built on first use otherwise
+        double buildMs = millisSince(start);
+        double builtRss, builtPeak;
+        memoryUsage(builtRss, builtPeak);
+
+        // Commands
+        mt19937 rng(static_cast<unsigned>(spec.seed));
+        Session session;
+        CountingBuffer sinkBuffer;
+        ostream sink(&sinkBuffer);
+        string prefix = "@" + options.analysis + " ";
+        vector<CommandStats> stats;
+        for (const char* type : {"LIST", "SEARCH", "PLAN", "SUGGEST", "CRAM"}) {
+            CommandStats s;
+            s.name = type;
+            int count = s.name == "LIST" ? max(1, options.reps / 20) : options.reps;
+            if (data.empty()) count = 0;
+            for (const string& command : data.empty() ? vector<string>() : makeCommands(type, data, count, rng)) {
+                size_t before = sinkBuffer.bytes;
+                Clock::time_point t = Clock::now();
+                if (!engine->execute(prefix + command, session, sink)) s.failures++;
+                s.micros.push_back(chrono::duration<double, micro>(Clock::now() - t).count());
+                s.outputBytes += sinkBuffer.bytes - before;
+            }
+            stats.push_back(s);
+        }
+        double runRss, runPeak;
+        memoryUsage(runRss, runPeak);
+
+        start = Clock::now();
+        delete engine;
+        double teardownMs = millisSince(start);
+        if (!options.keep) remove(path.c_str());
+
+        json << fixed << setprecision(3);
+        json << "    {\n";
+        json << "      \"rows\": " << rows << ",\n";
+        json << "      \"loaded\": " << data.size() << ",\n";
+        json << "      \"generate_ms\": " << generateMs << ",\n";
+        json << "      \"parse_ms\": " << parseMs << ",\n";
+        json << "      \"build_ms\": " << buildMs << ",\n";
+        json << "      \"teardown_ms\": " << teardownMs << ",\n";
+        json << "      \"load_rows_per_sec\": " << (parseMs + buildMs > 0 ? data.size() / ((parseMs + buildMs) / 1000) : 0) << ",\n";
+        json << "      \"rss_before_mb\": " << baseRss << ",\n";
+        json << "      \"rss_built_mb\": " << builtRss << ",\n";
+        json << "      \"rss_after_commands_mb\": " << runRss << ",\n";
+        json << "      \"peak_rss_mb\": " << runPeak << ",\n";
+        json << "      \"bytes_per_resource\": " << (data.empty() ? 0 : (builtRss - baseRss) * 1024 * 1024 / data.size()) << ",\n";
+        json << "      \"commands\": {\n";
+        for (size_t i = 0; i < stats.size(); i++) {
+            CommandStats& s = stats[i];
+            vector<double> sorted = s.micros;
+            sort(sorted.begin(), sorted.end());
+            double total = 0;
+            for (double us : sorted) total += us;
+            json << "        \"" << s.name << "\": {"
+                 << "\"count\": " << sorted.size()
+                 << ", \"failures\": " << s.failures
+                 << ", \"mean_us\": " << (sorted.empty() ? 0 : total / sorted.size())
+                 << ", \"p50_us\": " << percentile(sorted, 50)
+                 << ", \"p95_us\": " << percentile(sorted, 95)
+                 << ", \"p99_us\": " << percentile(sorted, 99)
+                 << ", \"max_us\": " << (sorted.empty() ? 0 : sorted.back())
+                 << ", \"per_sec\": " << (total > 0 ? sorted.size() / (total / 1e6) : 0)
+                 << ", \"output_bytes\": " << s.outputBytes << "}"
+                 << (i + 1 < stats.size() ? ",\n" : "\n");
+        }
+        json << "      }\n";
+        json << "    }";
+        json.flush();
+        return true;
+    }
+
+    void usage() {
+        cerr << "Usage: cc_bench_e2e [--sizes 1K,10K,100K] [--reps N] [--analysis NONE|STATS|FULL]\n"
+                "                    [--workdir DIR] [--keep] [--out FILE] [generator options, see cc_datagen]" << endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    string outPath, sizeList = "1K,10K,100K";
+
+    for (int i = 1; i < argc; i++) {
+        string flag = argv[i];
+        if (flag == "--help" || flag == "-h") { usage(); return 0; }
+        if (flag == "--keep") { options.keep = true; continue; }
+        if (i + 1 >= argc) { usage(); return 1; }
+        string value = argv[++i];
+
+        if (flag == "--sizes") sizeList = value;
+        else if (flag == "--reps") options.reps = max(1, atoi(value.c_str()));
+        else if (flag == "--analysis") options.analysis = value;
+        else if (flag == "--workdir") options.workdir = value;
+        else if (flag == "--out") outPath = value;
+        else if (flag == "--topics") options.spec.topics = atoi(value.c_str());
+        else if (flag == "--topic-skew") options.spec.topicSkew = atof(value.c_str());
+        else if (flag == "--max-prereqs") options.spec.maxPrereqs = atoi(value.c_str());
+        else if (flag == "--depth") options.spec.depth = atoi(value.c_str());
+        else if (flag == "--rating-skew") options.spec.ratingSkew = atof(value.c_str());
+        else if (flag == "--quoted") options.spec.quotedTitles = atof(value.c_str());
+        else if (flag == "--seed") options.spec.seed = strtoull(value.c_str(), nullptr, 10);
+        else { cerr << "Unknown option " << flag << endl; usage(); return 1; }
+    }
+
+    stringstream list(sizeList);
+    string item;
+    while (getline(list, item, ',')) {
+        size_t rows = CatalogGen::parseCount(item);
+        if (rows == 0) { cerr << "Error: bad size '" << item << "'" << endl; return 1; }
+        options.sizes.push_back(rows);
+    }
+
+    if (!outPath.empty() && !freopen(outPath.c_str(), "w", stdout)) {
+        cerr << "Error: cannot write " << outPath << endl;
+        return 1;
+    }
+
+    const CatalogGen::Spec& spec = options.spec;
+    cout << "{\n";
+    cout << "  \"benchmark\": \"cc_bench_e2e\",\n";
+    cout << "  \"csv_kernel\": \"" << CSVScan::kernelName(CSVScan::activeKernel()) << "\",\n";
+    cout << "  \"column_kernel\": \"" << ColumnStore::kernelName() << "\",\n";
+    cout << "  \"reps\": " << options.reps << ",\n";
+    cout << "  \"analysis\": \"" << options.analysis << "\",\n";
+    cout << "  \"spec\": {\"topics\": " << spec.topics << ", \"topic_skew\": " << spec.topicSkew
+         << ", \"max_prereqs\": " << spec.maxPrereqs << ", \"depth\": " << spec.depth
+         << ", \"rating_skew\": " << spec.ratingSkew << ", \"quoted\": " << spec.quotedTitles
+         << ", \"seed\": " << spec.seed << "},\n";
+    cout << "  \"results\": [\n";
+
+    for (size_t i = 0; i < options.sizes.size(); i++) {
+        cerr << "cc_bench_e2e: " << options.sizes[i] << " rows..." << endl;
+        cout.flush();
+#if !defined(_WIN32)
+        pid_t child = fork();
+        if (child == 0) {
+            bool loaded = runSize(options.sizes[i], options, cout);
+            cout.flush();
+            _exit(loaded ? 0 : 1);
+        }
+        int status = 0;
+        if (child < 0 || waitpid(child, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            cerr << "Error: run for " << options.sizes[i] << " rows failed" << endl;
+            return 1;
+        }
+#else
+        if (!runSize(options.sizes[i], options, cout)) {
+            cerr << "Error: run for " << options.sizes[i] << " rows failed" << endl;
+            return 1;
+        }
+#endif
+        cout << (i + 1 < options.sizes.size() ? ",\n" : "\n");
+    }
+
+    cout << "  ]\n}" << endl;
+    return 0;
+}
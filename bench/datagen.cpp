@@ -0,0 +1,79 @@
+// =========================================================
+// SYNTHETIC CATALOG GENERATOR (cc_datagen)
+// Writes a resources.csv-compatible catalog (see CatalogGen.h).
+//
+// Usage: cc_datagen [options]
+//   --rows N           Rows to generate, K/M suffixes allowed (default 100K)
+//   --topics N         Distinct topics (default 24)
+//   --topic-skew S     Zipf exponent of the topic mix, 0 = uniform (default 1.0)
+//   --max-prereqs N    Prereqs per resource, 0..N (default 3)
+//   --depth N          Prereq levels, i.e. the deepest curriculum (default 6)
+//   --rating-skew S    1 = uniform ratings, larger leans towards 5.0 (default 2.0)
+//   --quoted F         Fraction of titles with a quoted comma (default 0.02)
+//   --seed N           Random seed (default 42)
+//   --out FILE         Output file, "-" for stdout (default data/resources_<rows>.csv)
+// =========================================================
+
+#include "CatalogGen.h"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+namespace {
+
+    void usage() {
+        cerr << "Usage: cc_datagen [--rows N] [--topics N] [--topic-skew S] [--max-prereqs N] [--depth N]\n"
+                "                  [--rating-skew S] [--quoted F] [--seed N] [--out FILE|-]" << endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    CatalogGen::Spec spec;
+    spec.rows = 100000;
+    string outPath;
+
+    for (int i = 1; i < argc; i++) {
+        string flag = argv[i];
+        if (flag == "--help" || flag == "-h") { usage(); return 0; }
+        if (i + 1 >= argc) { usage(); return 1; }
+        string value = argv[++i];
+
+        if (flag == "--rows") spec.rows = CatalogGen::parseCount(value);
+        else if (flag == "--topics") spec.topics = atoi(value.c_str());
+        else if (flag == "--topic-skew") spec.topicSkew = atof(value.c_str());
+        else if (flag == "--max-prereqs") spec.maxPrereqs = atoi(value.c_str());
+        else if (flag == "--depth") spec.depth = atoi(value.c_str());
+        else if (flag == "--rating-skew") spec.ratingSkew = atof(value.c_str());
+        else if (flag == "--quoted") spec.quotedTitles = atof(value.c_str());
+        else if (flag == "--seed") spec.seed = strtoull(value.c_str(), nullptr, 10);
+        else if (flag == "--out") outPath = value;
+        else { cerr << "Unknown option " << flag << endl; usage(); return 1; }
+    }
+    if (spec.rows == 0) {
+        cerr << "Error: --rows must be a positive count (e.g. 5000, 10K, 2M)" << endl;
+        return 1;
+    }
+    if (outPath.empty()) outPath = "data/resources_" + to_string(spec.rows) + ".csv";
+
+    auto start = chrono::steady_clock::now();
+    if (outPath == "-") {
+        CatalogGen::write(cout, spec);
+    } else {
+        ofstream out(outPath, ios::binary);
+        if (!out.is_open()) {
+            cerr << "Error: cannot write " << outPath << endl;
+            return 1;
+        }
+        CatalogGen::write(out, spec);
+        if (!out.good()) {
+            cerr << "Error: write to " << outPath << " failed" << endl;
+            return 1;
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cerr << "Wrote " << spec.rows << " resources to " << outPath << " in " << seconds << " s" << endl;
+    return 0;
+}
@@ -0,0 +1,397 @@
+// =========================================================
+// PER-STRUCTURE MICROBENCHMARKS (cc_microbench)
+// Times the core operations of each data structure on a synthetic
+// catalog (CatalogGen.h): warmup runs, then repeated measured runs,
+// reported as per-operation percentiles across the runs.
+//
+// Usage: cc_microbench [options]
+//   --rows N          Catalog size (default 10K)
+//   --reps N          Measured runs per benchmark (default 15)
+//   --warmup N        Unmeasured runs first (default 3)
+//   --filter TEXT     Only benchmarks whose name contains TEXT
+//   --out FILE        Write the JSON there instead of stdout
+//   --baseline FILE   Compare p50 against an earlier JSON result
+//   --threshold PCT   Slowdown that counts as a regression (default 10)
+//   --seed N          Generator seed (default 42)
+//
+// Exit status: 0, 1 on bad usage or input, 2 if a benchmark regressed
+// against the baseline.
+// =========================================================
+
+#include "CatalogGen.h"
+#include "../include/AVLTree.h"
+#include "../include/CSVParser.h"
+#include "../include/KnowledgeGraph.h"
+#include "../include/LRUCache.h"
+#include "../include/MaxHeap.h"
+#include "../include/NGramIndex.h"
+#include "../include/Optimizer.h"
+#include "../include/ResourceStore.h"
+#include "../include/Sorters.h"
+#include "../include/TextIndex.h"
+#include "../include/Trie.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+    typedef chrono::steady_clock Clock;
+
+    // Sink for results so the optimizer can't drop the work being timed
+    volatile size_t checksum = 0;
+
+    struct Options {
+        size_t rows = 10000;
+        int reps = 15;
+        int warmup = 3;
+        string filter;
+        string baseline;
+        double threshold = 10.0;
+        uint64_t seed = 42;
+    };
+
+    // One benchmark: 'setup' runs untimed before every run of 'body', which performs 'ops' operations
+    struct Case {
+        string name;
+        size_t ops;
+        function<void()> setup;
+        function<void()> body;
+    };
+
+    struct Result {
+        string name;
+        size_t ops = 0;
+        vector<double> nsPerOp; // One entry per measured run, sorted
+    };
+
+    double percentile(const vector<double>& sorted, double p) {
+        if (sorted.empty()) return 0;
+        size_t rank = static_cast<size_t>(p / 100.0 * sorted.size() + 0.999999);
+        return sorted[min(sorted.size(), max<size_t>(rank, 1)) - 1];
+    }
+
+    double mean(const vector<double>& values) {
+        double total = 0;
+        for (double v : values) total += v;
+        return values.empty() ? 0 : total / values.size();
+    }
+
+    Result measure(const Case& c, const Options& options) {
+        Result result;
+        result.name = c.name;
+        result.ops = c.ops;
+        for (int run = 0; run < options.warmup + options.reps; run++) {
+            if (c.setup) c.setup();
+            Clock::time_point start = Clock::now();
+            c.body();
+            double ns = chrono::duration<double, nano>(Clock::now() - start).count();
+            if (run >= options.warmup) result.nsPerOp.push_back(ns / max<size_t>(c.ops, 1));
+        }
+        sort(result.nsPerOp.begin(), result.nsPerOp.end());
+        return result;
+    }
+
+    // Benchmark name -> p50_ns from a JSON file written by this tool (one result per line)
+    bool readBaseline(const string& path, map<string, double>& p50) {
+        ifstream in(path);
+        if (!in) return false;
+        string line;
+        while (getline(in, line)) {
+            size_t name = line.find("\"name\": \"");
+            size_t value = line.find("\"p50_ns\": ");
+            if (name == string::npos || value == string::npos) continue;
+            name += 9;
+            size_t nameEnd = line.find('"', name);
+            if (nameEnd == string::npos) continue;
+            p50[line.substr(name, nameEnd - name)] = atof(line.c_str() + value + 10);
+        }
+        return true;
+    }
+
+    // Prints a comparison table to stderr; returns the number of regressions
+    int compare(const vector<Result>& results, const map<string, double>& baseline, double threshold) {
+        int regressions = 0;
+        cerr << endl << left << setw(24) << "benchmark" << right << setw(14) << "baseline ns"
+             << setw(14) << "p50 ns" << setw(10) << "change" << endl;
+        for (const Result& r : results) {
+            double now = percentile(r.nsPerOp, 50);
+            auto it = baseline.find(r.name);
+            cerr << left << setw(24) << r.name << right << fixed << setprecision(1);
+            if (it == baseline.end() || it->second <= 0) {
+                cerr << setw(14) << "-" << setw(14) << now << setw(10) << "new" << endl;
+                continue;
+            }
+            double change = (now - it->second) / it->second * 100.0;
+            bool regressed = change > threshold;
+            if (regressed) regressions++;
+            cerr << setw(14) << it->second << setw(14) << now << setw(9) << showpos << change << noshowpos << "%"
+                 << (regressed ? "  REGRESSION" : change < -threshold ? "  faster" : "") << endl;
+        }
+        for (const auto& entry : baseline) {
+            bool present = false;
+            for (const Result& r : results) present = present || r.name == entry.first;
+            if (!present) cerr << left << setw(24) << entry.first << "  (missing from this run)" << endl;
+        }
+        return regressions;
+    }
+
+    void usage() {
+        cerr << "Usage: cc_microbench [--rows N] [--reps N] [--warmup N] [--filter TEXT] [--out FILE]\n"
+                "                     [--baseline FILE] [--threshold PCT] [--seed N]" << endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    string outPath;
+
+    for (int i = 1; i < argc; i++) {
+        string flag = argv[i];
+        if (flag == "--help" || flag == "-h") { usage(); return 0; }
+        if (i + 1 >= argc) { usage(); return 1; }
+        string value = argv[++i];
+
+        if (flag == "--rows") options.rows = CatalogGen::parseCount(value);
+        else if (flag == "--reps") options.reps = max(1, atoi(value.c_str()));
+        else if (flag == "--warmup") options.warmup = max(0, atoi(value.c_str()));
+        else if (flag == "--filter") options.filter = value;
+        else if (flag == "--out") outPath = value;
+        else if (flag == "--baseline") options.baseline = value;
+        else if (flag == "--threshold") options.threshold = atof(value.c_str());
+        else if (flag == "--seed") options.seed = strtoull(value.c_str(), nullptr, 10);
+        else { cerr << "Unknown option " << flag << endl; usage(); return 1; }
+    }
+    if (options.rows == 0) { cerr << "Error: --rows must be a positive count" << endl; return 1; }
+
+    map<string, double> baseline;
+    if (!options.baseline.empty() && !readBaseline(options.baseline, baseline)) {
+        cerr << "Error: cannot read baseline " << options.baseline << endl;
+        return 1;
+    }
+
+    // Catalog
+    CatalogGen::Spec spec;
+    spec.rows = options.rows;
+    spec.seed = options.seed;
+    ostringstream csv;
+    CatalogGen::write(csv, spec);
+    string text = csv.str();
+    ResourceStore store;
+    vector<Resource*> data;
+    CSVParser::parseRecords(text.data(), text.size(), data, "cc_microbench", 1, true, &store);
+    if (data.empty()) { cerr << "Error: generated catalog is empty" << endl; return 1; }
+    const size_t n = data.size();
+
+    mt19937_64 rng(options.seed);
+    vector<Resource*> shuffled = data;
+    shuffle(shuffled.begin(), shuffled.end(), rng);
+
+    // Query streams, drawn from the catalog so lookups hit
+    const size_t queryCount = min<size_t>(n, 2000);
+    vector<string> prefixes;
+    vector<int> lookupIDs, targetIDs;
+    for (size_t i = 0; i < queryCount; i++) {
+        const Resource* r = data[rng() % n];
+        string key = i % 2 ? r->topic.str() : string(r->title);
+        prefixes.push_back(key.substr(0, 3 + rng() % 6));
+        lookupIDs.push_back(data[rng() % n]->id);
+        targetIDs.push_back(data[rng() % n]->id);
+    }
+
+    // Substrings from inside titles, for the n-gram index (own generator: the streams above stay put)
+    mt19937_64 infixRng(options.seed + 1);
+    vector<string> infixes, rareInfixes;
+    for (size_t i = 0; i < queryCount; i++) {
+        string title(data[infixRng() % n]->title);
+        size_t length = min<size_t>(title.size(), 4 + infixRng() % 5);
+        infixes.push_back(title.substr(infixRng() % (title.size() - length + 1), length));
+        // Title endings carry the generator's serial number: few matches each
+        rareInfixes.push_back(title.substr(title.size() - min<size_t>(title.size(), 7)));
+    }
+
+    // Catalog prefixes with two adjacent bytes swapped (one edit), for fuzzy search
+    mt19937_64 typoRng(options.seed + 2);
+    vector<string> typos;
+    for (size_t i = 0; i < queryCount; i++) {
+        string typo = prefixes[i];
+        if (typo.size() >= 2) {
+            size_t at = typoRng() % (typo.size() - 1);
+            swap(typo[at], typo[at + 1]);
+        }
+        typos.push_back(typo);
+    }
+
+    // Multi-word queries: two or three words of a title, sometimes with its topic
+    mt19937_64 wordRng(options.seed + 3);
+    vector<string> wordQueries;
+    for (size_t i = 0; i < queryCount; i++) {
+        const Resource* r = data[wordRng() % n];
+        vector<string> words = TextIndex::tokenize(r->title);
+        string q;
+        for (int w = 0, count = 2 + static_cast<int>(wordRng() % 2); w < count && !words.empty(); w++) {
+            q += words[wordRng() % words.size()] + " ";
+        }
+        if (wordRng() % 2) q += r->topic.str();
+        wordQueries.push_back(q);
+    }
+
+    // LRU access stream: Session's capacity, mostly re-touching a small hot set
+    const int cacheCapacity = 5;
+    vector<Resource*> cacheStream;
+    for (size_t i = 0; i < queryCount * 10; i++) {
+        cacheStream.push_back(rng() % 4 ? shuffled[rng() % 8] : shuffled[rng() % n]);
+    }
+
+    // Knapsack input: the DP is O(items * minutes), so a CRAM-sized candidate set
+    vector<Resource*> knapsackItems(shuffled.begin(), shuffled.begin() + min<size_t>(n, 200));
+    const int knapsackMinutes = 600;
+
+    // Prebuilt structures for the read-only benchmarks
+    Trie builtTrie;
+    AVLTree builtTree;
+    KnowledgeGraph builtGraph;
+    builtGraph.reserve(n);
+    for (Resource* r : shuffled) {
+        builtTrie.insert(r->title, r->id);
+        builtTrie.insert(r->topic, r->id);
+        builtTree.insert(r);
+        builtGraph.addResource(r);
+    }
+    builtGraph.buildGraph(data);
+    // Same keys in the read-only layout the engine serves from
+    FrozenTrie frozenArrays;
+    builtTrie.exportFrozen(frozenArrays);
+    Trie frozenTrie;
+    frozenTrie.importFrozen(std::move(frozenArrays));
+    unordered_map<int, double> ratingOf;
+    for (Resource* r : data) ratingOf[r->id] = r->rating;
+    frozenTrie.rankCompletions([&ratingOf](int id) { return ratingOf[id]; });
+    NGramIndex builtInfix;
+    builtInfix.build(data);
+    TextIndex builtText;
+    builtText.build(data);
+
+    // Per-run scratch state, rebuilt by each case's setup
+    unique_ptr<Trie> trie;
+    unique_ptr<AVLTree> tree;
+    unique_ptr<MaxHeap> heap;
+    unique_ptr<LRUCache> cache;
+    vector<Resource*> work;
+
+    vector<Case> cases;
+    cases.push_back({"trie.insert", 2 * n,
+        [&] { trie.reset(new Trie()); },
+        [&] { for (Resource* r : shuffled) { trie->insert(r->title, r->id); trie->insert(r->topic, r->id); } }});
+    cases.push_back({"trie.prefix", prefixes.size(), nullptr,
+        [&] { for (const string& p : prefixes) checksum += builtTrie.getResourcesByPrefix(p).size(); }});
+    cases.push_back({"trie.prefix.frozen", prefixes.size(), nullptr,
+        [&] { for (const string& p : prefixes) checksum += frozenTrie.getResourcesByPrefix(p).size(); }});
+    cases.push_back({"trie.complete", prefixes.size(), nullptr,
+        [&] { for (const string& p : prefixes) checksum += frozenTrie.complete(p.substr(0, 1 + p.size() % 4), 10).size(); }});
+    cases.push_back({"ngram.build", n, nullptr,
+        [&] { NGramIndex index; index.build(data); checksum += index.gramCount(); }});
+    cases.push_back({"ngram.contains", infixes.size(), nullptr,
+        [&] { vector<uint32_t> rows; for (const string& q : infixes) { builtInfix.find(q, rows); checksum += rows.size(); } }});
+    cases.push_back({"ngram.contains.rare", rareInfixes.size(), nullptr,
+        [&] { vector<uint32_t> rows; for (const string& q : rareInfixes) { builtInfix.find(q, rows); checksum += rows.size(); } }});
+    cases.push_back({"trie.fuzzy.1", typos.size(), nullptr,
+        [&] { for (const string& q : typos) checksum += frozenTrie.fuzzySearch(q, 1).size(); }});
+    cases.push_back({"trie.fuzzy.2", typos.size(), nullptr,
+        [&] { for (const string& q : typos) checksum += frozenTrie.fuzzySearch(q, 2).size(); }});
+    cases.push_back({"text.build", n, nullptr,
+        [&] { TextIndex index; index.build(data); checksum += index.termCount(); }});
+    cases.push_back({"text.rank", wordQueries.size(), nullptr,
+        [&] { vector<TextIndex::Hit> hits; for (const string& q : wordQueries) { builtText.topK(q, 10, 0.0, hits); checksum += hits.size(); } }});
+    cases.push_back({"text.rank.rated", wordQueries.size(), nullptr,
+        [&] { vector<TextIndex::Hit> hits; for (const string& q : wordQueries) { builtText.topK(q, 10, 0.2, hits); checksum += hits.size(); } }});
+    cases.push_back({"text.rank.exhaustive", wordQueries.size(), nullptr,
+        [&] { vector<TextIndex::Hit> hits; for (const string& q : wordQueries) { builtText.topKExhaustive(q, 10, 0.0, hits); checksum += hits.size(); } }});
+    cases.push_back({"avl.insert", n,
+        [&] { tree.reset(new AVLTree()); },
+        [&] { for (Resource* r : shuffled) tree->insert(r); }});
+    cases.push_back({"avl.search", lookupIDs.size(), nullptr,
+        [&] { for (int id : lookupIDs) checksum += builtTree.search(id) != nullptr; }});
+    cases.push_back({"heap.insert", n,
+        [&] { heap.reset(new MaxHeap()); },
+        [&] { for (Resource* r : shuffled) heap->insert(r); }});
+    cases.push_back({"heap.extract", n,
+        [&] { heap.reset(new MaxHeap()); for (Resource* r : shuffled) heap->insert(r); },
+        [&] { while (!heap->isEmpty()) checksum += heap->extractMax()->id; }});
+    cases.push_back({"lru.get", cacheStream.size(),
+        [&] { cache.reset(new LRUCache(cacheCapacity)); for (int i = 0; i < 8; i++) cache->put(shuffled[i]); },
+        [&] { for (Resource* r : cacheStream) checksum += cache->get(r->id) != nullptr; }});
+    cases.push_back({"lru.put", cacheStream.size(),
+        [&] { cache.reset(new LRUCache(cacheCapacity)); },
+        [&] { for (Resource* r : cacheStream) cache->put(r); }});
+    cases.push_back({"sort.difficulty", n,
+        [&] { work = shuffled; },
+        [&] { Sorters::sortByDifficulty(work); }});
+    cases.push_back({"sort.topic", n,
+        [&] { work = shuffled; },
+        [&] { Sorters::sortByTopic(work); }});
+    cases.push_back({"graph.curriculum", targetIDs.size(), nullptr,
+        [&] { for (int id : targetIDs) checksum += builtGraph.getCurriculum(id).size(); }});
+    cases.push_back({"optimizer.knapsack", 1, nullptr,
+        [&] { checksum += Optimizer::maximizeRating(knapsackItems, knapsackMinutes).size(); }});
+
+    vector<Result> results;
+    for (const Case& c : cases) {
+        if (!options.filter.empty() && c.name.find(options.filter) == string::npos) continue;
+        cerr << "cc_microbench: " << c.name << "..." << endl;
+        results.push_back(measure(c, options));
+    }
+    trie.reset(); tree.reset(); heap.reset(); cache.reset();
+
+    if (!outPath.empty() && !freopen(outPath.c_str(), "w", stdout)) {
+        cerr << "Error: cannot write " << outPath << endl;
+        return 1;
+    }
+
+    cout << fixed << setprecision(3);
+    cout << "{\n";
+    cout << "  \"benchmark\": \"cc_microbench\",\n";
+    cout << "  \"rows\": " << n << ",\n";
+    cout << "  \"reps\": " << options.reps << ",\n";
+    cout << "  \"warmup\": " << options.warmup << ",\n";
+    cout << "  \"seed\": " << options.seed << ",\n";
+    cout << "  \"trie_nodes\": " << builtTrie.getNodeCount() << ",\n";
+    cout << "  \"trie_memory_bytes\": " << builtTrie.getMemoryUsage() << ",\n";
+    cout << "  \"frozen_trie_memory_bytes\": " << frozenTrie.getMemoryUsage() << ",\n";
+    cout << "  \"ngram_memory_bytes\": " << builtInfix.memoryUsage() << ",\n";
+    cout << "  \"text_index_memory_bytes\": " << builtText.memoryUsage() << ",\n";
+    cout << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        cout << "    {\"name\": \"" << r.name << "\""
+             << ", \"ops\": " << r.ops
+             << ", \"min_ns\": " << r.nsPerOp.front()
+             << ", \"mean_ns\": " << mean(r.nsPerOp)
+             << ", \"p50_ns\": " << percentile(r.nsPerOp, 50)
+             << ", \"p90_ns\": " << percentile(r.nsPerOp, 90)
+             << ", \"p99_ns\": " << percentile(r.nsPerOp, 99)
+             << ", \"max_ns\": " << r.nsPerOp.back() << "}"
+             << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    cout << "  ]\n}" << endl;
+
+    if (options.baseline.empty()) return 0;
+    int regressions = compare(results, baseline, options.threshold);
+    cerr << endl << regressions << " regression(s) beyond " << options.threshold << "%"
+         << " (checksum " << checksum << ")" << endl;
+    return regressions > 0 ? 2 : 0;
+}
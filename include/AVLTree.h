@@ -20,6 +20,7 @@ struct AVLNode {
 class AVLTree {
 private:
     AVLNode* root;
+    unsigned long revision; // Bumped on every mutation (lets callers cache derived views)
 
     int height(AVLNode* n) { return n ? n->height : 0; }
     int getBalance(AVLNode* n) { return n ? height(n->left) - height(n->right) : 0; }
@@ -73,6 +74,43 @@ private:
         return node;
     }
 
+    AVLNode* rebalance(AVLNode* node) {
+        node->height = 1 + std::max(height(node->left), height(node->right));
+        int balance = getBalance(node);
+        if (balance > 1) {
+            if (getBalance(node->left) < 0) node->left = leftRotate(node->left);
+            return rightRotate(node);
+        }
+        if (balance < -1) {
+            if (getBalance(node->right) > 0) node->right = rightRotate(node->right);
+            return leftRotate(node);
+        }
+        return node;
+    }
+
+    AVLNode* removeNode(AVLNode* node, int id, bool& removed) {
+        if (!node) return nullptr;
+        if (id < node->data->id) {
+            node->left = removeNode(node->left, id, removed);
+        } else if (id > node->data->id) {
+            node->right = removeNode(node->right, id, removed);
+        } else {
+            removed = true;
+            if (!node->left || !node->right) {
+                AVLNode* child = node->left ? node->left : node->right;
+                delete node;
+                return child;
+            }
+            // Two children: take over the in-order successor's resource
+            AVLNode* successor = node->right;
+            while (successor->left) successor = successor->left;
+            node->data = successor->data;
+            bool ignored = false;
+            node->right = removeNode(node->right, successor->data->id, ignored);
+        }
+        return rebalance(node);
+    }
+
     Resource* searchRec(AVLNode* node, int id) {
         if (!node) return nullptr;
         if (id == node->data->id) return node->data;
@@ -111,6 +149,17 @@ void inorderRec(AVLNode* node, std::vector<Resource*>& result) {
         return std::max({balance, leftBalance, rightBalance});
     }
 
+    // Builds a perfectly balanced subtree from sorted[lo..hi] - no rotations needed
+    AVLNode* buildBalancedRec(const std::vector<Resource*>& sorted, int lo, int hi) {
+        if (lo > hi) return nullptr;
+        int mid = lo + (hi - lo) / 2;
+        AVLNode* node = new AVLNode(sorted[mid]);
+        node->left = buildBalancedRec(sorted, lo, mid - 1);
+        node->right = buildBalancedRec(sorted, mid + 1, hi);
+        node->height = 1 + std::max(height(node->left), height(node->right));
+        return node;
+    }
+
     void getTreeStructureRec(AVLNode* node, std::vector<std::string>& edges, std::vector<std::string>& nodes) {
         if (!node) return;
         
@@ -132,16 +181,63 @@ void inorderRec(AVLNode* node, std::vector<Resource*>& result) {
         }
     }
 
+    // Frees the nodes only; the Resources belong to the caller
+    void destroyRec(AVLNode* node) {
+        if (!node) return;
+        destroyRec(node->left);
+        destroyRec(node->right);
+        delete node;
+    }
+
 public:
-    AVLTree() : root(nullptr) {}
+    AVLTree() : root(nullptr), revision(0) {}
+    ~AVLTree() { destroyRec(root); }
+
+    AVLTree(const AVLTree&) = delete;
+    AVLTree& operator=(const AVLTree&) = delete;
 
     void insert(Resource* r) {
         root = insertNode(root, r);
+        revision++;
     }
 
     Resource* search(int id) {
         return searchRec(root, id);
     }
+
+    // O(log n) delete with rebalancing. Returns false if the ID is not stored.
+    bool remove(int id) {
+        bool removed = false;
+        root = removeNode(root, id, removed);
+        if (removed) revision++;
+        return removed;
+    }
+
+    // Points the node for r->id at a new resource object; the shape does not change
+    bool replace(Resource* r) {
+        AVLNode* node = root;
+        while (node && node->data->id != r->id) {
+            node = r->id < node->data->id ? node->left : node->right;
+        }
+        if (!node) return false;
+        node->data = r;
+        revision++;
+        return true;
+    }
+
+    // Bulk load in O(n) from resources sorted by ID (e.g. a snapshot).
+    // Duplicate IDs keep their first occurrence, same as insert(). Expects an empty tree.
+    void buildFromSorted(const std::vector<Resource*>& sorted) {
+        std::vector<Resource*> unique;
+        unique.reserve(sorted.size());
+        for (Resource* r : sorted) {
+            if (unique.empty() || unique.back()->id != r->id) unique.push_back(r);
+        }
+        root = buildBalancedRec(unique, 0, static_cast<int>(unique.size()) - 1);
+        revision++;
+    }
+
+    unsigned long getRevision() const { return revision; }
  // [ADDED] Public function to get sorted list
     std::vector<Resource*> inorderTraversal() {
         std::vector<Resource*> result;
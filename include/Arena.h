@@ -0,0 +1,108 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string_view>
+#include <vector>
+
+// =========================================================
+// ARENA (bump allocator)
+// Hands out memory from a few large blocks. Nothing is freed
+// individually: every block is released at once when the arena
+// is destroyed. Objects placed in an arena must not need their
+// destructors run.
+//
+// Blocks start at 64 KB and double up to 8 MB, so a catalog of
+// a million resources costs a few dozen malloc/free calls.
+// Not thread-safe: one writer at a time (see ResourceStore).
+// =========================================================
+
+class Arena {
+private:
+    static const size_t kFirstBlock = 64 * 1024;
+    static const size_t kMaxBlock = 8 * 1024 * 1024;
+
+    std::vector<char*> blocks;
+    char* cursor;
+    size_t remaining;
+    size_t nextBlock;
+    size_t reserved;    // Bytes obtained from malloc
+    size_t used;        // Bytes handed out (including alignment padding)
+
+    void grow(size_t minimum) {
+        size_t size = nextBlock;
+        while (size < minimum) size *= 2;
+        if (nextBlock < kMaxBlock) nextBlock *= 2;
+
+        char* block = static_cast<char*>(std::malloc(size));
+        if (!block) throw std::bad_alloc();
+        blocks.push_back(block);
+        cursor = block;
+        remaining = size;
+        reserved += size;
+    }
+
+public:
+    Arena() : cursor(nullptr), remaining(0), nextBlock(kFirstBlock), reserved(0), used(0) {}
+    ~Arena() { release(); }
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t bytes, size_t align = alignof(std::max_align_t)) {
+        size_t padding = (align - reinterpret_cast<uintptr_t>(cursor) % align) % align;
+        if (padding + bytes > remaining) {
+            grow(bytes + align);
+            padding = (align - reinterpret_cast<uintptr_t>(cursor) % align) % align;
+        }
+        char* p = cursor + padding;
+        cursor = p + bytes;
+        remaining -= padding + bytes;
+        used += padding + bytes;
+        return p;
+    }
+
+    template <typename T>
+    T* allocateArray(size_t count) {
+        return count ? static_cast<T*>(allocate(count * sizeof(T), alignof(T))) : nullptr;
+    }
+
+    // Copies 's' into the arena. The copy is not NUL-terminated.
+    std::string_view copy(std::string_view s) {
+        if (s.empty()) return std::string_view();
+        char* p = static_cast<char*>(allocate(s.size(), 1));
+        std::memcpy(p, s.data(), s.size());
+        return std::string_view(p, s.size());
+    }
+
+    /**
+     * Takes over every block of 'other' (which ends up empty). Memory handed
+     * out by 'other' stays valid and is now released with this arena.
+     */
+    void absorb(Arena& other) {
+        blocks.insert(blocks.end(), other.blocks.begin(), other.blocks.end());
+        reserved += other.reserved;
+        used += other.used;
+        other.blocks.clear();
+        other.cursor = nullptr;
+        other.remaining = other.reserved = other.used = 0;
+    }
+
+    void release() {
+        for (char* block : blocks) std::free(block);
+        blocks.clear();
+        cursor = nullptr;
+        remaining = reserved = used = 0;
+        nextBlock = kFirstBlock;
+    }
+
+    size_t blockCount() const { return blocks.size(); }
+    size_t bytesReserved() const { return reserved; }
+    size_t bytesUsed() const { return used; }
+};
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <istream>
+#include <ostream>
+#include "Engine.h"
+
+// =========================================================
+// BATCH MODULE
+// Responsibility: Run thousands of commands (offline jobs, e.g.
+// precomputing every topic's study plan) against one Engine build.
+//
+// Input: one command per line ("SEARCH|Graph", "PLAN|Dijkstra", ...).
+// Blank lines and lines starting with '#' are ignored.
+// Output, per command n (1-based, input order):
+//     ---COMMAND <n>|<command>---
+//     ...normal command output...
+//     ---END_COMMAND <n>|OK|<microseconds>---    (or |ERROR|)
+// followed by one ---BATCH_SUMMARY--- block with per-action counts,
+// total time and latency percentiles.
+//
+// Before anything runs, Engine::prepareBatch resolves the shared
+// work grouped by kind (all trie prefixes, then all ID lookups),
+// so repeated prefixes and IDs cost one lookup per batch.
+// =========================================================
+
+namespace Batch {
+
+    /**
+     * Reads every command from `in`, executes them in order on one Session.
+     * @return Process exit code (0 if every command succeeded, 2 otherwise).
+     */
+    int run(const Engine& engine, std::istream& in, std::ostream& out);
+
+}
+
+#endif
@@ -0,0 +1,134 @@
+#ifndef BINARYCATALOG_H
+#define BINARYCATALOG_H
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <functional>
+#include "Resource.h"
+#include "ResourceStore.h"
+#include "MappedFile.h"
+
+// =========================================================
+// BINARY CATALOG MODULE
+// Responsibility: A compact on-disk form of resources.csv for
+// serving nodes. CSVParser stays the interchange format; this is
+// what gets shipped and loaded.
+//
+// Layout:
+//     [Header] [topic dictionary] [URL prefix dictionary]
+//     [block 0] [block 1] ... [block index]
+// - Topics and URL prefixes (see UrlRef) are stored once, in the
+//   dictionaries, and referenced by index.
+// - Records are grouped into blocks of up to recordsPerBlock. Each
+//   block decodes on its own, so a reader can fetch any subset of
+//   blocks; the index gives every block's ID range.
+// - Inside a record, strings are varint-length-prefixed and all
+//   integers are varints. IDs are zigzag deltas from the previous
+//   record (so ID-sorted catalogs cost ~1 byte per ID); prereqs
+//   are zigzag deltas from the resource's own ID, then from each
+//   other. Ratings with at most two decimals are stored as varint
+//   hundredths, anything else as the raw 8-byte double.
+// Record order and every field round-trip exactly.
+// =========================================================
+
+namespace BinaryCatalog {
+
+    const uint32_t kVersion = 1;
+    const uint32_t kDefaultRecordsPerBlock = 4096;
+
+    struct Header {
+        char magic[8];              // "CCBCAT\0\0"
+        uint32_t version;
+        uint32_t endianTag;         // 0x01020304 as written by the producer
+        uint64_t resourceCount;
+        uint32_t blockCount;
+        uint32_t recordsPerBlock;
+        uint32_t topicCount;
+        uint32_t prefixCount;
+        uint64_t dictionaryOffset;  // Topic dictionary, then URL prefix dictionary
+        uint64_t dictionaryLength;
+        uint64_t indexOffset;       // BlockEntry[blockCount]
+        uint64_t metaChecksum;      // FNV-1a 64 over the dictionaries and the block index
+    };
+
+    struct BlockEntry {
+        uint64_t offset;
+        uint32_t length;            // In bytes
+        uint32_t count;             // Records in the block
+        int32_t minID, maxID;
+        uint64_t checksum;          // FNV-1a 64 over the block's bytes
+    };
+
+    /**
+     * Writes resources (in the given order) as a binary catalog.
+     * @return false on I/O error.
+     */
+    bool write(const std::string& path, const std::vector<Resource*>& resources,
+               uint32_t recordsPerBlock = kDefaultRecordsPerBlock);
+
+    // True if 'path' starts with the binary catalog magic
+    bool isBinaryCatalog(const std::string& path);
+
+    // A validated, memory-mapped catalog. Blocks are checksummed and decoded only when read.
+    class Reader {
+    private:
+        MappedFile file;
+        const Header* header;
+        const BlockEntry* index;
+        std::vector<Topic> topics;              // Dictionary index -> interned topic
+        std::vector<uint32_t> prefixes;         // Dictionary index -> interned URL prefix
+        std::vector<std::string_view> prefixText;
+
+    public:
+        Reader() : header(nullptr), index(nullptr) {}
+
+        /**
+         * Maps the file and validates the header, dictionaries and block index.
+         * @param reason Filled with a short explanation when the file is rejected.
+         */
+        bool open(const std::string& path, std::string& reason);
+
+        size_t resourceCount() const { return header ? static_cast<size_t>(header->resourceCount) : 0; }
+        size_t blockCount() const { return header ? header->blockCount : 0; }
+        const BlockEntry& block(size_t i) const { return index[i]; }
+
+        /**
+         * Decodes block i, appending its resources to 'out' (allocated in 'store',
+         * or standalone heap Resources without one).
+         * @return false if the block is corrupt; nothing is appended then.
+         */
+        bool readBlock(size_t i, std::vector<Resource*>& out, ResourceStore* store = nullptr) const;
+
+        // Every block in file order; false (with 'out' unchanged) if any block is corrupt
+        bool readAll(std::vector<Resource*>& out, ResourceStore* store = nullptr) const;
+
+        /**
+         * Resources with minID <= id <= maxID. Only blocks whose ID range overlaps
+         * are decoded, so on an ID-sorted catalog this touches a few blocks.
+         */
+        bool readRange(int minID, int maxID, std::vector<Resource*>& out, ResourceStore* store = nullptr) const;
+    };
+
+    /**
+     * Loads a whole binary catalog, same contract as CSVParser::loadResources.
+     * @return The resources, or an empty vector if the file is missing or corrupt.
+     */
+    std::vector<Resource*> loadResources(const std::string& path, ResourceStore* store = nullptr);
+
+    /**
+     * Delivers the catalog one block at a time, same contract as CSVParser::streamResources.
+     * @param delivered If given, set to the number of resources handed to 'sink'.
+     * @return false if the file could not be opened, or if it stops at a corrupt block or
+     * short of the header's resource count: the blocks before were delivered, the rest not.
+     */
+    bool streamResources(const std::string& path, const std::function<void(std::vector<Resource*>&)>& sink,
+                         ResourceStore* store = nullptr, size_t* delivered = nullptr);
+
+    // Default binary catalog location for a CSV: same folder, ".ccbin" extension
+    std::string defaultPathFor(const std::string& csvPath);
+
+}
+
+#endif
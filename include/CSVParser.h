@@ -3,24 +3,88 @@
 
 #include <vector>
 #include <string>
+#include <cstddef>
+#include <functional>
 #include "Resource.h"
+#include "ResourceStore.h"
 
 // =========================================================
 // CSV PARSER MODULE
 // Responsibility: Read raw text files and convert them into
 // usable C++ objects for the Engine.
+//
+// Expected columns: ID,Title,URL,Topic,Difficulty,Rating,Prereqs,Duration
+// Fields follow RFC 4180: a field in double quotes may contain
+// commas, line breaks and doubled quotes (""). Prereqs is a
+// semicolon-separated list of IDs.
+//
+// The loaders below take an optional ResourceStore. With a store, the
+// resources are allocated in its arena and belong to it; without
+// one, each Resource is a standalone heap object the caller deletes.
 // =========================================================
 
 namespace CSVParser {
 
     /**
      * Loads all resources from the specified CSV file.
+     * The file is memory-mapped and tokenized in place; only the
+     * final Resource strings are allocated. Rows that fail to parse
+     * are logged with their line number and skipped.
      * * @param filename Path to the CSV file (e.g., "data/resources.csv")
-     * @return A vector of pointers to dynamically allocated Resource objects.
-     * (The caller is responsible for eventual memory cleanup).
+     * @param store Arena to allocate from; nullptr for heap Resources
+     * @return A vector of pointers to the loaded Resource objects.
+     * (Without a store, the caller is responsible for eventual memory cleanup).
      */
-    std::vector<Resource*> loadResources(const std::string& filename);
+    std::vector<Resource*> loadResources(const std::string& filename, ResourceStore* store = nullptr);
+
+    /**
+     * Streams resources to 'sink' in batches of up to 'batchSize', so the caller can
+     * index one batch while the next is parsed. Parsing runs on a background thread
+     * and stays at most a few batches ahead (bounded memory); 'sink' runs on the
+     * calling thread, in file order, and takes ownership of each batch's resources
+     * (unless they live in 'store'; the parser thread is then the store's only writer).
+     * @return Number of resources delivered (0 if the file could not be opened).
+     */
+    size_t streamResources(const std::string& filename, size_t batchSize,
+                           const std::function<void(std::vector<Resource*>&)>& sink,
+                           ResourceStore* store = nullptr);
+
+    /**
+     * Parses CSV records from a buffer already in memory.
+     * @param sourceName Used in per-row error messages (e.g. the file name)
+     * @param firstLine Line number of data[0], for error messages
+     * @param skipHeader Drop the first record (the column header)
+     * @return Number of rows rejected.
+     */
+    size_t parseRecords(const char* data, size_t size, std::vector<Resource*>& out,
+                        const std::string& sourceName, size_t firstLine, bool skipHeader,
+                        ResourceStore* store = nullptr);
+
+    /**
+     * Multi-threaded loadResources for large catalogs.
+     * The mapped file is cut into chunks at record boundaries (quote-aware, so
+     * quoted line breaks never split a record), the chunks are parsed on a pool
+     * of worker threads, and the per-chunk results are merged in ID order.
+     * Resources with the same ID keep their file order.
+     * @param threadCount Worker threads; <= 0 means one per hardware thread.
+     * @param minChunkBytes Files are not split into chunks smaller than this.
+     */
+    std::vector<Resource*> loadResourcesParallel(const std::string& filename, int threadCount = 0,
+                                                 size_t minChunkBytes = 1 << 20, ResourceStore* store = nullptr);
+
+    /**
+     * Splits a CSV buffer into at most 'chunkCount' ranges that each start at
+     * the beginning of a record. Returns the range starts, beginning with 0.
+     */
+    std::vector<size_t> findChunkBoundaries(const char* data, size_t size, size_t chunkCount);
+
+    /**
+     * The original line-by-line loader (std::getline + stringstream).
+     * Kept as a reference for tests and benchmarks; it does not
+     * understand quoted fields.
+     */
+    std::vector<Resource*> loadResourcesStream(const std::string& filename);
 
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,111 @@
+#ifndef CSVSCAN_H
+#define CSVSCAN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// =========================================================
+// CSV STRUCTURAL SCANNER
+// Responsibility: Find the bytes the CSV tokenizer cares about
+// (',', '\n', '"', ';') without looking at the input one byte
+// at a time.
+//
+// The input is processed in 64-byte blocks. For each block a
+// kernel produces one bitmap per character class (bit i set =
+// byte i of the block matches). The tokenizer walks those bitmaps
+// with count-trailing-zeros through a Cursor.
+//
+// Kernels: AVX2 (2 x 32 bytes), SSE2 (4 x 16 bytes) and a portable
+// scalar loop. The best kernel the CPU supports is picked once at
+// startup; CODECOMPASS_CSV_KERNEL=scalar|sse2|avx2 overrides it.
+// =========================================================
+
+namespace CSVScan {
+
+    const size_t kBlockSize = 64;
+
+    // Bitmap slots filled by a kernel
+    enum MaskKind {
+        MASK_FIELD_END = 0, // ',' or '\n'
+        MASK_QUOTE,         // '"'
+        MASK_SEMICOLON,     // ';' (prereq list separator)
+        MASK_COUNT
+    };
+
+    enum Kernel { KERNEL_SCALAR = 0, KERNEL_SSE2, KERNEL_AVX2 };
+
+    // Fills masks[MASK_COUNT] for exactly kBlockSize bytes at 'block'
+    typedef void (*BlockKernel)(const char* block, uint64_t* masks);
+
+    /**
+     * Kernels this CPU can run, slowest first (scalar is always present).
+     */
+    std::vector<Kernel> availableKernels();
+
+    /**
+     * Selects the kernel used by new Cursors.
+     * @return false if the CPU does not support it (the selection is unchanged).
+     */
+    bool setKernel(Kernel kernel);
+    Kernel activeKernel();
+    const char* kernelName(Kernel kernel);
+
+    // Kernel function for the active selection
+    BlockKernel blockKernel();
+
+    /**
+     * View of a buffer's structural bitmaps. Masks are computed one block at a
+     * time, on demand, and the last block is cached: scanning front to back reads
+     * the buffer once, stepping back to an earlier block just recomputes it.
+     */
+    class Cursor {
+    private:
+        const char* data;
+        size_t size;
+        BlockKernel kernel;
+        size_t blockStart;              // Offset of the cached block, or npos
+        uint64_t masks[MASK_COUNT];
+
+        void load(size_t block) {
+            if (block + kBlockSize <= size) {
+                kernel(data + block, masks);
+            } else {
+                // Last, partial block: zero padding never matches
+                char padded[kBlockSize] = {0};
+                std::memcpy(padded, data + block, size - block);
+                kernel(padded, masks);
+            }
+            blockStart = block;
+        }
+
+    public:
+        Cursor(const char* d, size_t n) : data(d), size(n), kernel(blockKernel()), blockStart(std::string::npos) {}
+
+        /**
+         * Offset of the first byte at or after 'pos' (and before 'end') in the given class.
+         * @return 'end' if there is none.
+         */
+        size_t next(size_t pos, MaskKind kind, size_t end) {
+            if (end > size) end = size;
+            while (pos < end) {
+                size_t block = pos & ~(kBlockSize - 1);
+                if (block != blockStart) load(block);
+                uint64_t bits = masks[kind] >> (pos - block);
+                if (bits) {
+                    size_t found = pos + static_cast<size_t>(__builtin_ctzll(bits));
+                    return found < end ? found : end;
+                }
+                pos = block + kBlockSize;
+            }
+            return end;
+        }
+
+        size_t next(size_t pos, MaskKind kind) { return next(pos, kind, size); }
+    };
+
+}
+
+#endif
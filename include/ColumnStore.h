@@ -0,0 +1,78 @@
+#ifndef COLUMNSTORE_H
+#define COLUMNSTORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "Resource.h"
+
+// =========================================================
+// COLUMN STORE
+// Responsibility: Keep the numeric attributes of every resource
+// in contiguous arrays (struct of arrays), so a filter reads 4
+// bytes per resource instead of chasing a Resource* per row.
+// Row i is the i-th resource appended (Engine: masterList[i]).
+//
+// Filters produce selection vectors: ascending row numbers.
+// Kernels run 8 rows (4 ratings) per step with AVX2 when the CPU
+// has it and fall back to a scalar loop;
+// CODECOMPASS_COLUMN_KERNEL=scalar|avx2 overrides the choice (the
+// same idea as CSVScan).
+// =========================================================
+
+typedef std::vector<uint32_t> Selection;
+
+class ColumnStore {
+public:
+    enum IntColumn { ID = 0, DIFFICULTY, DURATION };
+
+private:
+    std::vector<int32_t> ids;
+    std::vector<int32_t> difficulties;
+    std::vector<int32_t> durations;
+    std::vector<uint32_t> topicIds;
+    std::vector<double> ratings;
+    std::vector<Resource*> rows;
+    std::unordered_map<int32_t, uint32_t> rowOfID;
+
+    const std::vector<int32_t>& column(IntColumn c) const {
+        return c == ID ? ids : (c == DIFFICULTY ? difficulties : durations);
+    }
+
+public:
+    void append(const std::vector<Resource*>& batch);
+    void assign(const std::vector<Resource*>& list);
+    // Same as assign(list) when only 'changedRows' differ from the current rows (or are new)
+    void update(const std::vector<Resource*>& list, const std::vector<uint32_t>& changedRows);
+    void clear();
+
+    size_t size() const { return rows.size(); }
+    Resource* row(uint32_t i) const { return rows[i]; }
+
+    // Raw columns, size() entries each
+    const int32_t* idColumn() const { return ids.data(); }
+    const int32_t* difficultyColumn() const { return difficulties.data(); }
+    const int32_t* durationColumn() const { return durations.data(); }
+    const uint32_t* topicColumn() const { return topicIds.data(); }
+    const double* ratingColumn() const { return ratings.data(); }
+
+    // Filter kernels: replace 'out' with every row whose value matches
+    void selectAll(Selection& out) const;
+    void selectRange(IntColumn c, int lo, int hi, Selection& out) const; // lo <= value <= hi
+    // Rows of the resources in 'wanted', in that order; unknown IDs are skipped
+    void selectIDs(const std::vector<int>& wanted, Selection& out) const;
+
+    /**
+     * Score kernel: the 'k' highest-rated rows of 'sel', best first; equal
+     * ratings keep their order in 'sel'. Only rows that beat the k-th best
+     * so far reach the heap.
+     * @return How many rows entered the heap.
+     */
+    size_t topByRating(const Selection& sel, size_t k, Selection& top) const;
+
+    // Name of the kernel in use ("avx2" or "scalar")
+    static const char* kernelName();
+};
+
+#endif
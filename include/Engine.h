@@ -4,48 +4,259 @@
 #include <vector>
 #include <string>
 #include <iostream>
+#include <ostream>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <shared_mutex>
+#include <functional>
 #include "Resource.h"
+#include "ResourceStore.h"
+#include "ColumnStore.h"
 #include "Trie.h"
+#include "NGramIndex.h"
+#include "TextIndex.h"
 #include "AVLTree.h"
 #include "MaxHeap.h"
 #include "KnowledgeGraph.h"
 #include "LRUCache.h"
 #include "Stack.h"
+#include "Snapshot.h"
+
+// Lookups resolved once for a whole batch of commands (see Engine::prepareBatch).
+// Handlers consult these before touching the Trie / AVL tree / graph.
+struct PreparedLookups {
+    std::unordered_map<std::string, std::vector<int>> prefixResults; // Lower-cased prefix -> IDs
+    std::unordered_map<std::string, std::pair<int, int>> titleIDs;   // PLAN argument -> (ID or -1, TitleMatch)
+    std::unordered_map<int, std::vector<int>> curricula;             // Target ID -> study path
+    std::unordered_map<int, Resource*> resources;                    // ID -> resource
+};
+
+// How a PLAN target title was resolved
+enum TitleMatch { TITLE_NONE = 0, TITLE_EXACT, TITLE_NORMALIZED, TITLE_PREFIX };
+
+// How much diagnostic output a command appends after its results:
+//   NONE  - results only
+//   STATS - the ---ANALYSIS--- block with counters and timings (default)
+//   FULL  - STATS plus serialized structure dumps for visualization
+// Set per request with an "@LEVEL " prefix (e.g. "@FULL SEARCH|Graph"),
+// or per session with "ANALYSIS|LEVEL".
+enum AnalysisLevel { ANALYSIS_NONE = 0, ANALYSIS_STATS, ANALYSIS_FULL };
+
+// Per-client mutable state. Everything inside Engine is read-only while
+// serving, so many sessions can run commands against one Engine at once.
+struct Session {
+    LRUCache cache;
+    Stack history;
+    const PreparedLookups* prepared; // Optional, set while running a batch
+    AnalysisLevel analysis;          // Default for requests without an "@LEVEL" prefix
+    unsigned long catalogVersion;    // Engine catalog the cache was filled from
+
+    Session() : cache(5), prepared(nullptr), analysis(ANALYSIS_STATS), catalogVersion(0) {}
+};
 
 class Engine {
 private:
+    ResourceStore store; // Resources the engine loaded itself (snapshot, RELOAD, streamed CSV)
     std::vector<Resource*> masterList;
+    ColumnStore columns; // Numeric attributes of masterList, row i = masterList[i]
     Trie* searchIndex;
+    // Substring search (CONTAINS) and ranked word search (RANK), row i = masterList[i].
+    // Built on first use (see ensureInfixIndex) rather than at load, so startup does not wait.
+    mutable NGramIndex infixIndex;
+    mutable TextIndex textIndex;
     AVLTree* storageTree;
     MaxHeap* ratingQueue;
     KnowledgeGraph* depGraph;
-    LRUCache* cache;
-    Stack* historyStack;
+    Session* defaultSession; // Used by the single-client execute() overload
+
+    // Title index: normalized title (lower case, single spaces) -> resources.
+    // A multimap because distinct titles can normalize to the same key.
+    std::unordered_multimap<std::string, Resource*> titleIndex;
+
+    // Precomputed LIST orderings (only filled when loaded from a snapshot)
+    std::vector<Resource*> orderByDifficulty;
+    std::vector<Resource*> orderByTopic;
+
+    // RELOAD state. Readers hold catalogMutex shared for a whole command; reload()
+    // takes it exclusively only while applying a precomputed diff.
+    std::string sourcePath;
+    mutable std::shared_mutex catalogMutex;
+    std::mutex reloadMutex;              // One reload at a time
+    unsigned long catalogVersion;        // Bumped by every applied reload
+
+    // Indexes built on first use. Builders hold catalogMutex shared, so the catalog
+    // cannot change under them; indexBuildMutex keeps two of them from building at once.
+    mutable std::mutex indexBuildMutex;
+    mutable std::atomic<bool> infixReady;
+    mutable std::atomic<bool> textReady;
+
+    void allocateStructures();
+    void buildTitleIndex();
+    void indexResource(Resource* r);
+    void unindexResource(Resource* r);
+    static void freezeSearchIndex(Trie* index, const std::vector<Resource*>& list);
+    void eraseTitle(Resource* r);
+    // Build infixIndex / textIndex if they are not yet; the caller holds catalogMutex (shared is enough)
+    void ensureInfixIndex() const;
+    void ensureTextIndex() const;
+
+    // Serialized structure dump, regenerated only when the structure's revision changes
+    struct CachedDump {
+        bool valid = false;
+        unsigned long revision = 0;
+        std::shared_ptr<const std::string> text;
+    };
+
+    // AVL counters, each an O(n) walk, cached the same way
+    struct TreeStats {
+        bool valid = false;
+        unsigned long revision = 0;
+        int height = 0, nodeCount = 0, maxBalance = 0, rootBalance = 0;
+    };
+
+    mutable std::mutex dumpMutex; // Guards the caches below (handlers run concurrently)
+    mutable CachedDump treeDump, trieDump, graphDump, heapDump;
+    mutable TreeStats treeStats;
+
+    std::shared_ptr<const std::string> cachedDump(CachedDump& slot, unsigned long revision,
+                                                  const std::function<std::string()>& render) const;
+    std::shared_ptr<const std::string> treeStructure() const;
+    std::shared_ptr<const std::string> trieStructure() const;
+    std::shared_ptr<const std::string> graphStructure() const;
+    std::shared_ptr<const std::string> heapStructure() const;
+    TreeStats currentTreeStats() const;
 
 public:
+    // Indexes 'data', which stays owned by the caller and must outlive the engine
     Engine(const std::vector<Resource*>& data);
+
+    /**
+     * @brief Empty engine, filled batch by batch with ingest() and finishIngest()
+     */
+    Engine();
+
+    /**
+     * @brief Indexes a batch of resources (Trie, AVL tree, heap, title index) as it
+     * arrives, e.g. from CSVParser::streamResources. Graph edges are linked once, in
+     * finishIngest(), when every ID is known. Resources allocated in resources() are
+     * freed with the engine; any others must outlive it.
+     */
+    void ingest(const std::vector<Resource*>& batch);
+    void finishIngest();
+    size_t resourceCount() const;
+
+    /**
+     * @brief The engine's arena. Load into it (CSVParser's 'store' argument) to hand
+     * the resources' memory to the engine; it is released in one go by ~Engine.
+     */
+    ResourceStore& resources() { return store; }
+
     ~Engine();
 
-    void execute(const std::string& command);
-    std::vector<Resource*> resourceList();
+    /**
+     * @brief Fills an empty engine from an open snapshot instead of the CSV.
+     * Resources are materialized from the mapped records; every index is bulk-loaded
+     * (no per-resource inserts). The resources live in the engine's own store but their
+     * titles, URLs and prereqs point into the mapping, so 'image' must outlive the engine.
+     * Every record and index reference is bounds-checked on the way in.
+     * @return false, with a reason, if any of them is out of range; the engine is then
+     * partly filled and must be discarded (fall back to the CSV).
+     */
+    bool loadSnapshot(const Snapshot::Image& image, std::string& reason);
+
+    /**
+     * @brief Serializes the built engine (resources, trie, adjacency, orderings)
+     * @param source Stamp of the CSV this engine was built from
+     */
+    bool saveSnapshot(const std::string& path, const Snapshot::SourceStamp& source);
+
+    /**
+     * @brief Builds the indexes that are otherwise built on first use (CONTAINS and RANK),
+     * e.g. on a background thread once a server is ready, so no request waits for them
+     */
+    void buildDeferredIndexes() const;
+
+    /**
+     * @brief Dispatches one "ACTION|args" command and prints its result to stdout
+     * @return false if the action is unknown
+     */
+    bool execute(const std::string& command);
+
+    /**
+     * @brief Thread-safe variant: per-client state lives in 'session', output goes to 'out'.
+     * Concurrent calls are fine as long as each thread uses its own Session.
+     */
+    bool execute(const std::string& command, Session& session, std::ostream& out) const;
+
+    /**
+     * @brief Same as above, plus commands that modify the catalog (RELOAD).
+     */
+    bool execute(const std::string& command, Session& session, std::ostream& out);
+
+    /**
+     * @brief CSV that RELOAD re-reads (normally the file the engine was built from)
+     */
+    void setSourcePath(const std::string& path);
+
+    /**
+     * @brief Re-reads the source CSV and applies only the differences, keyed by Resource::id.
+     * Parsing and diffing run while readers continue; the diff is then applied to the
+     * Trie, AVL tree, graph, heap and title index under an exclusive lock, so a command
+     * sees either the old catalog or the new one. On a parse failure nothing changes.
+     * @return false if the CSV could not be loaded
+     */
+    bool reload(AnalysisLevel analysis, std::ostream& out);
+
+    /**
+     * @brief Resolves the shared work of many commands up front, grouped by kind:
+     * all distinct trie prefixes (SEARCH, CRAM), then PLAN targets and curricula,
+     * then every resulting ID against the AVL tree in ascending order.
+     */
+    void prepareBatch(const std::vector<std::string>& commands, PreparedLookups& lookups) const;
 
 private:
     // Handlers
-    void handleList(const std::string& sortMode = "");
-    void handlePlan(const std::string& targetTitle);
-    void handleTitles();
-    void handleSearch(const std::string& query);
-    void handleTopRated(int k, const std::string& difficultyLevel);
-    void handleBack();
-    void handleCram(const std::string& args);
+    void handleList(const std::string& sortMode, AnalysisLevel analysis, std::ostream& out) const;
+    void handlePlan(const std::string& targetTitle, const Session& session, AnalysisLevel analysis, std::ostream& out) const;
+    void handleTitles(std::ostream& out) const;
+    void handleSearch(const std::string& query, size_t limit, int64_t after, Session& session,
+                      AnalysisLevel analysis, std::ostream& out) const;
+    void handleTopRated(int k, const std::string& difficultyLevel, AnalysisLevel analysis, std::ostream& out) const;
+    void handleComplete(const std::string& prefix, int k, AnalysisLevel analysis, std::ostream& out) const;
+    void handleContains(const std::string& text, size_t limit, Session& session, AnalysisLevel analysis, std::ostream& out) const;
+    void handleFuzzy(const std::string& query, int maxEdits, size_t limit, Session& session, AnalysisLevel analysis, std::ostream& out) const;
+    void handleBack(Session& session, std::ostream& out) const;
+    void handleRank(const std::string& query, int k, double ratingWeight, Session& session,
+                    AnalysisLevel analysis, std::ostream& out) const;
+    bool handleCram(const std::string& args, Session& session, AnalysisLevel analysis, std::ostream& out) const;
+    bool handleDescribe(const std::string& target, Session& session, std::ostream& out) const;
+
+    void printResourceLine(const Resource* r, std::ostream& out) const;
 
-    void printResourceLine(Resource* r);
+    // Lookups that prefer a session's prepared batch results
+    std::vector<int> findByPrefix(const std::string& prefix, const Session& session) const;
+    // Up to 'limit' IDs greater than 'after'; 'more' tells whether the prefix has further IDs
+    std::vector<int> findPageByPrefix(const std::string& prefix, const Session& session, int64_t after, size_t limit, bool& more) const;
+    // Parses a SEARCH cursor issued for 'query' into the ID to resume after
+    static bool decodeCursor(const std::string& token, const std::string& query, int64_t& after);
+    Resource* findByID(int id, const Session& session, int& treeSearches) const;
+    int findTitle(const std::string& planArgument, const Session& session, TitleMatch& match) const;
+
+    /**
+     * @brief Resolves a title in O(1) average: exact title first, then the normalized key.
+     * @param allowPrefix Fall back to the Trie and take the shortest title starting with 'title'
+     * @return Resource ID, or -1 (match is TITLE_NONE)
+     */
+    int lookupTitle(const std::string& title, bool allowPrefix, TitleMatch& match) const;
+    std::vector<int> findCurriculum(int targetID, const Session& session) const;
 
     /**
      * @brief Adds a resource to the navigation history stack if it's not a duplicate
      * @param resource The resource to add to history
      */
-    void addToHistory(Resource* resource);
+    void addToHistory(Session& session, Resource* resource) const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,460 @@
+#ifndef FROZENTRIE_H
+#define FROZENTRIE_H
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cctype>
+#include <cstdint>
+#include <algorithm>
+
+// =========================================================
+// FROZEN TRIE
+// Read-only, pointer-free form of the radix Trie, built by
+// Trie::freeze() once loading is done. Five flat arrays:
+//   nodes       one record per node in preorder, plus a sentinel
+//   childKeys   first label byte of each child, ascending per node
+//   childNodes  preorder index of each child (parallel to childKeys)
+//   ids         resource IDs in preorder
+//   labels      edge label bytes
+// Because the layout is preorder, a node's subtree is the node
+// range [i, subtreeEnd) and its IDs are one contiguous slice of
+// 'ids', so collecting a prefix's matches is a copy, not a walk.
+//
+// A key's ID shows up once per indexed field (title and topic), so
+// a slice can repeat IDs. Nodes with large subtrees (short prefixes,
+// popular topics) also get a materialized posting list: the slice
+// sorted and deduplicated ahead of time, in 'postings'. Small slices
+// are sorted per query instead. Postings are capped at
+// kPostingBudget times the size of 'ids', largest subtrees first.
+//
+// For autocompletion, rankCompletions() scores every key (terminal
+// node) by the best rating among its IDs and gives each node with
+// more than kTopCompletions keys below it its best kTopCompletions
+// keys, precomputed. A completion query is then one descent plus a
+// read of that list, however many keys share the prefix, so it asks
+// for at most kTopCompletions keys. The ranking is saved in snapshots with the other arrays (their ratings
+// are the snapshot's own) and rebuilt when ratings change.
+//
+// fuzzyPrefix() walks the trie alongside a Levenshtein automaton
+// for the query: one row of edit distances per path byte, shared by
+// every key below. A subtree is pruned as soon as no cell of its
+// row is within the allowed edits, so a query touches only the few
+// branches that stay close to it, not every key.
+//
+// Snapshots store the arrays byte for byte; loading one copies them
+// back into these vectors.
+// =========================================================
+
+struct FrozenTrieNode {
+    uint32_t labelOffset;  // Edge label into this node, in 'labels'
+    uint32_t labelLength;  // 0 for the root
+    uint32_t firstChild;   // Index into childKeys / childNodes
+    uint32_t childCount;
+    uint32_t idBegin;      // Own IDs are ids[idBegin, next node's idBegin)
+    uint32_t subtreeEnd;   // Preorder index one past the last descendant
+};
+
+inline unsigned char trieLower(char c) {
+    return static_cast<unsigned char>(std::tolower(static_cast<unsigned char>(c)));
+}
+
+struct FrozenTrie {
+    static constexpr uint32_t kNone = 0xFFFFFFFFu;
+    static constexpr size_t kPostingMinIDs = 64;  // Smaller subtrees are sorted per query
+    static constexpr size_t kPostingBudget = 8;   // Postings hold at most this many times ids.size() entries
+    static constexpr size_t kTopCompletions = 16; // Longest completion list a node keeps
+    static constexpr uint32_t kMaxFuzzyEdits = 2;
+
+    std::vector<FrozenTrieNode> nodes;
+    std::vector<unsigned char> childKeys;
+    std::vector<uint32_t> childNodes;
+    std::vector<int32_t> ids;
+    std::vector<char> labels;
+    std::vector<uint32_t> postingOffsets;  // Per node plus sentinel; an empty range means not materialized
+    std::vector<int32_t> postings;         // Sorted, deduplicated subtree IDs of materialized nodes
+
+    // Completion ranking, per node (empty until rankCompletions)
+    std::vector<float> keyScore;           // Best rating among the node's own IDs
+    std::vector<int32_t> keyBest;          // The ID with that rating (-1 if the node ends no key)
+    std::vector<uint32_t> completionSlot;  // Start of the node's top list in 'completions', or kNone
+    std::vector<uint32_t> completions;     // kTopCompletions terminal nodes per slot, best first
+
+    size_t nodeCount() const { return nodes.empty() ? 0 : nodes.size() - 1; }
+
+    bool endsWord(uint32_t node) const { return nodes[node + 1].idBegin > nodes[node].idBegin; }
+    std::string_view label(uint32_t node) const {
+        return std::string_view(labels.data() + nodes[node].labelOffset, nodes[node].labelLength);
+    }
+
+    uint32_t findChild(uint32_t node, unsigned char c) const {
+        const FrozenTrieNode& n = nodes[node];
+        const unsigned char* keys = childKeys.data() + n.firstChild;
+        if (n.childCount <= 16) {
+            for (uint32_t i = 0; i < n.childCount; i++) {
+                if (keys[i] == c) return childNodes[n.firstChild + i];
+                if (keys[i] > c) break;
+            }
+            return kNone;
+        }
+        const unsigned char* at = std::lower_bound(keys, keys + n.childCount, c);
+        if (at == keys + n.childCount || *at != c) return kNone;
+        return childNodes[n.firstChild + (at - keys)];
+    }
+
+    // Node whose subtree holds exactly the keys starting with 'prefix' (case-insensitive), or kNone
+    uint32_t locate(std::string_view prefix) const {
+        if (nodes.empty()) return kNone;
+        uint32_t curr = 0;
+        size_t pos = 0;
+        while (pos < prefix.size()) {
+            uint32_t child = findChild(curr, trieLower(prefix[pos]));
+            if (child == kNone) return kNone;
+            const FrozenTrieNode& n = nodes[child];
+            size_t span = std::min<size_t>(n.labelLength, prefix.size() - pos);
+            const char* text = labels.data() + n.labelOffset;
+            for (size_t i = 1; i < span; i++) {
+                if (static_cast<unsigned char>(text[i]) != trieLower(prefix[pos + i])) return kNone;
+            }
+            curr = child;
+            pos += span;
+        }
+        return curr;
+    }
+
+    // Every ID in the subtree of 'node', sorted and deduplicated
+    void collect(uint32_t node, std::vector<int>& out) const {
+        if (postingOffsets[node] < postingOffsets[node + 1]) {
+            out.assign(postings.begin() + postingOffsets[node], postings.begin() + postingOffsets[node + 1]);
+            return;
+        }
+        // Small subtree: sorting the slice here is cheaper than storing it sorted
+        out.assign(ids.begin() + nodes[node].idBegin, ids.begin() + nodes[nodes[node].subtreeEnd].idBegin);
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+    }
+
+    /**
+     * One page of collect(): up to 'limit' IDs greater than 'after', ascending.
+     * From a posting list this is a binary search plus a copy of the page.
+     * @return true if more IDs follow the page.
+     */
+    bool collectPage(uint32_t node, int64_t after, size_t limit, std::vector<int>& out) const {
+        out.clear();
+        if (postingOffsets[node] < postingOffsets[node + 1]) {
+            auto begin = postings.begin() + postingOffsets[node], end = postings.begin() + postingOffsets[node + 1];
+            auto from = std::upper_bound(begin, end, after, [](int64_t a, int32_t id) { return a < id; });
+            size_t take = std::min<size_t>(limit, end - from);
+            out.assign(from, from + take);
+            return from + take != end;
+        }
+        std::vector<int> all;
+        collect(node, all);
+        auto from = std::upper_bound(all.begin(), all.end(), after, [](int64_t a, int id) { return a < id; });
+        size_t take = std::min<size_t>(limit, all.end() - from);
+        out.assign(from, from + take);
+        return from + take != all.end();
+    }
+
+    // Fills postingOffsets/postings from the tree arrays (after Trie::freeze builds them)
+    void materializePostings() {
+        size_t n = nodeCount();
+        auto sliceSize = [this](size_t i) { return nodes[nodes[i].subtreeEnd].idBegin - nodes[i].idBegin; };
+
+        // Pick the nodes to materialize: all big ones, or the biggest that fit the budget
+        std::vector<uint32_t> candidates;
+        size_t total = 0;
+        for (size_t i = 0; i < n; i++) {
+            if (sliceSize(i) < kPostingMinIDs) continue;
+            candidates.push_back(static_cast<uint32_t>(i));
+            total += sliceSize(i);
+        }
+        std::vector<bool> chosen(n, false);
+        if (total > kPostingBudget * ids.size()) {
+            std::sort(candidates.begin(), candidates.end(),
+                      [&sliceSize](uint32_t a, uint32_t b) { return sliceSize(a) > sliceSize(b); });
+            total = 0;
+            for (uint32_t i : candidates) {
+                if (total + sliceSize(i) > kPostingBudget * ids.size()) break;
+                total += sliceSize(i);
+                chosen[i] = true;
+            }
+        } else {
+            for (uint32_t i : candidates) chosen[i] = true;
+        }
+
+        postingOffsets.assign(n + 1, 0);
+        postings.clear();
+        postings.reserve(total);
+        for (size_t i = 0; i < n; i++) {
+            postingOffsets[i] = static_cast<uint32_t>(postings.size());
+            if (!chosen[i]) continue;
+            size_t start = postings.size();
+            postings.insert(postings.end(), ids.begin() + nodes[i].idBegin, ids.begin() + nodes[nodes[i].subtreeEnd].idBegin);
+            std::sort(postings.begin() + start, postings.end());
+            postings.erase(std::unique(postings.begin() + start, postings.end()), postings.end());
+        }
+        postingOffsets[n] = static_cast<uint32_t>(postings.size());
+        postings.shrink_to_fit();
+    }
+
+    uint32_t keyCount(uint32_t node) const { return nodes[node + 1].idBegin - nodes[node].idBegin; }
+
+    // Completion order: higher score, then more resources, then key order (preorder is byte order)
+    bool ranksBefore(uint32_t a, uint32_t b) const {
+        if (keyScore[a] != keyScore[b]) return keyScore[a] > keyScore[b];
+        if (keyCount(a) != keyCount(b)) return keyCount(a) > keyCount(b);
+        return a < b;
+    }
+
+    /**
+     * Scores every key and precomputes the top lists.
+     * @param scoreOf Rating of a resource ID.
+     */
+    template <typename Score>
+    void rankCompletions(Score scoreOf) {
+        size_t n = nodeCount();
+        keyScore.assign(n, 0.0f);
+        keyBest.assign(n, -1);
+        for (size_t i = 0; i < n; i++) {
+            for (uint32_t j = nodes[i].idBegin; j < nodes[i + 1].idBegin; j++) {
+                float score = static_cast<float>(scoreOf(ids[j]));
+                if (keyBest[i] == -1 || score > keyScore[i] || (score == keyScore[i] && ids[j] < keyBest[i])) {
+                    keyScore[i] = score;
+                    keyBest[i] = ids[j];
+                }
+            }
+        }
+
+        // Children follow their parent in preorder, so walking backwards sees them first
+        std::vector<uint32_t> keysBelow(n, 0);
+        completionSlot.assign(n, kNone);
+        completions.clear();
+        std::vector<uint32_t> candidates;
+        auto better = [this](uint32_t a, uint32_t b) { return ranksBefore(a, b); };
+        for (size_t i = n; i-- > 0;) {
+            const FrozenTrieNode& node = nodes[i];
+            keysBelow[i] = endsWord(static_cast<uint32_t>(i)) ? 1 : 0;
+            for (uint32_t k = 0; k < node.childCount; k++) keysBelow[i] += keysBelow[childNodes[node.firstChild + k]];
+            if (keysBelow[i] <= kTopCompletions) continue;
+
+            // A node's best keys are among its own key and each child's best keys
+            candidates.clear();
+            if (endsWord(static_cast<uint32_t>(i))) candidates.push_back(static_cast<uint32_t>(i));
+            for (uint32_t k = 0; k < node.childCount; k++) {
+                uint32_t child = childNodes[node.firstChild + k];
+                if (completionSlot[child] != kNone) {
+                    candidates.insert(candidates.end(), completions.begin() + completionSlot[child],
+                                      completions.begin() + completionSlot[child] + kTopCompletions);
+                } else {
+                    for (uint32_t j = child; j < nodes[child].subtreeEnd; j++) {
+                        if (endsWord(j)) candidates.push_back(j);
+                    }
+                }
+            }
+            std::partial_sort(candidates.begin(), candidates.begin() + kTopCompletions, candidates.end(), better);
+            completionSlot[i] = static_cast<uint32_t>(completions.size());
+            completions.insert(completions.end(), candidates.begin(), candidates.begin() + kTopCompletions);
+        }
+        completions.shrink_to_fit();
+    }
+
+    bool isRanked() const { return !completionSlot.empty(); }
+
+    /**
+     * Nodes whose keys start with a string within 'maxEdits' edits of 'query'
+     * (case-insensitive; an edit is an insertion, deletion, substitution or a swap
+     * of two adjacent bytes). Each pair is (node, edits), and the node's whole subtree
+     * matches. A node below a reported one is only reported again with fewer edits.
+     * @param rowsComputed If set, receives the number of automaton steps taken.
+     */
+    void fuzzyPrefix(std::string_view query, uint32_t maxEdits, std::vector<std::pair<uint32_t, uint32_t>>& out,
+                     size_t* rowsComputed = nullptr) const {
+        out.clear();
+        if (rowsComputed) *rowsComputed = 0;
+        if (nodes.empty()) return;
+        FuzzyState state;
+        state.query.reserve(query.size());
+        for (char c : query) state.query.push_back(trieLower(c));
+        state.maxEdits = std::min(maxEdits, kMaxFuzzyEdits);
+        size_t width = query.size() + 1;
+        state.rows.resize(width);
+        for (size_t j = 0; j < width; j++) state.rows[j] = static_cast<uint32_t>(j);
+        uint32_t bound = state.maxEdits + 1;
+        if (state.rows[query.size()] <= state.maxEdits) {
+            bound = state.rows[query.size()]; // Short enough to match every key; some match with fewer edits
+            out.push_back(std::make_pair(0u, bound));
+        }
+        if (bound > 0) fuzzyRec(0, bound, state, out);
+        if (rowsComputed) *rowsComputed = state.steps;
+    }
+
+    /**
+     * Best 'k' key nodes under 'node', best first. Needs rankCompletions().
+     * 'k' is capped at kTopCompletions, the length of the precomputed lists.
+     */
+    void topCompletions(uint32_t node, size_t k, std::vector<uint32_t>& out) const {
+        out.clear();
+        k = std::min(k, kTopCompletions);
+        if (completionSlot[node] != kNone) {
+            out.assign(completions.begin() + completionSlot[node], completions.begin() + completionSlot[node] + k);
+            return;
+        }
+        // Without a list there are at most kTopCompletions keys below, so at most twice as many nodes
+        for (uint32_t j = node; j < nodes[node].subtreeEnd; j++) {
+            if (endsWord(j)) out.push_back(j);
+        }
+        auto better = [this](uint32_t a, uint32_t b) { return ranksBefore(a, b); };
+        if (out.size() > k) {
+            std::partial_sort(out.begin(), out.begin() + k, out.end(), better);
+            out.resize(k);
+        } else {
+            std::sort(out.begin(), out.end(), better);
+        }
+    }
+
+    // Full (lowercased) key spelled by the path from the root to 'node'
+    std::string keyOf(uint32_t node) const {
+        std::string key;
+        uint32_t curr = 0;
+        while (curr != node) {
+            // The child whose preorder range holds 'node': the last child starting at or before it
+            const FrozenTrieNode& n = nodes[curr];
+            const uint32_t* first = childNodes.data() + n.firstChild;
+            curr = *(std::upper_bound(first, first + n.childCount, node) - 1);
+            key.append(label(curr));
+        }
+        return key;
+    }
+
+    size_t memoryUsage() const {
+        return nodes.capacity() * sizeof(FrozenTrieNode) + childKeys.capacity() +
+               childNodes.capacity() * sizeof(uint32_t) + ids.capacity() * sizeof(int32_t) + labels.capacity() +
+               postingOffsets.capacity() * sizeof(uint32_t) + postings.capacity() * sizeof(int32_t) +
+               keyScore.capacity() * sizeof(float) + keyBest.capacity() * sizeof(int32_t) +
+               completionSlot.capacity() * sizeof(uint32_t) + completions.capacity() * sizeof(uint32_t);
+    }
+
+private:
+    struct FuzzyState {
+        std::vector<unsigned char> query;  // Lowercased
+        uint32_t maxEdits = 0;
+        std::vector<uint32_t> rows;        // Row d: distances between the first d path bytes and each query prefix
+        std::vector<unsigned char> path;   // Bytes from the root to the current position
+        size_t steps = 0;
+    };
+
+    // Appends the row for path byte 'c'; returns the smallest cell in it
+    static uint32_t fuzzyStep(FuzzyState& state, unsigned char c) {
+        size_t width = state.query.size() + 1;
+        size_t d = state.path.size(); // Rows 0..d exist
+        state.rows.resize((d + 2) * width);
+        const uint32_t* prev = state.rows.data() + d * width;
+        uint32_t* row = state.rows.data() + (d + 1) * width;
+        row[0] = prev[0] + 1;
+        uint32_t best = row[0];
+        for (size_t j = 1; j < width; j++) {
+            uint32_t cost = state.query[j - 1] == c ? 0 : 1;
+            uint32_t v = std::min({prev[j] + 1, row[j - 1] + 1, prev[j - 1] + cost});
+            // Adjacent swap: query "..ab" against path "..ba"
+            if (j > 1 && d > 0 && state.query[j - 1] == state.path[d - 1] && state.query[j - 2] == c) {
+                v = std::min(v, state.rows[(d - 1) * width + j - 2] + 1);
+            }
+            row[j] = v;
+            best = std::min(best, v);
+        }
+        state.path.push_back(c);
+        state.steps++;
+        return best;
+    }
+
+    // 'bound': edits of the match already reported above 'node' (maxEdits + 1 if none)
+    void fuzzyRec(uint32_t node, uint32_t bound, FuzzyState& state, std::vector<std::pair<uint32_t, uint32_t>>& out) const {
+        size_t width = state.query.size() + 1;
+        const FrozenTrieNode& n = nodes[node];
+        for (uint32_t k = 0; k < n.childCount; k++) {
+            uint32_t child = childNodes[n.firstChild + k];
+            std::string_view text = label(child);
+            size_t depth = state.path.size();
+            uint32_t found = bound; // Edits of the best match along this edge
+            uint32_t rowMin = 0;
+            for (char c : text) {
+                rowMin = fuzzyStep(state, static_cast<unsigned char>(c));
+                found = std::min(found, state.rows[state.path.size() * width + width - 1]);
+                // Cells never shrink going down, so nothing below can beat 'found'
+                if (rowMin >= found) break;
+            }
+            if (found < bound) out.push_back(std::make_pair(child, found));
+            if (rowMin < found && state.path.size() == depth + text.size()) fuzzyRec(child, found, state, out);
+            state.path.resize(depth);
+            state.rows.resize((depth + 1) * width);
+        }
+    }
+
+public:
+    /**
+     * Checks that the arrays describe one well-formed preorder tree (e.g. after
+     * reading them from a file), so lookups can index them without bounds checks.
+     * @param nodeCount Records in 'nodes', sentinel included.
+     */
+    static bool validate(const FrozenTrieNode* nodes, size_t nodeCount, const unsigned char* childKeys,
+                         const uint32_t* childNodes, size_t childCount, size_t idCount, size_t labelBytes) {
+        if (nodeCount < 2 || nodes[0].labelLength != 0) return false;
+        size_t n = nodeCount - 1;
+        if (nodes[n].idBegin != idCount || nodes[0].subtreeEnd != n) return false;
+        for (size_t i = 0; i < n; i++) {
+            const FrozenTrieNode& node = nodes[i];
+            if ((uint64_t)node.labelOffset + node.labelLength > labelBytes ||
+                (uint64_t)node.firstChild + node.childCount > childCount ||
+                node.idBegin > nodes[i + 1].idBegin || node.subtreeEnd <= i || node.subtreeEnd > n ||
+                (i > 0 && node.labelLength == 0)) {
+                return false;
+            }
+            // Children are consecutive subtrees that exactly fill this node's range
+            uint32_t expected = static_cast<uint32_t>(i + 1);
+            for (uint32_t k = 0; k < node.childCount; k++) {
+                uint32_t child = childNodes[node.firstChild + k];
+                if (child != expected || child >= node.subtreeEnd) return false;
+                if (k > 0 && childKeys[node.firstChild + k] <= childKeys[node.firstChild + k - 1]) return false;
+                expected = nodes[child].subtreeEnd;
+            }
+            if (expected != node.subtreeEnd) return false;
+        }
+        return true;
+    }
+
+    // Posting offsets: one per node record (sentinel included), ascending, ending at the postings count
+    static bool validatePostings(const uint32_t* offsets, size_t offsetCount, size_t nodeCount, size_t postingCount) {
+        if (offsetCount == 0 || offsetCount != nodeCount || offsets[offsetCount - 1] != postingCount) return false;
+        for (size_t i = 1; i < offsetCount; i++) {
+            if (offsets[i] < offsets[i - 1]) return false;
+        }
+        return true;
+    }
+
+    // Ranking: absent, or one score/best/slot per key node and whole top lists of key nodes
+    static bool validateRanking(size_t nodeCount, size_t scoreCount, size_t bestCount, const uint32_t* slots,
+                                size_t slotCount, const uint32_t* top, size_t topCount) {
+        if (scoreCount == 0 && bestCount == 0 && slotCount == 0 && topCount == 0) return true;
+        size_t n = nodeCount == 0 ? 0 : nodeCount - 1;
+        if (scoreCount != n || bestCount != n || slotCount != n || topCount % kTopCompletions != 0) return false;
+        for (size_t i = 0; i < slotCount; i++) {
+            if (slots[i] != kNone && (slots[i] % kTopCompletions != 0 || slots[i] >= topCount)) return false;
+        }
+        for (size_t i = 0; i < topCount; i++) {
+            if (top[i] >= n) return false;
+        }
+        return true;
+    }
+
+    bool isValid() const {
+        return childKeys.size() == childNodes.size() &&
+               validate(nodes.data(), nodes.size(), childKeys.data(), childNodes.data(), childNodes.size(),
+                        ids.size(), labels.size()) &&
+               validatePostings(postingOffsets.data(), postingOffsets.size(), nodes.size(), postings.size()) &&
+               validateRanking(nodes.size(), keyScore.size(), keyBest.size(), completionSlot.data(),
+                               completionSlot.size(), completions.data(), completions.size());
+    }
+};
+
+#endif
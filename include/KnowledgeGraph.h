@@ -11,7 +11,8 @@
 #include <vector>
 #include <iomanip> // For nice formatting
 #include <utility>
-#include <set>
+#include <cstdint>
+#include "Log.h"
 
 class KnowledgeGraph {
 private:
@@ -21,38 +22,138 @@ private:
     // Key: Resource ID, Value: Pointer to the actual Resource object
     std::unordered_map<int, Resource*> resourceMap;
 
+    // Key: Missing Prereq ID, Value: Resources waiting for it to appear (RELOAD)
+    std::unordered_map<int, std::vector<int>> waiting;
+
+    unsigned long revision = 0; // Bumped on every mutation
+
+    static void eraseOne(std::unordered_map<int, std::vector<int>>& lists, int key, int value) {
+        auto it = lists.find(key);
+        if (it == lists.end()) return;
+        auto pos = std::find(it->second.begin(), it->second.end(), value);
+        if (pos != it->second.end()) it->second.erase(pos);
+        if (it->second.empty()) lists.erase(it);
+    }
+
+    // Edges into res, or waiting entries for prereqs that don't exist yet
+    void linkPrereqs(const Resource* res) {
+        for (int pre : res->prereqIDs) {
+            if (resourceMap.count(pre)) adjList[pre].push_back(res->id);
+            else waiting[pre].push_back(res->id);
+        }
+    }
+
+    void unlinkPrereqs(int id, IdList prereqs) {
+        for (int pre : prereqs) {
+            if (resourceMap.count(pre)) eraseOne(adjList, pre, id);
+            else eraseOne(waiting, pre, id);
+        }
+    }
+
 public:
     void addResource(Resource* res) {
         resourceMap[res->id] = res;
+        revision++;
+    }
+
+    void reserve(size_t resourceCount) {
+        resourceMap.reserve(resourceCount);
+    }
+
+    // Install a prebuilt edge list (e.g. from a snapshot) instead of re-linking in buildGraph
+    void loadEdges(int prereqID, const int32_t* dependents, size_t count) {
+        if (count == 0) return;
+        adjList[prereqID].assign(dependents, dependents + count);
+        revision++;
+    }
+
+    // Rebuild the missing-prereq index after loadEdges (snapshots only store real edges)
+    void indexMissingPrereqs(const std::vector<Resource*>& allResources) {
+        waiting.clear();
+        for (Resource* r : allResources) {
+            for (int pre : r->prereqIDs) {
+                if (!resourceMap.count(pre)) waiting[pre].push_back(r->id);
+            }
+        }
     }
 
     // =========================================================
-    // VISUALIZE GRAPH BUILDING (STEP-BY-STEP)
+    // INCREMENTAL UPDATES (RELOAD)
+    // Touch only the edges of the resource being changed. Dependents
+    // of a removed resource are parked in 'waiting' and re-linked if
+    // the ID comes back.
+    // =========================================================
+    void insertResource(Resource* res) {
+        resourceMap[res->id] = res;
+        linkPrereqs(res);
+
+        auto parked = waiting.find(res->id);
+        if (parked != waiting.end()) {
+            std::vector<int>& deps = adjList[res->id];
+            deps.insert(deps.end(), parked->second.begin(), parked->second.end());
+            waiting.erase(parked);
+        }
+        revision++;
+    }
+
+    void removeResource(const Resource* res) {
+        unlinkPrereqs(res->id, res->prereqIDs);
+
+        auto deps = adjList.find(res->id);
+        if (deps != adjList.end()) {
+            std::vector<int>& parked = waiting[res->id];
+            parked.insert(parked.end(), deps->second.begin(), deps->second.end());
+            adjList.erase(deps);
+        }
+        resourceMap.erase(res->id);
+        revision++;
+    }
+
+    // Same object, new contents (RELOAD overwrites a changed resource in place);
+    // 'oldPrereqs' is the list it had before. Only the prerequisite edges are re-linked.
+    void updateResource(const Resource* res, IdList oldPrereqs) {
+        if (oldPrereqs != res->prereqIDs) {
+            unlinkPrereqs(res->id, oldPrereqs);
+            linkPrereqs(res);
+        }
+        revision++;
+    }
+
+    unsigned long getRevision() const { return revision; }
+
+    const std::vector<int>* getDependents(int prereqID) const {
+        auto it = adjList.find(prereqID);
+        return it == adjList.end() ? nullptr : &it->second;
+    }
+
+    // =========================================================
+    // LINK GRAPH DEPENDENCIES (each step is trace-logged)
     // =========================================================
     void buildGraph(const std::vector<Resource*>& allResources) {
-        std::cout << "\n=== [DEBUG] LINKING GRAPH DEPENDENCIES ===" << std::endl;
+        CC_LOG_DEBUG("Linking graph dependencies for " << allResources.size() << " resources");
 
         int edgesCount = 0;
 
         for (Resource* r : allResources) {
             for (int pre : r->prereqIDs) {
                 // Check if the Prereq ID actually exists in our data
-                if (resourceMap.count(pre)) {
+                auto prereq = resourceMap.find(pre);
+                if (prereq != resourceMap.end()) {
                     // Create the Edge
                     adjList[pre].push_back(r->id);
                     edgesCount++;
+                    revision++;
 
-                    // --- VISUALIZATION OF THE STEP ---
-                    std::string pTitle = resourceMap[pre]->title;
-
-                    std::cout << "[Step " << edgesCount << "] "
-                              << std::left << std::setw(20) << pTitle
-                              << " (" << pre << ")  ---> UNLOCKS --->  "
-                              << r->title << " (" << r->id << ")" << std::endl;
+                    CC_LOG_TRACE("[Step " << edgesCount << "] "
+                                 << std::left << std::setw(20) << prereq->second->title
+                                 << " (" << pre << ")  ---> UNLOCKS --->  "
+                                 << r->title << " (" << r->id << ")");
+                } else {
+                    waiting[pre].push_back(r->id);
                 }
             }
         }
-        std::cout << "==========================================\n" << std::endl;
+        CC_LOG_DEBUG("Linked " << edgesCount << " prerequisite edges");
     }
 
     // =========================================================
@@ -66,11 +167,11 @@ public:
             for (auto const& pair : adjList) {
                 int prereqID = pair.first;
                 const std::vector<int>& dependents = pair.second;
-                std::string pTitle = resourceMap[prereqID]->title;
+                std::string_view pTitle = resourceMap[prereqID]->title;
 
                 std::cout << "[" << prereqID << "] " << pTitle << " unlocks:" << std::endl;
                 for (int depID : dependents) {
-                    std::string dTitle = resourceMap[depID]->title;
+                    std::string_view dTitle = resourceMap[depID]->title;
                     std::cout << "  |-> [" << depID << "] " << dTitle << std::endl;
                 }
             }
@@ -88,9 +189,11 @@ public:
         q.push(targetID);
         nodes.insert(targetID);
 
+        // Lookups use find() rather than [] so concurrent readers never insert
         while(!q.empty()){
             int curr = q.front(); q.pop();
-            Resource* r = resourceMap[curr];
+            auto found = resourceMap.find(curr);
+            Resource* r = found == resourceMap.end() ? nullptr : found->second;
             if(r) {
                 for(int pre : r->prereqIDs) {
                     if(nodes.find(pre) == nodes.end()) {
@@ -107,7 +210,9 @@ public:
         for(int n : nodes) inDegree[n] = 0;
 
         for(int u : nodes) {
-            Resource* r = resourceMap[u];
+            auto found = resourceMap.find(u);
+            if (found == resourceMap.end()) continue;
+            Resource* r = found->second;
             for(int pre : r->prereqIDs) {
                 if(nodes.count(pre)) {
                     localAdj[pre].push_back(u);
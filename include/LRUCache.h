@@ -4,7 +4,8 @@
 #include "Resource.h"
 #include "DoublyLinkedList.h" // Assuming this includes the Node definition
 #include <unordered_map>
-#include <iostream>
+#include <sstream>
+#include "Log.h"
 #include <string>
 #include <algorithm>
 
@@ -15,41 +16,40 @@ private:
     Node* tail; // Dummy tail (LRU side)
     int capacity;
 
-    // Helper function to print the full state of the cache (implementation remains inline)
-    void printCacheState(const std::string& operation) const {
-        std::cout << "\n--- LRUCache State after " << operation
-                  << " (Size: " << cacheMap.size() << ", Capacity: " << capacity << ") ---" << std::endl;
+    // Renders the full state of the cache for trace logging
+    std::string describeState(const std::string& operation) const {
+        std::ostringstream out;
+        out << "LRUCache State after " << operation
+            << " (Size: " << cacheMap.size() << ", Capacity: " << capacity << ")\n";
 
-        // Print Linked List (Recency Order)
-        std::cout << "  Recency Order (MRU -> LRU): ";
+        // Linked List (Recency Order)
+        out << "  Recency Order (MRU -> LRU): ";
         Node* curr = head->next;
         if (curr == tail) {
-            std::cout << "Cache is empty." << std::endl;
+            out << "Cache is empty.";
         } else {
             while (curr != tail) {
-                std::cout << curr->res->title << " [" << curr->res->id << "] ";
+                out << curr->res->title << " [" << curr->res->id << "] ";
                 if (curr->next != tail) {
-                    std::cout << "<-> ";
+                    out << "<-> ";
                 }
                 curr = curr->next;
             }
-            std::cout << std::endl;
         }
 
-        // Print Hash Map keys
-        std::cout << "  Map Keys (for verification): [";
-        int count = 0;
+        // Hash Map keys
+        out << "\n  Map Keys (for verification): [";
+        size_t count = 0;
         for (const auto& pair : cacheMap) {
-            std::cout << pair.first;
-            if (count++ < cacheMap.size() - 1) {
-                std::cout << ", ";
+            out << pair.first;
+            if (++count < cacheMap.size()) {
+                out << ", ";
             }
         }
-        std::cout << "]" << std::endl;
-        std::cout << "------------------------------------------------------------------" << std::endl;
+        out << "]";
+        return out.str();
     }
 
-
     // Removes a node from its current position. O(1).
     void removeNode(Node* node) {
         node->prev->next = node->next;
@@ -108,39 +108,38 @@ public:
         }
     }
 
-    Resource* get(int id, bool doPrint = true) {
-        if (cacheMap.count(id)) {
-            Node* node = cacheMap[id];
+    Resource* get(int id) {
+        auto it = cacheMap.find(id);
+        if (it != cacheMap.end()) {
+            Node* node = it->second;
             moveToHead(node);
-            if (doPrint) {
-                printCacheState("GET (Cache Hit ID: " + std::to_string(id) + ")");
-            }
+            CC_LOG_TRACE(describeState("GET (Cache Hit ID: " + std::to_string(id) + ")"));
             return node->res;
         }
-        if (doPrint) {
-            printCacheState("GET (Cache Miss ID: " + std::to_string(id) + ")");
-        }
+        CC_LOG_TRACE(describeState("GET (Cache Miss ID: " + std::to_string(id) + ")"));
         return nullptr;
     }
 
-    void put(Resource* res, bool doPrint = true) {
-        if (cacheMap.count(res->id)) {
+    void put(Resource* res) {
+        auto it = cacheMap.find(res->id);
+        if (it != cacheMap.end()) {
             // Already exists, update recency
-            moveToHead(cacheMap[res->id]);
-            if (doPrint) {
-                printCacheState("PUT (Updated Recency ID: " + std::to_string(res->id) + ")");
-            }
+            moveToHead(it->second);
+            CC_LOG_TRACE(describeState("PUT (Updated Recency ID: " + std::to_string(res->id) + ")"));
         } else {
-            if (cacheMap.size() == capacity) {
+            if (static_cast<int>(cacheMap.size()) == capacity) {
                 evictLRU();
             }
             addNewNode(res);
-            if (doPrint) {
-                printCacheState("PUT (New Entry ID: " + std::to_string(res->id) + ")");
-            }
+            CC_LOG_TRACE(describeState("PUT (New Entry ID: " + std::to_string(res->id) + ")"));
         }
     }
 
+    // Drops every entry (e.g. after the catalog was reloaded)
+    void clear() {
+        while (tail->prev != head) evictLRU();
+    }
+
     int size() const {
         return cacheMap.size();
     }
@@ -155,7 +154,7 @@ public:
         int position = 0;
         while (curr != tail) {
             std::string nodeInfo = std::to_string(curr->res->id) + ":" + 
-                                  curr->res->title + ":" + 
+                                  std::string(curr->res->title) + ":" + 
                                   std::to_string(position);
             result.push_back("NODE:" + nodeInfo);
             
@@ -0,0 +1,135 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <cstdlib>
+#include <cctype>
+
+// =========================================================
+// LOGGING
+// Diagnostics never go to stdout: stdout carries command results
+// (and the framed protocol in --serve / --batch modes).
+//
+// Two filters:
+//   - Compile time: CC_LOG_COMPILE_LEVEL (0 = TRACE ... 5 = OFF).
+//     Sites below it expand to nothing, arguments are not evaluated.
+//     Defaults to TRACE in debug builds and INFO when NDEBUG is set.
+//   - Run time: Log::setLevel(), or the CODECOMPASS_LOG_LEVEL
+//     environment variable (trace|debug|info|warn|error|off).
+//     Defaults to WARN.
+//
+// Usage: CC_LOG_DEBUG("Loaded " << n << " resources");
+// =========================================================
+
+#ifndef CC_LOG_COMPILE_LEVEL
+    #ifdef NDEBUG
+        #define CC_LOG_COMPILE_LEVEL 2
+    #else
+        #define CC_LOG_COMPILE_LEVEL 0
+    #endif
+#endif
+
+namespace Log {
+
+    enum Level { LEVEL_TRACE = 0, LEVEL_DEBUG, LEVEL_INFO, LEVEL_WARN, LEVEL_ERROR, LEVEL_OFF };
+
+    inline bool parseLevel(const std::string& name, Level& level) {
+        std::string lower;
+        for (char c : name) lower += static_cast<char>(tolower(c));
+        if (lower == "trace") level = LEVEL_TRACE;
+        else if (lower == "debug") level = LEVEL_DEBUG;
+        else if (lower == "info") level = LEVEL_INFO;
+        else if (lower == "warn" || lower == "warning") level = LEVEL_WARN;
+        else if (lower == "error") level = LEVEL_ERROR;
+        else if (lower == "off") level = LEVEL_OFF;
+        else return false;
+        return true;
+    }
+
+    inline std::atomic<int>& runtimeLevel() {
+        static std::atomic<int> level([] {
+            Level fromEnv = LEVEL_WARN;
+            const char* env = std::getenv("CODECOMPASS_LOG_LEVEL");
+            if (env) parseLevel(env, fromEnv);
+            return static_cast<int>(fromEnv);
+        }());
+        return level;
+    }
+
+    inline void setLevel(Level level) { runtimeLevel() = level; }
+    inline Level getLevel() { return static_cast<Level>(runtimeLevel().load()); }
+    inline bool enabled(Level level) { return level >= runtimeLevel().load(std::memory_order_relaxed); }
+
+    inline std::mutex& sinkMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    inline std::ostream*& sinkRef() {
+        static std::ostream* sink = &std::cerr;
+        return sink;
+    }
+
+    // Redirect all log lines (e.g. to a file); nullptr restores stderr
+    inline void setSink(std::ostream* sink) {
+        std::lock_guard<std::mutex> lock(sinkMutex());
+        sinkRef() = sink ? sink : &std::cerr;
+    }
+
+    inline void write(Level level, const std::string& message) {
+        static const char* const tags[] = {"TRACE", "DEBUG", "INFO", "WARN", "ERROR", "OFF"};
+        std::lock_guard<std::mutex> lock(sinkMutex());
+        std::ostream& out = *sinkRef();
+        out << "[" << tags[level] << "] " << message << '\n';
+        out.flush();
+    }
+}
+
+// True when a level passes both filters; use it to guard expensive state dumps
+#define CC_LOG_ENABLED(level) \
+    ((level) >= CC_LOG_COMPILE_LEVEL && ::Log::enabled(level))
+
+#define CC_LOG_AT(level, expr) \
+    do { \
+        if (CC_LOG_ENABLED(level)) { \
+            std::ostringstream ccLogMessage; \
+            ccLogMessage << expr; \
+            ::Log::write(level, ccLogMessage.str()); \
+        } \
+    } while (0)
+
+#if CC_LOG_COMPILE_LEVEL <= 0
+    #define CC_LOG_TRACE(expr) CC_LOG_AT(::Log::LEVEL_TRACE, expr)
+#else
+    #define CC_LOG_TRACE(expr) do {} while (0)
+#endif
+
+#if CC_LOG_COMPILE_LEVEL <= 1
+    #define CC_LOG_DEBUG(expr) CC_LOG_AT(::Log::LEVEL_DEBUG, expr)
+#else
+    #define CC_LOG_DEBUG(expr) do {} while (0)
+#endif
+
+#if CC_LOG_COMPILE_LEVEL <= 2
+    #define CC_LOG_INFO(expr) CC_LOG_AT(::Log::LEVEL_INFO, expr)
+#else
+    #define CC_LOG_INFO(expr) do {} while (0)
+#endif
+
+#if CC_LOG_COMPILE_LEVEL <= 3
+    #define CC_LOG_WARN(expr) CC_LOG_AT(::Log::LEVEL_WARN, expr)
+#else
+    #define CC_LOG_WARN(expr) do {} while (0)
+#endif
+
+#if CC_LOG_COMPILE_LEVEL <= 4
+    #define CC_LOG_ERROR(expr) CC_LOG_AT(::Log::LEVEL_ERROR, expr)
+#else
+    #define CC_LOG_ERROR(expr) do {} while (0)
+#endif
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstddef>
+
+#if defined(_WIN32)
+    // MinGW builds: no mmap, so we fall back to reading the file into a buffer.
+    #define CC_HAS_MMAP 0
+#else
+    #define CC_HAS_MMAP 1
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+// =========================================================
+// MAPPED FILE
+// Read-only view of a whole file. On POSIX the file is mmap'd,
+// so pages are only faulted in when they are actually touched.
+// =========================================================
+
+class MappedFile {
+private:
+    const char* base;
+    size_t length;
+#if CC_HAS_MMAP
+    bool mapped;
+#endif
+    std::vector<char> buffer; // Used when mmap is unavailable
+
+public:
+#if CC_HAS_MMAP
+    MappedFile() : base(nullptr), length(0), mapped(false) {}
+#else
+    MappedFile() : base(nullptr), length(0) {}
+#endif
+    explicit MappedFile(const std::string& path) : MappedFile() { open(path); }
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path) {
+        close();
+#if CC_HAS_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0) { ::close(fd); return false; }
+        length = static_cast<size_t>(st.st_size);
+
+        if (length == 0) {
+            // mmap rejects zero-length mappings; an empty file is still a valid file
+            ::close(fd);
+            base = "";
+            return true;
+        }
+
+        void* p = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // The mapping keeps its own reference to the file
+        if (p == MAP_FAILED) { length = 0; return false; }
+
+        base = static_cast<const char*>(p);
+        mapped = true;
+        return true;
+#else
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in.is_open()) return false;
+        length = static_cast<size_t>(in.tellg());
+        in.seekg(0);
+        buffer.resize(length);
+        if (length > 0 && !in.read(buffer.data(), length)) { close(); return false; }
+        base = length > 0 ? buffer.data() : "";
+        return true;
+#endif
+    }
+
+    void close() {
+#if CC_HAS_MMAP
+        if (mapped) munmap(const_cast<char*>(base), length);
+        mapped = false;
+#endif
+        buffer.clear();
+        buffer.shrink_to_fit();
+        base = nullptr;
+        length = 0;
+    }
+
+    // Hint that the whole file will be read front to back
+    void adviseSequential() const {
+#if CC_HAS_MMAP
+        if (mapped) madvise(const_cast<char*>(base), length, MADV_SEQUENTIAL);
+#endif
+    }
+
+    bool isOpen() const { return base != nullptr; }
+    const char* data() const { return base; }
+    size_t size() const { return length; }
+};
+
+#endif
@@ -3,20 +3,40 @@
 
 #include "Resource.h"
 #include <vector>
-#include <iostream>
+#include <sstream>
 #include <algorithm>
 #include <string>
+#include <unordered_map>
+#include "Log.h"
 
 class MaxHeap {
 private:
     std::vector<Resource*> heap;
+    unsigned long revision = 0; // Bumped on every mutation
+
+    // Optional slot index so remove() is O(log n); off for short-lived heaps
+    bool trackPositions;
+    std::unordered_map<const Resource*, size_t> slots;
+
+    void place(size_t index, Resource* res) {
+        heap[index] = res;
+        if (trackPositions) slots[res] = index;
+    }
+
+    void swapEntries(size_t a, size_t b) {
+        std::swap(heap[a], heap[b]);
+        if (trackPositions) {
+            slots[heap[a]] = a;
+            slots[heap[b]] = b;
+        }
+    }
 
     void heapifyUp(int index) {
         if (index > 0) {
             int parent = (index - 1) / 2;
             // MaxHeap property: parent rating must be >= child rating
             if (heap[index]->rating > heap[parent]->rating) {
-                std::swap(heap[index], heap[parent]);
+                swapEntries(index, parent);
                 heapifyUp(parent);
             }
         }
@@ -36,64 +56,91 @@ private:
         }
 
         if (largest != index) {
-            std::swap(heap[index], heap[largest]);
+            swapEntries(index, largest);
             heapifyDown(largest);
         }
     }
 
-    // Helper function to print the current state of the heap's internal array
-    void printHeapState(const std::string& operation) const {
-        std::cout << "\n--- MaxHeap State after " << operation << " (Size: " << heap.size() << ") ---" << std::endl;
-        std::cout << "  (Internal Array Representation, Max Element is always first)" << std::endl;
+    // Renders the heap's internal array for trace logging
+    std::string describeState(const std::string& operation) const {
+        std::ostringstream out;
+        out << "MaxHeap State after " << operation << " (Size: " << heap.size() << ")\n";
+        out << "  (Internal Array Representation, Max Element is always first)\n";
         if (heap.empty()) {
-            std::cout << "Heap is empty." << std::endl;
+            out << "  Heap is empty.";
         } else {
-            std::cout << "  [";
+            out << "  [";
             for (size_t i = 0; i < heap.size(); ++i) {
-                std::cout << heap[i]->title << " (R=" << heap[i]->rating << ")";
+                out << heap[i]->title << " (R=" << heap[i]->rating << ")";
                 if (i < heap.size() - 1) {
-                    std::cout << ", ";
+                    out << ", ";
                 }
             }
-            std::cout << "]" << std::endl;
+            out << "]";
         }
-        std::cout << "---------------------------------------------------------" << std::endl;
+        return out.str();
     }
 
 
 public:
-    // Added doPrint flag
-    void insert(Resource* res, bool doPrint = true) {
+    explicit MaxHeap(bool trackPositions = false) : trackPositions(trackPositions) {}
+
+    void insert(Resource* res) {
         heap.push_back(res);
+        if (trackPositions) slots[res] = heap.size() - 1;
         heapifyUp(heap.size() - 1);
-       /* if (doPrint) {
-            printHeapState("INSERT (Resource ID: " + std::to_string(res->id) + ")");
-        }*/
+        revision++;
+        // One line only: a full dump per insert would make heap builds quadratic under tracing
+        CC_LOG_TRACE("MaxHeap INSERT (Resource ID: " << res->id << ", Size: " << heap.size() << ")");
     }
 
-    // Added doPrint flag
-    Resource* extractMax(bool doPrint = true) {
+    Resource* extractMax() {
         if (heap.empty()) {
-            if (doPrint) {
-                printHeapState("EXTRACT_MAX (Heap Empty)");
-            }
+            CC_LOG_TRACE(describeState("EXTRACT_MAX (Heap Empty)"));
             return nullptr;
         }
         Resource* max = heap.front();
+        if (trackPositions) slots.erase(max);
 
         // Move last element to the root
-        heap.front() = heap.back();
+        Resource* last = heap.back();
         heap.pop_back();
+        if (!heap.empty()) place(0, last);
 
         // Fix the heap property
         heapifyDown(0);
+        revision++;
 
-        if (doPrint) {
-            printHeapState("EXTRACT_MAX (Extracted ID: " + std::to_string(max->id) + ")");
-        }
+        CC_LOG_TRACE(describeState("EXTRACT_MAX (Extracted ID: " + std::to_string(max->id) + ")"));
         return max;
     }
 
+    // Removes an arbitrary entry. O(log n) with position tracking, O(n) without.
+    bool remove(const Resource* res) {
+        size_t index;
+        if (trackPositions) {
+            auto it = slots.find(res);
+            if (it == slots.end()) return false;
+            index = it->second;
+            slots.erase(it);
+        } else {
+            auto it = std::find(heap.begin(), heap.end(), res);
+            if (it == heap.end()) return false;
+            index = static_cast<size_t>(it - heap.begin());
+        }
+
+        Resource* last = heap.back();
+        heap.pop_back();
+        if (index < heap.size()) {
+            place(index, last);
+            // The moved entry either rises or sinks, never both
+            heapifyUp(static_cast<int>(index));
+            if (heap[index] == last) heapifyDown(static_cast<int>(index));
+        }
+        revision++;
+        return true;
+    }
+
     bool isEmpty() const {
         return heap.empty();
     }
@@ -127,6 +174,24 @@ public:
         return heap.size();
     }
 
+    // Raw array in heap order (index 0 is the max)
+    const std::vector<Resource*>& getArray() const {
+        return heap;
+    }
+
+    // Adopt an array that is already in valid heap order (e.g. from a snapshot)
+    void assign(const std::vector<Resource*>& heapOrdered) {
+        heap = heapOrdered;
+        if (trackPositions) {
+            slots.clear();
+            slots.reserve(heap.size());
+            for (size_t i = 0; i < heap.size(); i++) slots[heap[i]] = i;
+        }
+        revision++;
+    }
+
+    unsigned long getRevision() const { return revision; }
+
     Resource* getMax() const {
         return heap.empty() ? nullptr : heap[0];
     }
@@ -0,0 +1,119 @@
+#ifndef NGRAMINDEX_H
+#define NGRAMINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "Resource.h"
+
+// =========================================================
+// N-GRAM INDEX
+// Responsibility: Find resources whose title or topic contains a
+// string anywhere (infix search: "sort" -> "Merge Sort"), which
+// the prefix Trie cannot answer.
+//
+// Every lowercased 3-byte window (trigram) of a title or topic maps
+// to the ascending row numbers that contain it. A query looks up
+// its own trigrams, intersects their lists (shortest first) into
+// candidates, then checks each candidate's text, since sharing all
+// trigrams does not guarantee the query appears contiguously.
+// Queries shorter than 3 bytes scan the text of every row. That
+// text is kept lowercased in one buffer, so checks read it in row
+// order instead of chasing each resource.
+//
+// Posting lists are delta + varint encoded, in blocks of
+// kBlockSize postings. A skip entry per block (first row, byte
+// offset) lets the intersection jump to the block that may hold a
+// candidate instead of decoding the whole list.
+// Row i is the i-th resource of the list passed to build().
+//
+// update() derives an index from a previous one when only some rows
+// changed (RELOAD): only the lists of those rows' old and new grams
+// are decoded and re-encoded; every other list is copied as bytes.
+// Snapshots store the arrays byte for byte, and loading copies them
+// back (see Snapshot::Image::loadInfixIndex).
+// =========================================================
+
+class NGramIndex {
+public:
+    static constexpr size_t kBlockSize = 128;
+    static constexpr size_t kVerifyBelow = 32; // Stop intersecting once this few candidates remain
+    static constexpr char kSeparator = '\0';    // After a row's title and after its topic in 'text'
+
+    // Work done by one find(), for the ANALYSIS block
+    struct Stats {
+        size_t listsRead = 0;
+        size_t blocksDecoded = 0;
+        size_t candidates = 0;
+    };
+
+    struct Skip {
+        uint32_t firstRow;
+        uint32_t offset;    // Into 'data'
+    };
+
+    // The index without its rows, as stored in a snapshot
+    struct Arrays {
+        std::vector<uint32_t> grams, counts, skipOffsets;
+        std::vector<Skip> skips;
+        std::vector<uint8_t> data;
+        std::vector<char> text;
+        std::vector<uint32_t> textOffsets;
+    };
+
+private:
+    std::vector<uint32_t> grams;        // Sorted trigram keys (3 bytes, big-endian)
+    std::vector<uint32_t> counts;       // Postings per gram
+    std::vector<uint32_t> skipOffsets;  // grams.size() + 1, into 'skips'
+    std::vector<Skip> skips;
+    std::vector<uint8_t> data;
+    std::vector<char> text;             // Lowercased "title<kSeparator>topic<kSeparator>" of every row
+    std::vector<uint32_t> textOffsets;  // rows.size() + 1, into 'text'
+    std::vector<Resource*> rows;
+
+    // Index of 'gram' in 'grams', or -1
+    long lookup(uint32_t gram) const;
+    // Decodes block 'b' of gram 'g' into 'out' (cleared first)
+    void decodeBlock(size_t g, size_t b, std::vector<uint32_t>& out) const;
+    bool matches(uint32_t row, std::string_view lowerText) const;
+
+public:
+    /**
+     * Indexes the title and topic of every resource in 'list'. O(total text length).
+     */
+    void build(const std::vector<Resource*>& list);
+    /**
+     * Same result as build(list), reusing 'base' (built for the previous rows).
+     * @param changedRows Rows of 'list' whose resource differs from base's row, or is new.
+     * Rows of 'base' past the end of 'list' are dropped. O(changed text + index bytes).
+     */
+    void update(const NGramIndex& base, const std::vector<Resource*>& list, const std::vector<uint32_t>& changedRows);
+    void clear();
+    // Points row i at list[i], a resource with the same contents as the one indexed
+    // (RELOAD stages against parsed copies, then overwrites the live objects to match)
+    void rebind(const std::vector<Resource*>& list) { rows = list; }
+    void swap(NGramIndex& other);
+
+    size_t size() const { return rows.size(); }
+    size_t gramCount() const { return grams.size(); }
+    size_t memoryUsage() const;
+    Resource* row(uint32_t i) const { return rows[i]; }
+
+    void exportArrays(Arrays& out) const;
+    /**
+     * Replaces the contents with arrays built for 'list' (e.g. from a snapshot).
+     * @return false, leaving the index empty, if they are not valid for a list of that size.
+     */
+    bool importArrays(Arrays&& in, const std::vector<Resource*>& list);
+    // Every offset, count and encoded posting in 'a' is in range, for 'rowCount' rows. O(index size).
+    static bool isValid(const Arrays& a, size_t rowCount);
+
+    /**
+     * Rows whose title or topic contains 'query', ignoring case, ascending.
+     * @param stats If set, receives counters for this query.
+     */
+    void find(std::string_view query, std::vector<uint32_t>& out, Stats* stats = nullptr) const;
+};
+
+#endif
@@ -11,12 +11,12 @@ namespace Optimizer {
 
     /**
      * Solves the 0/1 Knapsack Problem to maximize total Rating within maxDuration.
-     * * @param items Vector of available resources.
-     * @param maxMinutes The time constraint.
-     * @return A vector of the selected resources that yield the highest rating.
+     * Works on plain columns (e.g. from a ColumnStore): item i takes durations[i]
+     * minutes and is worth ratings[i].
+     * @return Indices of the selected items, highest index first.
      */
-    std::vector<Resource*> maximizeRating(const std::vector<Resource*>& items, int maxMinutes) {
-        int n = items.size();
+    std::vector<size_t> maximizeRating(const int* durations, const double* ratings, size_t count, int maxMinutes) {
+        int n = static_cast<int>(count);
 
         // DP Table: dp[i][w] stores the max rating using a subset of the first 'i' items
         // with a total duration limit of 'w'.
@@ -28,9 +28,8 @@ namespace Optimizer {
         // 1. Build the DP Table
         // ---------------------------------------------------------
         for (int i = 1; i <= n; i++) {
-            Resource* r = items[i - 1]; // items is 0-indexed
-            int weight = r->duration;
-            double value = r->rating;
+            int weight = durations[i - 1]; // columns are 0-indexed
+            double value = ratings[i - 1];
 
             for (int w = 0; w <= maxMinutes; w++) {
                 if (weight <= w) {
@@ -51,21 +50,42 @@ namespace Optimizer {
         // ---------------------------------------------------------
         // 2. Backtrack to Find Selected Items
         // ---------------------------------------------------------
-        std::vector<Resource*> selectedItems;
+        std::vector<size_t> selected;
         int w = maxMinutes;
 
         for (int i = n; i > 0; i--) {
             // If the value came from the row above, we didn't include item 'i'
             // We use a small epsilon for double comparison safety, though != usually works fine here.
             if (std::abs(dp[i][w] - dp[i - 1][w]) > 1e-9) {
-                Resource* r = items[i - 1];
-                selectedItems.push_back(r);
-                w -= r->duration; // Reduce remaining capacity
+                selected.push_back(static_cast<size_t>(i - 1));
+                w -= durations[i - 1]; // Reduce remaining capacity
             }
         }
 
+        return selected;
+    }
+
+    /**
+     * Solves the 0/1 Knapsack Problem to maximize total Rating within maxDuration.
+     * * @param items Vector of available resources.
+     * @param maxMinutes The time constraint.
+     * @return A vector of the selected resources that yield the highest rating.
+     */
+    std::vector<Resource*> maximizeRating(const std::vector<Resource*>& items, int maxMinutes) {
+        // Gather the two attributes once; the DP then never touches a Resource
+        std::vector<int> durations(items.size());
+        std::vector<double> ratings(items.size());
+        for (size_t i = 0; i < items.size(); i++) {
+            durations[i] = items[i]->duration;
+            ratings[i] = items[i]->rating;
+        }
+
+        std::vector<Resource*> selectedItems;
+        for (size_t i : maximizeRating(durations.data(), ratings.data(), items.size(), maxMinutes)) {
+            selectedItems.push_back(items[i]);
+        }
         return selectedItems;
     }
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -2,11 +2,109 @@
 #define RESOURCE_H
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include <utility>
+#include <cstring>
+#include <cstdint>
 #include <iostream>
+#include "SymbolTable.h"
 
 using namespace std;
 
+// =========================================================
+// RESOURCE FIELD TYPES
+// A Resource does not own its strings or its prereq list: they
+// point into memory owned by a ResourceStore arena (or, for a
+// standalone Resource, one block owned by the Resource itself).
+// =========================================================
+
+// Interned topic: 4 bytes per resource instead of a std::string.
+// Equality compares IDs; ordering compares names.
+struct Topic {
+    uint32_t id;
+
+    Topic() : id(0) {}
+    explicit Topic(std::string_view name) : id(SymbolTable::topics().intern(name)) {}
+
+    std::string_view name() const { return SymbolTable::topics().name(id); }
+    std::string str() const { return std::string(name()); }
+    operator std::string_view() const { return name(); }
+
+    friend bool operator==(Topic a, Topic b) { return a.id == b.id; }
+    friend bool operator!=(Topic a, Topic b) { return a.id != b.id; }
+    friend bool operator<(Topic a, Topic b) { return a.name() < b.name(); }
+    friend bool operator<=(Topic a, Topic b) { return a.id == b.id || a.name() <= b.name(); }
+    friend bool operator>(Topic a, Topic b) { return b < a; }
+    friend bool operator>=(Topic a, Topic b) { return b <= a; }
+    friend bool operator==(Topic a, std::string_view s) { return a.name() == s; }
+    friend bool operator!=(Topic a, std::string_view s) { return a.name() != s; }
+    friend std::ostream& operator<<(std::ostream& out, Topic t) { return out << t.name(); }
+};
+
+// URL stored as an interned prefix ("https://www.google.com/search?q=") plus
+// the bytes after it. Catalogs link to a handful of sites, so most of every URL
+// is shared.
+struct UrlRef {
+    uint32_t prefix;
+    uint32_t length;    // Of 'rest'
+    const char* rest;
+
+    UrlRef() : prefix(0), length(0), rest(nullptr) {}
+
+    // Length of the prefix that 'url' would be split at: through the last '/', '?' or '='
+    static size_t splitPoint(std::string_view url) {
+        size_t cut = url.find_last_of("/?=");
+        return cut == std::string_view::npos ? 0 : cut + 1;
+    }
+
+    std::string_view prefixText() const { return SymbolTable::urlPrefixes().name(prefix); }
+    std::string_view restText() const { return std::string_view(rest, length); }
+    size_t size() const { return prefixText().size() + length; }
+    bool empty() const { return size() == 0; }
+
+    std::string str() const {
+        std::string s(prefixText());
+        s.append(rest, length);
+        return s;
+    }
+
+    friend bool operator==(const UrlRef& a, const UrlRef& b) {
+        if (a.prefix == b.prefix) return a.restText() == b.restText();
+        return a.size() == b.size() && a.str() == b.str();
+    }
+    friend bool operator!=(const UrlRef& a, const UrlRef& b) { return !(a == b); }
+    friend bool operator==(const UrlRef& a, std::string_view s) {
+        std::string_view p = a.prefixText();
+        return s.size() == a.size() && s.substr(0, p.size()) == p && s.substr(p.size()) == a.restText();
+    }
+    friend std::ostream& operator<<(std::ostream& out, const UrlRef& u) {
+        return out << u.prefixText() << u.restText();
+    }
+};
+
+// Read-only array of prereq IDs
+struct IdList {
+    const int* ids;
+    uint32_t count;
+
+    IdList() : ids(nullptr), count(0) {}
+    IdList(const int* p, size_t n) : ids(p), count(static_cast<uint32_t>(n)) {}
+
+    const int* begin() const { return ids; }
+    const int* end() const { return ids + count; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    int operator[](size_t i) const { return ids[i]; }
+    std::vector<int> toVector() const { return std::vector<int>(begin(), end()); }
+
+    friend bool operator==(const IdList& a, const IdList& b) {
+        return a.count == b.count && (a.count == 0 || std::memcmp(a.ids, b.ids, a.count * sizeof(int)) == 0);
+    }
+    friend bool operator!=(const IdList& a, const IdList& b) { return !(a == b); }
+    friend bool operator==(const IdList& a, const std::vector<int>& v) { return a == IdList(v.data(), v.size()); }
+};
+
 // =========================================================
 // THE RESOURCE CLASS
 // This is the fundamental unit of data for "CodeCompass".
@@ -15,20 +113,50 @@ using namespace std;
 
 struct Resource {
     int id;                     // Unique ID (Used for AVL Tree balancing)
-    string title;          // e.g., "Introduction to BST"
-    string url;            // e.g., "https://youtube.com/..."
-    string topic;          // Used for Trie Indexing (e.g., "Trees")
+    std::string_view title;     // e.g., "Introduction to BST"
+    UrlRef url;                 // e.g., "https://youtube.com/..."
+    Topic topic;                // Used for Trie Indexing (e.g., "Trees")
 
     int difficulty;             // 1-100 Scale (Used for QuickSort/MergeSort)
     double rating;              // 1.0-5.0 Scale (Used for Max-Heap Priority Queue)
     int duration;            // Duration in minutes (Used for Knapsack)
 
-    vector<int> prereqIDs; // List of Resource IDs required to learn this.
+    IdList prereqIDs; // List of Resource IDs required to learn this.
     // Used for Graph Construction (Adjacency List) & Dijkstra.
 
-    // Constructor for easy creation
-    Resource(int i, string t, string u, string top, int diff, double rate, vector<int> pre, int dur)
-        : id(i), title(t), url(u), topic(top), difficulty(diff), rating(rate), prereqIDs(pre), duration(dur) {}
+    // Constructor for easy creation: a standalone Resource that owns a copy of its
+    // strings and prereqs. Bulk loads go through ResourceStore::create instead.
+    Resource(int i, std::string_view t, std::string_view u, std::string_view top, int diff, double rate,
+             const std::vector<int>& pre, int dur)
+        : id(i), topic(top), difficulty(diff), rating(rate), duration(dur), owned(nullptr) {
+        size_t cut = UrlRef::splitPoint(u);
+        size_t idBytes = pre.size() * sizeof(int);
+        size_t textBytes = t.size() + (u.size() - cut);
+        owned = new char[idBytes + textBytes];
+        char* p = owned;
+
+        // Prereqs first so they stay int-aligned
+        if (idBytes) std::memcpy(p, pre.data(), idBytes);
+        prereqIDs = IdList(reinterpret_cast<const int*>(p), pre.size());
+        p += idBytes;
+
+        std::memcpy(p, t.data(), t.size());
+        title = std::string_view(p, t.size());
+        p += t.size();
+
+        url.prefix = SymbolTable::urlPrefixes().intern(u.substr(0, cut));
+        url.length = static_cast<uint32_t>(u.size() - cut);
+        url.rest = p;
+        std::memcpy(p, u.data() + cut, url.length);
+    }
+
+    Resource(const Resource& other)
+        : Resource(other.id, other.title, other.url.str(), other.topic.name(), other.difficulty, other.rating,
+                   other.prereqIDs.toVector(), other.duration) {}
+    Resource& operator=(const Resource&) = delete;
+
+    // Arena resources own nothing; ResourceStore never runs this
+    ~Resource() { delete[] owned; }
 
     // Helper to print resource details (Useful for debugging)
     void print() const {
@@ -37,6 +165,12 @@ struct Resource {
                   << " | Rating: " << rating
                   << " | Duration: "  << endl;
     }
+
+private:
+    friend class ResourceStore;
+    char* owned;    // Standalone storage, nullptr for arena resources
+
+    Resource() : id(0), difficulty(0), rating(0.0), duration(0), owned(nullptr) {}
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,170 @@
+#ifndef RESOURCESTORE_H
+#define RESOURCESTORE_H
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+#include "Arena.h"
+#include "Resource.h"
+
+// =========================================================
+// RESOURCE STORE
+// Owns the resources of a catalog. Each Resource, its title and
+// URL bytes, and its prereq array are carved out of one Arena,
+// so loading N resources costs a few dozen allocations instead of
+// ~5N, and teardown is a handful of free() calls instead of a
+// delete per resource.
+//
+// Topics and URL prefixes are interned process-wide (see Resource.h),
+// so a resource keeps a 4-byte topic ID and only its own URL suffix.
+//
+// One writer at a time. Readers may use resources that were already
+// created while the writer adds more (nothing ever moves).
+// =========================================================
+
+class ResourceStore {
+private:
+    Arena arena;
+    size_t count;
+
+public:
+    ResourceStore() : count(0) {}
+
+    ResourceStore(const ResourceStore&) = delete;
+    ResourceStore& operator=(const ResourceStore&) = delete;
+
+    /**
+     * Allocates a resource; strings and prereqs are copied into the arena.
+     * The result lives until the store is destroyed.
+     */
+    Resource* create(int id, std::string_view title, std::string_view url, std::string_view topic,
+                     int difficulty, double rating, const int* prereqs, size_t prereqCount, int duration) {
+        Resource* r = new (arena.allocate(sizeof(Resource), alignof(Resource))) Resource();
+        r->id = id;
+        r->difficulty = difficulty;
+        r->rating = rating;
+        r->duration = duration;
+        r->topic = Topic(topic);
+
+        int* ids = arena.allocateArray<int>(prereqCount);
+        if (prereqCount) std::memcpy(ids, prereqs, prereqCount * sizeof(int));
+        r->prereqIDs = IdList(ids, prereqCount);
+
+        r->title = arena.copy(title);
+        size_t cut = UrlRef::splitPoint(url);
+        std::string_view rest = arena.copy(url.substr(cut));
+        r->url.prefix = SymbolTable::urlPrefixes().intern(url.substr(0, cut));
+        r->url.length = static_cast<uint32_t>(rest.size());
+        r->url.rest = rest.data();
+
+        count++;
+        return r;
+    }
+
+    // Same, for a topic and URL prefix that are already interned (e.g. a binary catalog's dictionaries)
+    Resource* create(int id, std::string_view title, uint32_t urlPrefix, std::string_view urlRest, Topic topic,
+                     int difficulty, double rating, const int* prereqs, size_t prereqCount, int duration) {
+        Resource* r = new (arena.allocate(sizeof(Resource), alignof(Resource))) Resource();
+        r->id = id;
+        r->difficulty = difficulty;
+        r->rating = rating;
+        r->duration = duration;
+        r->topic = topic;
+
+        int* ids = arena.allocateArray<int>(prereqCount);
+        if (prereqCount) std::memcpy(ids, prereqs, prereqCount * sizeof(int));
+        r->prereqIDs = IdList(ids, prereqCount);
+
+        r->title = arena.copy(title);
+        r->url.prefix = urlPrefix;
+        r->url.length = static_cast<uint32_t>(urlRest.size());
+        r->url.rest = arena.copy(urlRest).data();
+
+        count++;
+        return r;
+    }
+
+    /**
+     * Same, but the title, URL suffix and prereqs stay where they are (e.g. in a mapped
+     * snapshot) instead of being copied. They must outlive every use of the resource.
+     */
+    Resource* createView(int id, std::string_view title, uint32_t urlPrefix, std::string_view urlRest, Topic topic,
+                         int difficulty, double rating, const int* prereqs, size_t prereqCount, int duration) {
+        Resource* r = new (arena.allocate(sizeof(Resource), alignof(Resource))) Resource();
+        r->id = id;
+        r->difficulty = difficulty;
+        r->rating = rating;
+        r->duration = duration;
+        r->topic = topic;
+        r->prereqIDs = IdList(prereqs, prereqCount);
+        r->title = title;
+        r->url.prefix = urlPrefix;
+        r->url.length = static_cast<uint32_t>(urlRest.size());
+        r->url.rest = urlRest.data();
+
+        count++;
+        return r;
+    }
+
+    // Copies a resource (e.g. one parsed into a temporary store) into this one
+    Resource* create(const Resource& source) {
+        Resource* r = new (arena.allocate(sizeof(Resource), alignof(Resource))) Resource();
+        r->id = source.id;
+        r->difficulty = source.difficulty;
+        r->rating = source.rating;
+        r->duration = source.duration;
+        r->topic = source.topic;
+
+        int* ids = arena.allocateArray<int>(source.prereqIDs.size());
+        if (ids) std::memcpy(ids, source.prereqIDs.begin(), source.prereqIDs.size() * sizeof(int));
+        r->prereqIDs = IdList(ids, source.prereqIDs.size());
+
+        r->title = arena.copy(source.title);
+        r->url.prefix = source.url.prefix;
+        r->url.length = source.url.length;
+        r->url.rest = arena.copy(source.url.restText()).data();
+
+        count++;
+        return r;
+    }
+
+    /**
+     * Overwrites 'target' with the contents of 'source' (same ID), so a changed
+     * resource keeps its slot. Only a title, URL or prereq list that differs is
+     * copied into the arena; the old bytes stay valid for whoever still holds them.
+     */
+    void update(Resource* target, const Resource& source) {
+        target->difficulty = source.difficulty;
+        target->rating = source.rating;
+        target->duration = source.duration;
+        target->topic = source.topic;
+
+        if (target->prereqIDs != source.prereqIDs) {
+            int* ids = arena.allocateArray<int>(source.prereqIDs.size());
+            if (ids) std::memcpy(ids, source.prereqIDs.begin(), source.prereqIDs.size() * sizeof(int));
+            target->prereqIDs = IdList(ids, source.prereqIDs.size());
+        }
+        if (target->title != source.title) target->title = arena.copy(source.title);
+        if (target->url != source.url) {
+            target->url.prefix = source.url.prefix;
+            target->url.length = source.url.length;
+            target->url.rest = arena.copy(source.url.restText()).data();
+        }
+    }
+
+    /**
+     * Takes over everything 'other' allocated (it ends up empty). Used to
+     * combine the stores that parallel parser threads filled separately.
+     */
+    void absorb(ResourceStore& other) {
+        arena.absorb(other.arena);
+        count += other.count;
+        other.count = 0;
+    }
+
+    size_t size() const { return count; }
+    size_t bytesReserved() const { return arena.bytesReserved(); }
+    size_t blockCount() const { return arena.blockCount(); }
+};
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <string>
+#include "Engine.h"
+
+// =========================================================
+// SERVER MODULE
+// Responsibility: Keep one Engine alive and answer a stream of
+// framed requests, so per-query cost is the query itself and
+// not the CSV load + index build.
+//
+// Protocol (one request per line on stdin):
+//     <requestId> <COMMAND>          e.g. "7 SEARCH|Graph"
+// Response on stdout:
+//     ---RESPONSE <requestId>---
+//     ...normal command output...
+//     ---END_RESPONSE <requestId>|OK---      (or |ERROR)
+// A failed request says why in an "ERROR:<reason>" line of its output.
+// The line "---READY---" is printed once the engine is built.
+// A request whose command is QUIT closes the session.
+//
+// The same protocol is spoken over a Unix-domain socket by
+// serveSocket(): every connection gets its own Session (LRU cache,
+// history), requests run on a fixed worker pool against the one
+// shared Engine. Queries only read it; RELOAD swaps in catalog
+// changes atomically between requests.
+// =========================================================
+
+namespace Server {
+
+    /**
+     * Runs the request loop on stdin/stdout until EOF or QUIT.
+     * @param engine A fully constructed engine (built once, reused for every request).
+     * @return Process exit code.
+     */
+    int serveStdio(Engine& engine);
+
+    /**
+     * Listens on a Unix-domain socket and serves many clients at once (POSIX only).
+     * Runs until SIGINT/SIGTERM.
+     * @param workerCount Size of the worker pool; <= 0 means one per hardware thread.
+     * @return Process exit code.
+     */
+    int serveSocket(Engine& engine, const std::string& socketPath, int workerCount);
+
+    /**
+     * Executes one framed request line and writes the framed response to 'out'.
+     * @return false if the client asked to QUIT.
+     */
+    bool handleRequest(Engine& engine, Session& session, const std::string& line, std::ostream& out);
+
+    /**
+     * Splits a framed request line into its ID and command.
+     * @return false if the line has no request ID.
+     */
+    bool parseRequestLine(const std::string& line, std::string& requestId, std::string& command);
+
+}
+
+#endif
@@ -0,0 +1,203 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "Resource.h"
+#include "ResourceStore.h"
+#include "Trie.h"
+#include "NGramIndex.h"
+#include "TextIndex.h"
+#include "MappedFile.h"
+
+// =========================================================
+// SNAPSHOT MODULE
+// Responsibility: Serialize a fully built engine into one binary
+// file and map it back at startup, skipping CSV parsing and the
+// per-resource inserts in Engine::Engine.
+//
+// The file is position independent: every reference is a byte
+// offset from the start of the file. Layout:
+//     [Header + section table] [section 0] [section 1] ...
+// Sections are 8-byte aligned. A snapshot is rejected (and the
+// caller falls back to the CSV) if the magic/version differ, the
+// header checksum does not match, or the source CSV's size or
+// modification time changed since the snapshot was built.
+//
+// Opening checks only the header and section table; the payload
+// checksum runs only when verifying (right after a snapshot is
+// written, or --verify-snapshot). Startup still bounds-checks every
+// record and index reference as it loads them (Engine::loadSnapshot),
+// so a corrupted payload is rejected instead of read out of bounds.
+//
+// Only resource titles, URL suffixes and prereqs are used in place.
+// The index sections are copied into the engine's own vectors
+// (O(file size); startup takes ~0.75 s at 200K rows).
+// =========================================================
+
+namespace Snapshot {
+
+    const uint32_t kVersion = 8;
+
+    enum Section : uint32_t {
+        RESOURCES = 0,      // ResourceRecord[], sorted by ID
+        STRINGS,            // Title, URL suffix and dictionary bytes, referenced by offset
+        PREREQS,            // int32[] prereq IDs, referenced by offset
+        TOPICS,             // StringRef[] distinct topic names, referenced by index
+        URL_PREFIXES,       // StringRef[] distinct URL prefixes (see UrlRef), referenced by index
+        TRIE_NODES,         // FrozenTrieNode[] in preorder, plus a sentinel
+        TRIE_CHILD_KEYS,    // uint8[] first label byte of each child
+        TRIE_CHILD_NODES,   // uint32[] preorder index of each child
+        TRIE_IDS,           // int32[] owned by trie nodes, in preorder
+        TRIE_LABELS,        // Edge label bytes, referenced by FrozenTrieNode::labelOffset
+        TRIE_POSTING_OFFSETS, // uint32[] per trie node plus sentinel, into TRIE_POSTINGS
+        TRIE_POSTINGS,      // int32[] sorted, deduplicated subtree IDs of shallow nodes
+        TRIE_KEY_SCORES,    // float[] per trie node, completion ranking (see FrozenTrie::rankCompletions)
+        TRIE_KEY_BEST,      // int32[] per trie node, best-rated ID of the key
+        TRIE_COMPLETION_SLOTS, // uint32[] per trie node, into TRIE_COMPLETIONS or FrozenTrie::kNone
+        TRIE_COMPLETIONS,   // uint32[] top kTopCompletions key nodes per slot, best first
+        ADJ_OFFSETS,        // uint32[resourceCount + 1], CSR offsets into ADJ_TARGETS
+        ADJ_TARGETS,        // int32[] dependent IDs (edge prereq -> dependent)
+        ORDER_DIFFICULTY,   // uint32[] resource indices, LIST|DIFFICULTY order
+        ORDER_TOPIC,        // uint32[] resource indices, LIST|TOPIC order
+        HEAP_LAYOUT,        // uint32[] resource indices, rating MaxHeap array order
+        INFIX_GRAMS,        // uint32[] sorted trigrams of the CONTAINS index (rows = resource records)
+        INFIX_COUNTS,       // uint32[] postings per trigram
+        INFIX_SKIP_OFFSETS, // uint32[trigrams + 1], into INFIX_SKIPS
+        INFIX_SKIPS,        // NGramIndex::Skip[] per posting block
+        INFIX_DATA,         // uint8[] varint-encoded posting deltas
+        INFIX_TEXT,         // Lowercased text of every row (see NGramIndex)
+        INFIX_TEXT_OFFSETS, // uint32[resourceCount + 1], into INFIX_TEXT
+        TEXT_WORDS,         // Words of the RANK index, concatenated in term order (rows = resource records)
+        TEXT_WORD_OFFSETS,  // uint32[terms + 1], into TEXT_WORDS
+        TEXT_TERMS,         // TextIndex::Term[]
+        TEXT_SKIPS,         // TextIndex::Skip[] per posting block
+        TEXT_DATA,          // uint8[] varint-encoded (row delta, count) postings
+        TEXT_LENGTHS,       // uint16[resourceCount] words per row
+        TEXT_RATINGS,       // float[resourceCount]
+        TEXT_STATISTICS,    // double[3]: average row length, bound length, best rating
+        SECTION_COUNT
+    };
+
+    struct SectionEntry {
+        uint64_t offset;
+        uint64_t length;    // In bytes
+    };
+
+    struct Header {
+        char magic[8];              // "CCSNAP\0\0"
+        uint32_t version;
+        uint32_t endianTag;         // 0x01020304 as written by the producer
+        uint64_t sourceSize;        // Size of the CSV the snapshot was built from
+        int64_t sourceMtime;        // Its modification time (filesystem clock ticks)
+        uint64_t payloadSize;       // Bytes after the header
+        uint64_t payloadChecksum;   // FNV-1a 64 over the payload
+        uint64_t headerChecksum;    // FNV-1a 64 over the header, this field zeroed
+        uint32_t sectionCount;
+        uint32_t reserved;
+        SectionEntry sections[SECTION_COUNT];
+    };
+
+    struct StringRef {
+        uint32_t offset;            // Into STRINGS
+        uint32_t length;
+    };
+
+    struct ResourceRecord {
+        int32_t id;
+        int32_t difficulty;
+        int32_t duration;
+        uint32_t prereqCount;
+        double rating;
+        uint32_t titleOffset, titleLength;
+        uint32_t urlRestOffset, urlRestLength; // URL after its prefix
+        uint32_t urlPrefix;         // Index into URL_PREFIXES
+        uint32_t topic;             // Index into TOPICS
+        uint32_t prereqOffset;      // Index into PREREQS
+        uint32_t reserved;
+    };
+
+    // Identifies the CSV a snapshot was built from
+    struct SourceStamp {
+        uint64_t size;
+        int64_t mtime;
+    };
+
+    /**
+     * Reads size and modification time of a file.
+     * @return false if the file does not exist.
+     */
+    bool stampFile(const std::string& path, SourceStamp& stamp);
+
+    // Everything the engine needs, gathered by Engine::saveSnapshot
+    struct Contents {
+        std::vector<Resource*> resources;           // Sorted by ID
+        FrozenTrie trie;
+        std::vector<std::vector<int>> dependents;   // dependents[i]: IDs unlocked by resources[i]
+        std::vector<uint32_t> orderByDifficulty;
+        std::vector<uint32_t> orderByTopic;
+        std::vector<uint32_t> heapLayout;
+        NGramIndex::Arrays infix;                   // Built over 'resources', in that order
+        TextIndex::Arrays text;                     // Same
+    };
+
+    /**
+     * Writes a snapshot file.
+     * @return false on I/O error or if a section outgrows 32-bit offsets.
+     */
+    bool write(const std::string& path, const Contents& contents, const SourceStamp& source);
+
+    // A memory-mapped snapshot. Section accessors point straight into the mapping; the load* functions copy.
+    class Image {
+    private:
+        MappedFile file;
+        const Header* header;
+
+        template <typename T>
+        const T* section(Section s, size_t& count) const {
+            const SectionEntry& e = header->sections[s];
+            count = static_cast<size_t>(e.length / sizeof(T));
+            return reinterpret_cast<const T*>(file.data() + e.offset);
+        }
+
+    public:
+        Image() : header(nullptr) {}
+
+        /**
+         * Maps a snapshot and checks its header and section table.
+         * @param expected Stamp of the current CSV; a mismatch means the snapshot is stale.
+         * @param reason Filled with a short explanation when the snapshot is rejected.
+         * @param verify Also checksum the payload and check every record and index
+         * reference: O(file size), for a freshly written snapshot or an explicit check.
+         */
+        bool open(const std::string& path, const SourceStamp& expected, std::string& reason, bool verify = false);
+
+        size_t resourceCount() const;
+        /**
+         * Allocates a Resource per record in 'store', in record (ID) order. Titles, URL
+         * suffixes and prereqs are not copied: the image must stay open while they are used.
+         * @return false, with a reason, at the first record or dictionary entry that points
+         * outside its section (the resources made so far stay in 'store').
+         */
+        bool makeResources(ResourceStore& store, std::vector<Resource*>& out, std::string& reason) const;
+
+        // Copies the frozen trie arrays and their completion ranking
+        void loadTrie(FrozenTrie& out) const;
+        // Copies the CONTAINS index arrays; rows are the resource records
+        void loadInfixIndex(NGramIndex::Arrays& out) const;
+        // Copies the RANK index arrays; rows are the resource records
+        void loadTextIndex(TextIndex::Arrays& out) const;
+        const uint32_t* adjacencyOffsets(size_t& count) const { return section<uint32_t>(ADJ_OFFSETS, count); }
+        const int32_t* adjacencyTargets(size_t& count) const { return section<int32_t>(ADJ_TARGETS, count); }
+        const uint32_t* orderByDifficulty(size_t& count) const { return section<uint32_t>(ORDER_DIFFICULTY, count); }
+        const uint32_t* orderByTopic(size_t& count) const { return section<uint32_t>(ORDER_TOPIC, count); }
+        const uint32_t* heapLayout(size_t& count) const { return section<uint32_t>(HEAP_LAYOUT, count); }
+    };
+
+    // Default snapshot location for a CSV: same folder, ".ccsnap" extension
+    std::string defaultPathFor(const std::string& csvPath);
+
+}
+
+#endif
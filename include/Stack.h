@@ -3,50 +3,46 @@
 
 #include "Resource.h"
 #include <vector>
-#include <iostream>
+#include <sstream>
 #include <algorithm>
 #include <string>
+#include "Log.h"
 
 class Stack {
 private:
     std::vector<Resource*> items;
 
-    // Helper function to print the current state of the stack
-    void printStackState(const std::string& operation) const {
-        std::cout << "\n--- Stack State after " << operation << " (Size: " << items.size() << ") ---" << std::endl;
+    // Renders the current state of the stack for trace logging
+    std::string describeState(const std::string& operation) const {
+        std::ostringstream out;
+        out << "Stack State after " << operation << " (Size: " << items.size() << ")\n";
         if (items.empty()) {
-            std::cout << "Stack is empty." << std::endl;
+            out << "  Stack is empty.";
         } else {
             // Print from top to bottom (LIFO order)
-            std::cout << "  Top -> ";
+            out << "  Top -> ";
             for (auto it = items.rbegin(); it != items.rend(); ++it) {
-                std::cout << (*it)->title << " [" << (*it)->id << "] | ";
+                out << (*it)->title << " [" << (*it)->id << "] | ";
             }
-            std::cout << "Bottom" << std::endl;
+            out << "Bottom";
         }
-        std::cout << "----------------------------------------------------" << std::endl;
+        return out.str();
     }
 
 public:
-    void push(Resource* res, bool doPrint = true){
+    void push(Resource* res) {
         items.push_back(res);
-        if (doPrint) {
-            printStackState("PUSH (Resource ID: " + std::to_string(res->id) + ")");
-        }
+        CC_LOG_TRACE(describeState("PUSH (Resource ID: " + std::to_string(res->id) + ")"));
     }
 
-    Resource* pop(bool doPrint = true) {
+    Resource* pop() {
         if (items.empty()) {
-            if (doPrint) {
-                printStackState("POP (Stack Empty)");
-            }
+            CC_LOG_TRACE(describeState("POP (Stack Empty)"));
             return nullptr;
         }
         Resource* res = items.back();
         items.pop_back();
-        if (doPrint) {
-            printStackState("POP (Resource ID: " + std::to_string(res->id) + ")");
-        }
+        CC_LOG_TRACE(describeState("POP (Resource ID: " + std::to_string(res->id) + ")"));
         return res;
     }
 
@@ -61,6 +57,10 @@ public:
         return items.empty();
     }
 
+    int size() const {
+        return static_cast<int>(items.size());
+    }
+
     // Export structure for visualization
     std::vector<std::string> getStructure() {
         std::vector<std::string> result;
@@ -69,7 +69,7 @@ public:
         // Stack is LIFO, so we show from top (end) to bottom (start)
         for (int i = items.size() - 1; i >= 0; --i) {
             std::string nodeInfo = std::to_string(items[i]->id) + ":" + 
-                                  items[i]->title + ":" + 
+                                  std::string(items[i]->title) + ":" + 
                                   std::to_string(items.size() - 1 - i);
             result.push_back("ITEM:" + nodeInfo);
         }
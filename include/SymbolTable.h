@@ -0,0 +1,107 @@
+#ifndef SYMBOLTABLE_H
+#define SYMBOLTABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include "Arena.h"
+
+// =========================================================
+// SYMBOL TABLE (string interning)
+// Maps each distinct string to a small, dense integer ID, and
+// back. Strings are stored once; an ID stays valid (and its
+// name() stays at the same address) for the life of the process.
+//
+// ID 0 is always the empty string. intern() is safe to call from
+// several parser threads at once; name() takes no lock at all.
+// =========================================================
+
+class SymbolTable {
+private:
+    static const uint32_t kPageBits = 12;
+    static const uint32_t kPageSize = 1u << kPageBits;
+    static const uint32_t kMaxPages = 4096;     // 16M symbols
+
+    // Names live in fixed pages so a lookup never races with a growing vector
+    std::atomic<std::string_view*> pages[kMaxPages];
+    std::atomic<uint32_t> count;
+
+    mutable std::shared_mutex mutex;            // Guards ids and text
+    std::unordered_map<std::string_view, uint32_t> ids;
+    Arena text;
+
+    uint32_t add(std::string_view s) {
+        uint32_t id = count.load(std::memory_order_relaxed);
+        if (id >= kPageSize * kMaxPages) throw std::length_error("SymbolTable is full");
+        std::string_view* page = pages[id >> kPageBits].load(std::memory_order_relaxed);
+        if (!page) {
+            page = text.allocateArray<std::string_view>(kPageSize);
+            for (uint32_t i = 0; i < kPageSize; i++) new (page + i) std::string_view();
+            pages[id >> kPageBits].store(page, std::memory_order_release);
+        }
+        std::string_view stored = text.copy(s);
+        page[id & (kPageSize - 1)] = stored;
+        ids.emplace(stored, id);
+        count.store(id + 1, std::memory_order_release);
+        return id;
+    }
+
+public:
+    SymbolTable() : count(0) {
+        for (auto& page : pages) page.store(nullptr, std::memory_order_relaxed);
+        add(std::string_view());
+    }
+
+    SymbolTable(const SymbolTable&) = delete;
+    SymbolTable& operator=(const SymbolTable&) = delete;
+
+    /**
+     * ID of 's', adding it if it is new.
+     */
+    uint32_t intern(std::string_view s) {
+        if (s.empty()) return 0;
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            auto it = ids.find(s);
+            if (it != ids.end()) return it->second;
+        }
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        auto it = ids.find(s);
+        return it != ids.end() ? it->second : add(s);
+    }
+
+    /**
+     * ID of 's' without adding it.
+     * @return false if 's' was never interned.
+     */
+    bool find(std::string_view s, uint32_t& id) const {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto it = ids.find(s);
+        if (it == ids.end()) return false;
+        id = it->second;
+        return true;
+    }
+
+    std::string_view name(uint32_t id) const {
+        return pages[id >> kPageBits].load(std::memory_order_acquire)[id & (kPageSize - 1)];
+    }
+
+    size_t size() const { return count.load(std::memory_order_acquire); }
+
+    // Process-wide tables used by Resource
+    static SymbolTable& topics() {
+        static SymbolTable table;
+        return table;
+    }
+
+    static SymbolTable& urlPrefixes() {
+        static SymbolTable table;
+        return table;
+    }
+};
+
+#endif
@@ -0,0 +1,181 @@
+#ifndef TEXTINDEX_H
+#define TEXTINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "Resource.h"
+
+// =========================================================
+// TEXT INDEX
+// Responsibility: Rank resources for multi-word queries
+// ("graph shortest path") by BM25 over the words of their title
+// and topic, optionally plus a bonus for their rating.
+//
+// A word is a run of letters and digits, lowercased. Each word maps
+// to the rows containing it with the number of occurrences, ascending
+// by row: delta + varint encoded in blocks of kBlockSize postings,
+// with a skip entry per block (first and last row, byte offset,
+// best term-frequency weight in the block).
+//
+// topK() uses WAND: every word also stores the highest score any of
+// its rows can get from it. Cursors over the query's lists are kept
+// sorted by current row; a row is only scored when the bounds of the
+// lists at or before it could beat the k-th best score so far.
+// Otherwise the lagging cursors jump ahead via the skips, so rows
+// that match only weak words are never decoded, let alone scored.
+// The per-block bounds then rule out whole blocks the list-wide
+// bounds let through (block-max WAND), which matters for common
+// words and single-word queries.
+// Row i is the i-th resource of the list passed to build().
+//
+// Bounds are kept as term-frequency weights, computed for rows of
+// 'boundLength' words on average, and multiplied by the word's idf
+// when used. A row's weight only grows with the average (its length
+// counts for less), so bounds taken at boundLength stay upper bounds
+// while averageLength <= boundLength: update() (RELOAD) then
+// re-encodes only the lists of words the changed rows had or now
+// have, and recomputes idf per word. Only when the average outgrows
+// boundLength are every list's bounds recomputed, with headroom.
+// Snapshots store the arrays byte for byte, and loading copies them
+// back (see Snapshot::Image::loadTextIndex).
+// =========================================================
+
+class TextIndex {
+public:
+    static constexpr size_t kBlockSize = 128;
+    static constexpr double kK1 = 1.2;    // BM25 term frequency saturation
+    static constexpr double kB = 0.75;    // BM25 length normalization
+    static constexpr double kBoundHeadroom = 1.05; // boundLength over averageLength when bounds are redone
+
+    struct Hit {
+        uint32_t row;
+        double score;
+    };
+
+    // Work done by one query, for the ANALYSIS block
+    struct Stats {
+        size_t terms = 0;           // Query words found in the index
+        size_t postings = 0;        // Postings in their lists
+        size_t blocksDecoded = 0;
+        size_t blocksSkipped = 0;   // Candidate ranges dropped on block bounds alone
+        size_t scored = 0;          // Rows fully scored
+    };
+
+    struct Skip {
+        uint32_t firstRow;
+        uint32_t lastRow;
+        uint32_t offset;    // Into 'data'
+        float maxWeight;    // Best tfWeight() of the word in the block's rows at boundLength, rounded up
+    };
+
+    struct Term {
+        uint32_t count;         // Rows containing the word
+        uint32_t firstSkip;     // Into 'skips'
+        double idf;
+        double maxWeight;       // Best tfWeight() of the word in any row at boundLength
+        double maxScore;        // idf * maxWeight: bounds the word's BM25 contribution to any row
+    };
+
+    // The index without its rows, as stored in a snapshot. Terms are in list order.
+    struct Arrays {
+        std::vector<char> words;            // Every term's word
+        std::vector<uint32_t> wordOffsets;  // terms.size() + 1, into 'words'
+        std::vector<Term> terms;
+        std::vector<Skip> skips;
+        std::vector<uint8_t> data;
+        std::vector<uint16_t> lengths;
+        std::vector<float> ratings;
+        double averageLength = 0;
+        double boundLength = 0;
+        double maxRating = 0;
+    };
+
+private:
+    // Position in one word's list during topK()
+    struct Cursor {
+        const Term* term;
+        size_t block;
+        size_t pos;
+        uint32_t row;           // Current row, or UINT32_MAX once exhausted
+        std::vector<uint32_t> rows, freqs; // Decoded block
+    };
+
+    std::unordered_map<std::string, uint32_t> termIDs;
+    std::vector<Term> terms;                // Lists are laid out in 'data' in term order
+    std::vector<Skip> skips;
+    std::vector<uint8_t> data;
+    std::vector<uint16_t> lengths;  // Words per row
+    std::vector<float> ratings;
+    std::vector<Resource*> rows;
+    double averageLength = 0;
+    double boundLength = 0;         // Row length the bounds were computed for, >= averageLength
+    double maxRating = 0;
+
+    // BM25 weight of 'freq' occurrences in a row of 'length' words, rows averaging 'average' words
+    static double tfWeight(uint32_t freq, uint32_t length, double average);
+    // Encodes one word's rows (ascending) and their counts as the next list, with its bounds
+    void appendList(const std::vector<uint32_t>& listRows, const std::vector<uint32_t>& freqs);
+    // Recomputes the bounds of every block of 'term' for boundLength
+    void computeBounds(Term& term);
+    // Sets averageLength, maxRating and every idf/maxScore from lengths, ratings and counts
+    void computeStatistics();
+    void decodeBlock(const Term& term, size_t b, std::vector<uint32_t>& rowsOut, std::vector<uint32_t>& freqsOut) const;
+    // Block of c's list whose rows end at or after 'target' (the block count if none)
+    size_t blockFor(const Cursor& c, uint32_t target) const;
+    void seek(Cursor& c, uint32_t target, Stats& stats) const; // First row >= target
+    double termScore(const Term& term, uint32_t freq, uint32_t row) const;
+    // Distinct indexed words of 'query'
+    std::vector<const Term*> lookup(std::string_view query) const;
+
+public:
+    /**
+     * Indexes the title and topic words of every resource in 'list'. O(total text length).
+     */
+    void build(const std::vector<Resource*>& list);
+    /**
+     * Same rankings as build(list), reusing 'base' (built for the previous rows).
+     * @param changedRows Rows of 'list' whose resource differs from base's row, or is new.
+     * Rows of 'base' past the end of 'list' are dropped. Words are read from base's
+     * resources, so those of changed and dropped rows must still be alive.
+     */
+    void update(const TextIndex& base, const std::vector<Resource*>& list, const std::vector<uint32_t>& changedRows);
+    void clear();
+    // Swaps in other objects for the rows; list[i] must hold what row i was indexed with
+    void rebind(const std::vector<Resource*>& list) { rows = list; }
+    void swap(TextIndex& other);
+
+    size_t size() const { return rows.size(); }
+    size_t termCount() const { return terms.size(); }
+    size_t memoryUsage() const;
+    Resource* row(uint32_t i) const { return rows[i]; }
+
+    void exportArrays(Arrays& out) const;
+    /**
+     * Replaces the contents with arrays built for 'list' (e.g. from a snapshot).
+     * @return false, leaving the index empty, if they are not valid for a list of that size.
+     */
+    bool importArrays(Arrays&& in, const std::vector<Resource*>& list);
+    // Every offset, count and encoded posting in 'a' is in range, for 'rowCount' rows. O(index size).
+    static bool isValid(const Arrays& a, size_t rowCount);
+
+    // Lowercased words of 'text', in order
+    static std::vector<std::string> tokenize(std::string_view text);
+
+    /**
+     * The 'k' best rows for 'query', best first: BM25 over the query's distinct words,
+     * plus ratingWeight * rating. Ties keep catalog (row) order. Rows with no query word
+     * are never returned.
+     * @param stats If set, receives counters for this query.
+     */
+    void topK(std::string_view query, size_t k, double ratingWeight, std::vector<Hit>& out, Stats* stats = nullptr) const;
+
+    // Same result by scoring every row that has a query word (reference for tests and benchmarks)
+    void topKExhaustive(std::string_view query, size_t k, double ratingWeight, std::vector<Hit>& out,
+                        Stats* stats = nullptr) const;
+};
+
+#endif
@@ -3,21 +3,164 @@
 
 #include <vector>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <iostream>
 #include <utility>
+#include <cctype>
+#include <cstdint>
+#include <algorithm>
+#include <iterator>
+#include "Arena.h"
+#include "FrozenTrie.h"
+
+// =========================================================
+// RADIX (PATRICIA) TRIE
+// Path-compressed: a chain of single-child nodes collapses into
+// one edge whose label is a span of lowercased bytes. Every node
+// other than the root ends a key, branches, or both.
+//
+// Children are a small array sorted by the first byte of their
+// label, until a node passes kDenseFanout children; it then
+// switches to a 256-entry table indexed by that byte (the root
+// and the first level or two of a catalog).
+//
+// Label bytes live in the trie's own arena. A split only re-slices
+// the existing span; a merge after remove() copies the joined label
+// (the old bytes stay in the arena until the trie is destroyed).
+//
+// Once loading is done, freeze() packs the trie into a FrozenTrie
+// and frees the nodes. Lookups then run on the flat arrays; the
+// next insert() or remove() rebuilds the nodes first (thaw()).
+// =========================================================
 
 struct TrieNode {
-    std::unordered_map<char, TrieNode*> children;
+    std::string_view label;         // Lowercased edge label into this node (empty for the root)
     bool isEndOfWord;
-    std::vector<int> resourceIDs; // Stores IDs of resources matching this specific word
+    bool dense;                     // children: 256 slots indexed by byte, instead of sorted by keys
+    uint16_t childCount;
+    std::vector<unsigned char> keys; // Sparse form: first byte of each child's label, ascending
+    std::vector<TrieNode*> children;
+    std::vector<int> resourceIDs;   // Stores IDs of resources matching this specific word
+
+    TrieNode() : isEndOfWord(false), dense(false), childCount(0) {}
+};
 
-    TrieNode() : isEndOfWord(false) {}
+// One autocompletion: a stored key and its best-rated resource
+struct TrieCompletion {
+    std::string key;    // Lowercased, as stored
+    int bestID;
+    float rating;       // bestID's rating
+    uint32_t count;     // Resource IDs stored under the key
+};
+
+// One typo-tolerant match: a resource and the edits its key needed
+struct TrieFuzzyMatch {
+    int id;
+    uint32_t edits;
 };
 
 class Trie {
 private:
-    TrieNode* root;
+    static const size_t kDenseFanout = 16;
+
+    TrieNode* root;         // nullptr while frozen
+    int nodeCount;          // Including the root
+    unsigned long revision; // Bumped on every mutation
+    Arena labels;
+    FrozenTrie frozen;      // Filled while frozen
+
+    static unsigned char lower(char c) { return trieLower(c); }
+
+    static TrieNode* findChild(const TrieNode* node, unsigned char c) {
+        if (node->dense) return node->children[c];
+        // Sparse nodes hold at most kDenseFanout keys: a linear scan beats a binary search
+        for (size_t i = 0; i < node->keys.size(); i++) {
+            if (node->keys[i] == c) return node->children[i];
+            if (node->keys[i] > c) break;
+        }
+        return nullptr;
+    }
+
+    // Visits children in byte order
+    template <typename Visit>
+    static void forEachChild(const TrieNode* node, Visit visit) {
+        if (node->dense) {
+            for (TrieNode* child : node->children) {
+                if (child) visit(child);
+            }
+        } else {
+            for (TrieNode* child : node->children) visit(child);
+        }
+    }
+
+    static void addChild(TrieNode* node, TrieNode* child) {
+        unsigned char c = static_cast<unsigned char>(child->label[0]);
+        if (!node->dense && node->keys.size() >= kDenseFanout) {
+            std::vector<TrieNode*> table(256, nullptr);
+            for (size_t i = 0; i < node->keys.size(); i++) table[node->keys[i]] = node->children[i];
+            node->children.swap(table);
+            std::vector<unsigned char>().swap(node->keys);
+            node->dense = true;
+        }
+        if (node->dense) {
+            node->children[c] = child;
+        } else {
+            size_t at = std::lower_bound(node->keys.begin(), node->keys.end(), c) - node->keys.begin();
+            node->keys.insert(node->keys.begin() + at, c);
+            node->children.insert(node->children.begin() + at, child);
+        }
+        node->childCount++;
+    }
+
+    // Points the slot for the first byte of 'replacement's label at it (the byte is unchanged)
+    static void replaceChild(TrieNode* node, TrieNode* replacement) {
+        unsigned char c = static_cast<unsigned char>(replacement->label[0]);
+        if (node->dense) {
+            node->children[c] = replacement;
+            return;
+        }
+        for (size_t i = 0; i < node->keys.size(); i++) {
+            if (node->keys[i] == c) { node->children[i] = replacement; return; }
+        }
+    }
+
+    static void removeChild(TrieNode* node, unsigned char c) {
+        if (node->dense) {
+            node->children[c] = nullptr;
+        } else {
+            for (size_t i = 0; i < node->keys.size(); i++) {
+                if (node->keys[i] != c) continue;
+                node->keys.erase(node->keys.begin() + i);
+                node->children.erase(node->children.begin() + i);
+                break;
+            }
+        }
+        node->childCount--;
+    }
+
+    static TrieNode* onlyChild(const TrieNode* node) {
+        TrieNode* found = nullptr;
+        forEachChild(node, [&found](TrieNode* child) { found = child; });
+        return found;
+    }
+
+    // Folds the single child of a node that no longer ends a key into the node itself
+    void mergeWithOnlyChild(TrieNode* node) {
+        TrieNode* child = onlyChild(node);
+        std::string joined(node->label);
+        joined.append(child->label.data(), child->label.size());
+        node->label = labels.copy(joined);
+        node->isEndOfWord = child->isEndOfWord;
+        node->dense = child->dense;
+        node->childCount = child->childCount;
+        node->keys.swap(child->keys);
+        node->children.swap(child->children);
+        node->resourceIDs.swap(child->resourceIDs);
+        child->childCount = 0;
+        child->children.clear();
+        delete child;
+        nodeCount--;
+    }
 
     // Helper: DFS to collect all IDs in the subtree of a given node
     void collectAllIDs(TrieNode* node, std::vector<int>& results) {
@@ -29,75 +172,379 @@ private:
         }
 
         // Recurse to children
-        for (auto& pair : node->children) {
-            collectAllIDs(pair.second, results);
+        forEachChild(node, [this, &results](TrieNode* child) { collectAllIDs(child, results); });
+    }
+
+    void destroyRec(TrieNode* node) {
+        forEachChild(node, [this](TrieNode* child) { destroyRec(child); });
+        delete node;
+    }
+
+    // Appends 'node' and its subtree in preorder; returns the node's index
+    static uint32_t freezeRec(const TrieNode* node, FrozenTrie& out) {
+        uint32_t index = static_cast<uint32_t>(out.nodes.size());
+        FrozenTrieNode rec;
+        rec.labelOffset = static_cast<uint32_t>(out.labels.size());
+        rec.labelLength = static_cast<uint32_t>(node->label.size());
+        rec.firstChild = static_cast<uint32_t>(out.childKeys.size());
+        rec.childCount = node->childCount;
+        rec.idBegin = static_cast<uint32_t>(out.ids.size());
+        rec.subtreeEnd = 0;
+        out.nodes.push_back(rec);
+        out.labels.insert(out.labels.end(), node->label.begin(), node->label.end());
+        out.ids.insert(out.ids.end(), node->resourceIDs.begin(), node->resourceIDs.end());
+
+        // Reserve this node's child slots before the children append their own
+        out.childKeys.resize(rec.firstChild + rec.childCount);
+        out.childNodes.resize(rec.firstChild + rec.childCount);
+        uint32_t slot = rec.firstChild;
+        forEachChild(node, [&out, &slot](TrieNode* child) {
+            out.childKeys[slot] = static_cast<unsigned char>(child->label[0]);
+            uint32_t childIndex = freezeRec(child, out);
+            out.childNodes[slot++] = childIndex;
+        });
+        out.nodes[index].subtreeEnd = static_cast<uint32_t>(out.nodes.size());
+        return index;
+    }
+
+    void buildFrozen(FrozenTrie& out) const {
+        out = FrozenTrie();
+        out.nodes.reserve(nodeCount + 1);
+        freezeRec(root, out);
+        FrozenTrieNode sentinel = {static_cast<uint32_t>(out.labels.size()), 0, static_cast<uint32_t>(out.childKeys.size()),
+                                   0, static_cast<uint32_t>(out.ids.size()), static_cast<uint32_t>(out.nodes.size())};
+        out.nodes.push_back(sentinel);
+        out.childKeys.shrink_to_fit();
+        out.childNodes.shrink_to_fit();
+        out.ids.shrink_to_fit();
+        out.labels.shrink_to_fit();
+        out.materializePostings();
+    }
+
+    void thawRec(uint32_t index, TrieNode* node, std::string_view pool) {
+        const FrozenTrieNode& rec = frozen.nodes[index];
+        node->resourceIDs.assign(frozen.ids.begin() + rec.idBegin, frozen.ids.begin() + frozen.nodes[index + 1].idBegin);
+        node->isEndOfWord = !node->resourceIDs.empty();
+        if (rec.childCount <= kDenseFanout) node->keys.reserve(rec.childCount);
+        for (uint32_t k = 0; k < rec.childCount; k++) {
+            uint32_t childIndex = frozen.childNodes[rec.firstChild + k];
+            TrieNode* child = new TrieNode();
+            child->label = pool.substr(frozen.nodes[childIndex].labelOffset, frozen.nodes[childIndex].labelLength);
+            addChild(node, child);
+            thawRec(childIndex, child, pool);
+        }
+    }
+
+    void getFrozenStructureRec(uint32_t index, const std::string& path, std::vector<std::string>& edges, std::vector<std::string>& nodes) const {
+        const FrozenTrieNode& rec = frozen.nodes[index];
+        std::string nodeId = path.empty() ? "ROOT" : path;
+        nodes.push_back(nodeId + ":" + (frozen.endsWord(index) ? "1" : "0") + ":" +
+                        std::to_string(frozen.nodes[index + 1].idBegin - rec.idBegin));
+        for (uint32_t k = 0; k < rec.childCount; k++) {
+            uint32_t child = frozen.childNodes[rec.firstChild + k];
+            std::string label(frozen.label(child));
+            std::string childPath = path + label;
+            edges.push_back(nodeId + "->" + childPath + ":" + label);
+            getFrozenStructureRec(child, childPath, edges, nodes);
         }
     }
 
 public:
-    Trie() { root = new TrieNode(); }
+    Trie() : nodeCount(1), revision(0) { root = new TrieNode(); }
+    ~Trie() { if (root) destroyRec(root); }
+
+    Trie(const Trie&) = delete;
+    Trie& operator=(const Trie&) = delete;
 
     // Insert a Topic (e.g., "Binary Search") and link it to a Resource ID
-    void insert(std::string key, int id) {
+    void insert(std::string_view key, int id) {
+        if (!root) thaw();
         TrieNode* curr = root;
-        for (char c : key) {
-            c = tolower(c); // Case insensitive
-            if (curr->children.find(c) == curr->children.end()) {
-                curr->children[c] = new TrieNode();
+        size_t pos = 0;
+        while (pos < key.size()) {
+            TrieNode* child = findChild(curr, lower(key[pos]));
+            if (!child) {
+                // New leaf takes the rest of the key as its label
+                std::string rest(key.substr(pos));
+                for (char& c : rest) c = static_cast<char>(lower(c));
+                TrieNode* leaf = new TrieNode();
+                leaf->label = labels.copy(rest);
+                addChild(curr, leaf);
+                nodeCount++;
+                curr = leaf;
+                break;
+            }
+
+            size_t match = 0;
+            while (match < child->label.size() && pos + match < key.size() &&
+                   static_cast<unsigned char>(child->label[match]) == lower(key[pos + match])) {
+                match++;
+            }
+            if (match < child->label.size()) {
+                // Diverges (or ends) inside the label: split the edge at 'match'
+                TrieNode* middle = new TrieNode();
+                middle->label = child->label.substr(0, match);
+                child->label = child->label.substr(match);
+                replaceChild(curr, middle);
+                addChild(middle, child);
+                nodeCount++;
+                child = middle;
             }
-            curr = curr->children[c];
+            curr = child;
+            pos += match;
         }
         curr->isEndOfWord = true;
         curr->resourceIDs.push_back(id);
+        revision++;
     }
 
-    // The Feature You Requested: Get all IDs for a prefix (e.g., "Graph")
-    std::vector<int> getResourcesByPrefix(std::string prefix) {
+    // Unlinks one occurrence of 'id' from 'key' and prunes or re-merges nodes left empty. O(key length).
+    bool remove(std::string_view key, int id) {
+        if (!root) thaw();
+        TrieNode* parent = nullptr;
         TrieNode* curr = root;
+        size_t pos = 0;
+        while (pos < key.size()) {
+            TrieNode* child = findChild(curr, lower(key[pos]));
+            if (!child || child->label.size() > key.size() - pos) return false;
+            for (size_t i = 0; i < child->label.size(); i++) {
+                if (static_cast<unsigned char>(child->label[i]) != lower(key[pos + i])) return false;
+            }
+            parent = curr;
+            curr = child;
+            pos += child->label.size();
+        }
+
+        auto found = std::find(curr->resourceIDs.begin(), curr->resourceIDs.end(), id);
+        if (found == curr->resourceIDs.end()) return false;
+        curr->resourceIDs.erase(found);
+        if (curr->resourceIDs.empty()) curr->isEndOfWord = false;
+
+        // Restore the invariant: a non-root node either holds IDs or branches
+        if (curr != root && curr->resourceIDs.empty()) {
+            if (curr->childCount == 0) {
+                removeChild(parent, static_cast<unsigned char>(curr->label[0]));
+                delete curr;
+                nodeCount--;
+                if (parent != root && parent->resourceIDs.empty() && parent->childCount == 1) mergeWithOnlyChild(parent);
+            } else if (curr->childCount == 1) {
+                mergeWithOnlyChild(curr);
+            }
+        }
+        revision++;
+        return true;
+    }
+
+    // The Feature You Requested: Get all IDs for a prefix (e.g., "Graph"), ascending and without repeats
+    std::vector<int> getResourcesByPrefix(std::string_view prefix) {
         std::vector<int> results;
+        if (!root) {
+            // Frozen: one descent, then a copy of the node's posting list or ID slice
+            uint32_t node = frozen.locate(prefix);
+            if (node != FrozenTrie::kNone) frozen.collect(node, results);
+            return results;
+        }
+        TrieNode* curr = root;
 
-        // 1. Navigate to the end of the prefix
-        for (char c : prefix) {
-            c = tolower(c);
-            if (curr->children.find(c) == curr->children.end()) {
+        // 1. Navigate to the end of the prefix; it may end partway along an edge
+        size_t pos = 0;
+        while (pos < prefix.size()) {
+            TrieNode* child = findChild(curr, lower(prefix[pos]));
+            if (!child) {
                 return results; // Prefix not found
             }
-            curr = curr->children[c];
+            size_t span = std::min(child->label.size(), prefix.size() - pos);
+            for (size_t i = 1; i < span; i++) {
+                if (static_cast<unsigned char>(child->label[i]) != lower(prefix[pos + i])) return results;
+            }
+            curr = child;
+            pos += span;
         }
 
         // 2. Collect all IDs descending from this point
         collectAllIDs(curr, results);
+        std::sort(results.begin(), results.end());
+        results.erase(std::unique(results.begin(), results.end()), results.end());
         return results;
     }
 
-    // Export structure for visualization
+    /**
+     * A page of getResourcesByPrefix: up to 'limit' IDs greater than 'after', ascending.
+     * Frozen tries resume inside the prefix's posting list instead of rebuilding earlier pages.
+     * @param more Set to whether IDs remain after this page.
+     */
+    std::vector<int> getPageByPrefix(std::string_view prefix, int64_t after, size_t limit, bool& more) {
+        std::vector<int> page;
+        more = false;
+        if (!root) {
+            uint32_t node = frozen.locate(prefix);
+            if (node != FrozenTrie::kNone) more = frozen.collectPage(node, after, limit, page);
+            return page;
+        }
+        std::vector<int> all = getResourcesByPrefix(prefix);
+        auto from = std::upper_bound(all.begin(), all.end(), after, [](int64_t a, int id) { return a < id; });
+        size_t take = std::min<size_t>(limit, all.end() - from);
+        page.assign(from, from + take);
+        more = from + take != all.end();
+        return page;
+    }
+
+    // Export structure for visualization: node IDs are full paths, edges carry their whole label
     void getStructureRec(TrieNode* node, const std::string& path, std::vector<std::string>& edges, std::vector<std::string>& nodes) {
         if (!node) return;
-        
+
         std::string nodeId = path.empty() ? "ROOT" : path;
         std::string nodeInfo = nodeId + ":" + (node->isEndOfWord ? "1" : "0") + ":" + std::to_string(node->resourceIDs.size());
         nodes.push_back(nodeInfo);
-        
-        for (auto& pair : node->children) {
-            char c = pair.first;
-            std::string childPath = path + c;
-            edges.push_back(nodeId + "->" + childPath + ":" + c);
-            getStructureRec(pair.second, childPath, edges, nodes);
-        }
+
+        forEachChild(node, [&](TrieNode* child) {
+            std::string childPath = path + std::string(child->label);
+            edges.push_back(nodeId + "->" + childPath + ":" + std::string(child->label));
+            getStructureRec(child, childPath, edges, nodes);
+        });
     }
 
     std::pair<std::vector<std::string>, std::vector<std::string>> getStructure() {
         std::vector<std::string> edges;
         std::vector<std::string> nodes;
-        getStructureRec(root, "", edges, nodes);
+        if (root) getStructureRec(root, "", edges, nodes);
+        else getFrozenStructureRec(0, "", edges, nodes);
         return std::make_pair(edges, nodes);
     }
 
-    int getNodeCount() {
-        std::vector<std::string> edges, nodes;
-        getStructureRec(root, "", edges, nodes);
-        return nodes.size();
+    // Packs the trie into flat arrays and frees the nodes. Contents and revision are unchanged.
+    void freeze() {
+        if (!root) return;
+        buildFrozen(frozen);
+        destroyRec(root);
+        root = nullptr;
+        labels.release();
+    }
+
+    // Rebuilds the pointer nodes from the frozen arrays (insert/remove do this on demand)
+    void thaw() {
+        if (root) return;
+        std::string_view pool = labels.copy(std::string_view(frozen.labels.data(), frozen.labels.size()));
+        root = new TrieNode();
+        thawRec(0, root, pool);
+        frozen = FrozenTrie();
     }
+
+    bool isFrozen() const { return root == nullptr; }
+    bool isRanked() const { return root == nullptr && frozen.isRanked(); }
+
+    // Frozen form of the current contents, whether or not the trie is frozen (used by Snapshot)
+    void exportFrozen(FrozenTrie& out) const {
+        if (root) buildFrozen(out);
+        else out = frozen;
+    }
+
+    /**
+     * Replaces the contents with a frozen trie, e.g. one read from a snapshot. A ranked
+     * trie keeps its ranking; re-rank it (rankCompletions) if ratings have changed since.
+     * @param validate Reject malformed arrays. Only skip it for arrays already checked.
+     */
+    bool importFrozen(FrozenTrie&& in, bool validate = true) {
+        if (validate && !in.isValid()) return false;
+        if (root) destroyRec(root);
+        root = nullptr;
+        labels.release();
+        frozen = std::move(in);
+        nodeCount = static_cast<int>(frozen.nodeCount());
+        revision++;
+        return true;
+    }
+
+    /**
+     * Ranks keys for complete() by the best score among their resources (see FrozenTrie).
+     * @param scoreOf Rating of a resource ID.
+     * @return false if the trie is not frozen; a later thaw drops the ranking.
+     */
+    template <typename Score>
+    bool rankCompletions(Score scoreOf) {
+        if (root) return false;
+        frozen.rankCompletions(scoreOf);
+        return true;
+    }
+
+    // Best 'k' (at most FrozenTrie::kTopCompletions) distinct keys starting with 'prefix', best first.
+    // Empty unless frozen and ranked.
+    std::vector<TrieCompletion> complete(std::string_view prefix, size_t k) const {
+        std::vector<TrieCompletion> results;
+        if (root || !frozen.isRanked()) return results;
+        uint32_t node = frozen.locate(prefix);
+        if (node == FrozenTrie::kNone) return results;
+        std::vector<uint32_t> best;
+        frozen.topCompletions(node, k, best);
+        for (uint32_t key : best) {
+            results.push_back(TrieCompletion{frozen.keyOf(key), frozen.keyBest[key], frozen.keyScore[key], frozen.keyCount(key)});
+        }
+        return results;
+    }
+
+    /**
+     * Resources with a title or topic starting within 'maxEdits' (at most 2) edits of
+     * 'query', fewest edits first, then by ID; each ID once, with its fewest edits.
+     * A live trie is packed first, so serve this from a frozen one.
+     * @param limit Stop after this many results (0: all). Matched subtrees are only
+     * collected until the limit is filled, so the remaining edit counts cost nothing.
+     * @param rowsComputed If set, receives the automaton steps the walk took.
+     */
+    std::vector<TrieFuzzyMatch> fuzzySearch(std::string_view query, uint32_t maxEdits, size_t limit = 0,
+                                            size_t* rowsComputed = nullptr) const {
+        FrozenTrie packed;
+        if (root) buildFrozen(packed);
+        const FrozenTrie& trie = root ? packed : frozen;
+
+        std::vector<std::pair<uint32_t, uint32_t>> found; // (node, edits)
+        trie.fuzzyPrefix(query, maxEdits, found, rowsComputed);
+
+        // One edit count at a time: the union of its subtrees, minus IDs already matched with fewer edits
+        std::vector<TrieFuzzyMatch> results;
+        std::vector<int> seen, level, part, fresh;
+        for (uint32_t edits = 0; edits <= FrozenTrie::kMaxFuzzyEdits; edits++) {
+            if (limit > 0 && results.size() >= limit) break;
+            level.clear();
+            size_t nodesAtLevel = 0;
+            for (const auto& match : found) {
+                if (match.second != edits) continue;
+                trie.collect(match.first, part);
+                level.insert(level.end(), part.begin(), part.end());
+                nodesAtLevel++;
+            }
+            if (nodesAtLevel > 1) {
+                std::sort(level.begin(), level.end());
+                level.erase(std::unique(level.begin(), level.end()), level.end());
+            }
+            fresh.clear();
+            std::set_difference(level.begin(), level.end(), seen.begin(), seen.end(), std::back_inserter(fresh));
+            if (limit > 0 && fresh.size() > limit - results.size()) fresh.resize(limit - results.size()); // Lowest IDs
+            for (int id : fresh) results.push_back(TrieFuzzyMatch{id, edits});
+            size_t middle = seen.size();
+            seen.insert(seen.end(), fresh.begin(), fresh.end());
+            std::inplace_merge(seen.begin(), seen.begin() + middle, seen.end());
+        }
+        return results;
+    }
+
+    int getNodeCount() const { return nodeCount; }
+
+    // Approximate heap footprint: nodes, their arrays and the label arena (or the frozen arrays)
+    size_t getMemoryUsage() const {
+        if (!root) return frozen.memoryUsage();
+        size_t bytes = labels.bytesReserved();
+        std::vector<const TrieNode*> stack(1, root);
+        while (!stack.empty()) {
+            const TrieNode* node = stack.back();
+            stack.pop_back();
+            bytes += sizeof(TrieNode) + node->keys.capacity() + node->children.capacity() * sizeof(TrieNode*) +
+                     node->resourceIDs.capacity() * sizeof(int);
+            forEachChild(node, [&stack](TrieNode* child) { stack.push_back(child); });
+        }
+        return bytes;
+    }
+
+    unsigned long getRevision() const { return revision; }
 };
 
-#endif
\ No newline at end of file
+#endif
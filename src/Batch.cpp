@@ -0,0 +1,97 @@
+#include "../include/Batch.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <algorithm>
+
+namespace Batch {
+
+    namespace {
+        typedef std::chrono::steady_clock Clock;
+
+        long long microsSince(Clock::time_point start) {
+            return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+        }
+
+        // Nearest-rank percentile of an ascending list
+        long long percentile(const std::vector<long long>& sorted, double p) {
+            if (sorted.empty()) return 0;
+            size_t rank = static_cast<size_t>(p * sorted.size() + 0.999999);
+            if (rank == 0) rank = 1;
+            return sorted[std::min(rank, sorted.size()) - 1];
+        }
+    }
+
+    int run(const Engine& engine, std::istream& in, std::ostream& out) {
+        Clock::time_point batchStart = Clock::now();
+
+        // 1. Read the whole batch first so shared work can be grouped
+        std::vector<std::string> commands;
+        std::string line;
+        while (std::getline(in, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.empty() || line[0] == '#') continue;
+            commands.push_back(line);
+        }
+
+        // 2. Resolve prefixes, curricula and IDs once for the whole batch
+        Clock::time_point prepareStart = Clock::now();
+        PreparedLookups lookups;
+        engine.prepareBatch(commands, lookups);
+        long long prepareMicros = microsSince(prepareStart);
+
+        // 3. Execute in input order
+        Session session;
+        session.prepared = &lookups;
+
+        std::vector<long long> latencies;
+        latencies.reserve(commands.size());
+        std::map<std::string, int> actionCounts;
+        int failures = 0;
+
+        for (size_t i = 0; i < commands.size(); i++) {
+            const std::string& command = commands[i];
+            actionCounts[command.substr(0, command.find('|'))]++;
+
+            out << "---COMMAND " << (i + 1) << "|" << command << "---\n";
+            Clock::time_point start = Clock::now();
+            bool ok = engine.execute(command, session, out);
+            long long micros = microsSince(start);
+            out << "---END_COMMAND " << (i + 1) << (ok ? "|OK|" : "|ERROR|") << micros << "---\n";
+
+            latencies.push_back(micros);
+            if (!ok) failures++;
+        }
+
+        // 4. Aggregate timing summary
+        long long totalMicros = microsSince(batchStart);
+        std::sort(latencies.begin(), latencies.end());
+        long long sum = 0;
+        for (long long l : latencies) sum += l;
+
+        out << "---BATCH_SUMMARY---\n";
+        out << "COMMANDS:" << commands.size() << "\n";
+        for (const auto& entry : actionCounts) {
+            out << "ACTION:" << entry.first << "|" << entry.second << "\n";
+        }
+        out << "FAILED:" << failures << "\n";
+        out << "PREPARED_PREFIXES:" << lookups.prefixResults.size() << "\n";
+        out << "PREPARED_IDS:" << lookups.resources.size() << "\n";
+        out << "PREPARE_US:" << prepareMicros << "\n";
+        out << "TOTAL_US:" << totalMicros << "\n";
+        out << "LATENCY_AVG_US:" << (latencies.empty() ? 0 : sum / static_cast<long long>(latencies.size())) << "\n";
+        out << "LATENCY_P50_US:" << percentile(latencies, 0.50) << "\n";
+        out << "LATENCY_P95_US:" << percentile(latencies, 0.95) << "\n";
+        out << "LATENCY_P99_US:" << percentile(latencies, 0.99) << "\n";
+        out << "LATENCY_MAX_US:" << (latencies.empty() ? 0 : latencies.back()) << "\n";
+        if (totalMicros > 0) {
+            out << "THROUGHPUT_PER_SEC:" << (commands.size() * 1000000ULL / totalMicros) << "\n";
+        }
+        out << "---END_BATCH_SUMMARY---\n";
+        out.flush();
+
+        return failures == 0 ? 0 : 2;
+    }
+
+}
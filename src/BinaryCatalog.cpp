@@ -0,0 +1,383 @@
+#include "../include/BinaryCatalog.h"
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+#include <filesystem>
+#include <unordered_map>
+#include "../include/Log.h"
+
+namespace BinaryCatalog {
+
+    namespace {
+        const char kMagic[8] = {'C', 'C', 'B', 'C', 'A', 'T', '\0', '\0'};
+        const uint32_t kEndianTag = 0x01020304u;
+
+        uint64_t fnv1a(const char* data, size_t length, uint64_t hash = 1469598103934665603ull) {
+            for (size_t i = 0; i < length; i++) {
+                hash ^= static_cast<unsigned char>(data[i]);
+                hash *= 1099511628211ull;
+            }
+            return hash;
+        }
+
+        uint64_t zigzag(int64_t v) { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+        int64_t unzigzag(uint64_t v) { return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1); }
+
+        void putVarint(std::string& out, uint64_t v) {
+            while (v >= 0x80) {
+                out.push_back(static_cast<char>((v & 0x7F) | 0x80));
+                v >>= 7;
+            }
+            out.push_back(static_cast<char>(v));
+        }
+
+        void putString(std::string& out, std::string_view s) {
+            putVarint(out, s.size());
+            out.append(s.data(), s.size());
+        }
+
+        // Ratings like 4.5 become 450 (tag bit 0); anything else is stored raw (tag bit 1)
+        void putRating(std::string& out, double rating) {
+            double scaled = std::round(rating * 100.0);
+            if (std::fabs(scaled) < 1e15 && scaled / 100.0 == rating) {
+                putVarint(out, zigzag(static_cast<int64_t>(scaled)) << 1);
+            } else {
+                putVarint(out, 1);
+                out.append(reinterpret_cast<const char*>(&rating), sizeof(rating));
+            }
+        }
+
+        // Bounds-checked decoder over one block or dictionary; any overrun sets 'failed'
+        struct Cursor {
+            const char* p;
+            const char* end;
+            bool failed;
+
+            Cursor(const char* data, size_t size) : p(data), end(data + size), failed(false) {}
+
+            uint64_t varint() {
+                uint64_t v = 0;
+                for (int shift = 0; shift < 64; shift += 7) {
+                    if (p >= end) break;
+                    unsigned char byte = static_cast<unsigned char>(*p++);
+                    v |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                    if (!(byte & 0x80)) return v;
+                }
+                failed = true;
+                return 0;
+            }
+
+            int64_t signedVarint() { return unzigzag(varint()); }
+
+            std::string_view string() {
+                uint64_t n = varint();
+                if (failed || n > static_cast<uint64_t>(end - p)) { failed = true; return std::string_view(); }
+                std::string_view s(p, static_cast<size_t>(n));
+                p += n;
+                return s;
+            }
+
+            double rating() {
+                uint64_t tagged = varint();
+                if (!(tagged & 1)) return static_cast<double>(unzigzag(tagged >> 1)) / 100.0;
+                double raw = 0;
+                if (static_cast<size_t>(end - p) < sizeof(raw)) { failed = true; return 0; }
+                std::memcpy(&raw, p, sizeof(raw));
+                p += sizeof(raw);
+                return raw;
+            }
+        };
+
+        bool fitsInt(int64_t v) { return v >= INT32_MIN && v <= INT32_MAX; }
+    }
+
+    bool write(const std::string& path, const std::vector<Resource*>& resources, uint32_t recordsPerBlock) {
+        if (recordsPerBlock == 0) recordsPerBlock = kDefaultRecordsPerBlock;
+
+        // 1. Dictionaries, in order of first use (keyed by the process-wide interned IDs)
+        std::unordered_map<uint32_t, uint32_t> topicSlot, prefixSlot;
+        std::string topicDictionary, prefixDictionary;
+        for (const Resource* r : resources) {
+            if (topicSlot.emplace(r->topic.id, static_cast<uint32_t>(topicSlot.size())).second) {
+                putString(topicDictionary, r->topic.name());
+            }
+            if (prefixSlot.emplace(r->url.prefix, static_cast<uint32_t>(prefixSlot.size())).second) {
+                putString(prefixDictionary, r->url.prefixText());
+            }
+        }
+
+        // 2. Blocks
+        std::vector<BlockEntry> index;
+        std::string blocks, block;
+        uint64_t blockStart = sizeof(Header) + topicDictionary.size() + prefixDictionary.size();
+        for (size_t first = 0; first < resources.size(); first += recordsPerBlock) {
+            size_t last = std::min(resources.size(), first + recordsPerBlock);
+            block.clear();
+            BlockEntry entry;
+            std::memset(&entry, 0, sizeof(entry));
+            entry.minID = resources[first]->id;
+            entry.maxID = resources[first]->id;
+
+            int64_t previousID = 0; // Reset per block so blocks decode independently
+            for (size_t i = first; i < last; i++) {
+                const Resource* r = resources[i];
+                putVarint(block, zigzag(static_cast<int64_t>(r->id) - previousID));
+                previousID = r->id;
+                putString(block, r->title);
+                putVarint(block, topicSlot[r->topic.id]);
+                putVarint(block, prefixSlot[r->url.prefix]);
+                putString(block, r->url.restText());
+                putVarint(block, zigzag(r->difficulty));
+                putRating(block, r->rating);
+                putVarint(block, zigzag(r->duration));
+                putVarint(block, r->prereqIDs.size());
+                int64_t previousPrereq = r->id;
+                for (int pre : r->prereqIDs) {
+                    putVarint(block, zigzag(static_cast<int64_t>(pre) - previousPrereq));
+                    previousPrereq = pre;
+                }
+                entry.minID = std::min(entry.minID, r->id);
+                entry.maxID = std::max(entry.maxID, r->id);
+            }
+            if (block.size() > 0xFFFFFFFFull) return false;
+
+            entry.offset = blockStart + blocks.size();
+            entry.length = static_cast<uint32_t>(block.size());
+            entry.count = static_cast<uint32_t>(last - first);
+            entry.checksum = fnv1a(block.data(), block.size());
+            index.push_back(entry);
+            blocks += block;
+        }
+
+        // Index entries hold 64-bit fields and are read in place, so align them
+        while ((blockStart + blocks.size()) % 8 != 0) blocks.push_back('\0');
+
+        // 3. Header
+        Header header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.endianTag = kEndianTag;
+        header.resourceCount = resources.size();
+        header.blockCount = static_cast<uint32_t>(index.size());
+        header.recordsPerBlock = recordsPerBlock;
+        header.topicCount = static_cast<uint32_t>(topicSlot.size());
+        header.prefixCount = static_cast<uint32_t>(prefixSlot.size());
+        header.dictionaryOffset = sizeof(Header);
+        header.dictionaryLength = topicDictionary.size() + prefixDictionary.size();
+        header.indexOffset = blockStart + blocks.size();
+        uint64_t checksum = fnv1a(topicDictionary.data(), topicDictionary.size());
+        checksum = fnv1a(prefixDictionary.data(), prefixDictionary.size(), checksum);
+        header.metaChecksum = fnv1a(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(BlockEntry), checksum);
+
+        // 4. Write to a temp file and rename, like Snapshot::write
+        std::string tmpPath = path + ".tmp";
+        {
+            std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+            if (!out.is_open()) return false;
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(topicDictionary.data(), topicDictionary.size());
+            out.write(prefixDictionary.data(), prefixDictionary.size());
+            out.write(blocks.data(), blocks.size());
+            out.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(BlockEntry));
+            if (!out.good()) return false;
+        }
+        std::error_code ec;
+        std::filesystem::rename(tmpPath, path, ec);
+        return !ec;
+    }
+
+    bool isBinaryCatalog(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        char magic[sizeof(kMagic)];
+        return in.read(magic, sizeof(magic)) && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+    }
+
+    std::string defaultPathFor(const std::string& csvPath) {
+        std::filesystem::path p(csvPath);
+        p.replace_extension(".ccbin");
+        return p.string();
+    }
+
+    bool Reader::open(const std::string& path, std::string& reason) {
+        header = nullptr;
+        index = nullptr;
+        topics.clear();
+        prefixes.clear();
+        prefixText.clear();
+        if (!file.open(path)) { reason = "not found"; return false; }
+
+        if (file.size() < sizeof(Header)) { reason = "truncated header"; return false; }
+        const Header* h = reinterpret_cast<const Header*>(file.data());
+        if (std::memcmp(h->magic, kMagic, sizeof(kMagic)) != 0) { reason = "bad magic"; return false; }
+        if (h->endianTag != kEndianTag) { reason = "endianness mismatch"; return false; }
+        if (h->version != kVersion) { reason = "version mismatch"; return false; }
+
+        uint64_t indexBytes = static_cast<uint64_t>(h->blockCount) * sizeof(BlockEntry);
+        if (h->dictionaryOffset != sizeof(Header) || h->dictionaryLength > file.size() - sizeof(Header) ||
+            h->indexOffset % 8 != 0 || h->indexOffset > file.size() || indexBytes != file.size() - h->indexOffset ||
+            h->indexOffset < h->dictionaryOffset + h->dictionaryLength) {
+            reason = "bad layout";
+            return false;
+        }
+        const char* dictionary = file.data() + h->dictionaryOffset;
+        const BlockEntry* entries = reinterpret_cast<const BlockEntry*>(file.data() + h->indexOffset);
+        uint64_t checksum = fnv1a(dictionary, h->dictionaryLength);
+        if (fnv1a(reinterpret_cast<const char*>(entries), indexBytes, checksum) != h->metaChecksum) {
+            reason = "checksum mismatch";
+            return false;
+        }
+
+        // Dictionaries: intern once here, so decoding a record never hashes a string
+        Cursor cursor(dictionary, h->dictionaryLength);
+        for (uint32_t i = 0; i < h->topicCount && !cursor.failed; i++) topics.push_back(Topic(cursor.string()));
+        for (uint32_t i = 0; i < h->prefixCount && !cursor.failed; i++) {
+            std::string_view text = cursor.string();
+            prefixes.push_back(SymbolTable::urlPrefixes().intern(text));
+            prefixText.push_back(text);
+        }
+        if (cursor.failed || cursor.p != cursor.end) { reason = "bad dictionary"; return false; }
+
+        uint64_t records = 0;
+        uint64_t blocksStart = h->dictionaryOffset + h->dictionaryLength;
+        for (uint32_t i = 0; i < h->blockCount; i++) {
+            const BlockEntry& e = entries[i];
+            if (e.offset < blocksStart || e.offset > h->indexOffset || e.length > h->indexOffset - e.offset ||
+                e.minID > e.maxID) {
+                reason = "bad block index";
+                return false;
+            }
+            records += e.count;
+        }
+        if (records != h->resourceCount) { reason = "bad block index"; return false; }
+
+        header = h;
+        index = entries;
+        return true;
+    }
+
+    bool Reader::readBlock(size_t i, std::vector<Resource*>& out, ResourceStore* store) const {
+        if (!header || i >= header->blockCount) return false;
+        const BlockEntry& e = index[i];
+        const char* data = file.data() + e.offset;
+        if (fnv1a(data, e.length) != e.checksum) {
+            CC_LOG_ERROR("Binary catalog block " << i << ": checksum mismatch");
+            return false;
+        }
+
+        std::vector<Resource*> decoded;
+        decoded.reserve(e.count);
+        std::vector<int> prereqs;
+        std::string url;
+        Cursor cursor(data, e.length);
+        int64_t previousID = 0;
+        for (uint32_t n = 0; n < e.count && !cursor.failed; n++) {
+            int64_t id = previousID + cursor.signedVarint();
+            previousID = id;
+            std::string_view title = cursor.string();
+            uint64_t topic = cursor.varint();
+            uint64_t prefix = cursor.varint();
+            std::string_view rest = cursor.string();
+            int64_t difficulty = cursor.signedVarint();
+            double rating = cursor.rating();
+            int64_t duration = cursor.signedVarint();
+            uint64_t prereqCount = cursor.varint();
+            if (cursor.failed || topic >= topics.size() || prefix >= prefixes.size() || !fitsInt(id) ||
+                !fitsInt(difficulty) || !fitsInt(duration) || prereqCount > static_cast<uint64_t>(cursor.end - cursor.p)) {
+                cursor.failed = true;
+                break;
+            }
+            prereqs.clear();
+            int64_t previousPrereq = id;
+            for (uint64_t k = 0; k < prereqCount; k++) {
+                previousPrereq += cursor.signedVarint();
+                if (!fitsInt(previousPrereq)) cursor.failed = true;
+                prereqs.push_back(static_cast<int>(previousPrereq));
+            }
+            if (cursor.failed) break;
+
+            if (store) {
+                decoded.push_back(store->create(static_cast<int>(id), title, prefixes[prefix], rest, topics[topic],
+                                                static_cast<int>(difficulty), rating, prereqs.data(), prereqs.size(),
+                                                static_cast<int>(duration)));
+            } else {
+                url.assign(prefixText[prefix]);
+                url.append(rest.data(), rest.size());
+                decoded.push_back(new Resource(static_cast<int>(id), title, url, topics[topic].name(),
+                                               static_cast<int>(difficulty), rating, prereqs, static_cast<int>(duration)));
+            }
+        }
+
+        if (cursor.failed || decoded.size() != e.count || cursor.p != cursor.end) {
+            CC_LOG_ERROR("Binary catalog block " << i << ": corrupt record data");
+            if (!store) for (Resource* r : decoded) delete r;
+            return false;
+        }
+        out.insert(out.end(), decoded.begin(), decoded.end());
+        return true;
+    }
+
+    bool Reader::readAll(std::vector<Resource*>& out, ResourceStore* store) const {
+        std::vector<Resource*> all;
+        all.reserve(resourceCount());
+        for (size_t i = 0; i < blockCount(); i++) {
+            if (!readBlock(i, all, store)) {
+                if (!store) for (Resource* r : all) delete r;
+                return false;
+            }
+        }
+        out.insert(out.end(), all.begin(), all.end());
+        return true;
+    }
+
+    bool Reader::readRange(int minID, int maxID, std::vector<Resource*>& out, ResourceStore* store) const {
+        std::vector<Resource*> block;
+        for (size_t i = 0; i < blockCount(); i++) {
+            if (index[i].maxID < minID || index[i].minID > maxID) continue;
+            block.clear();
+            if (!readBlock(i, block, store)) return false;
+            for (Resource* r : block) {
+                if (r->id >= minID && r->id <= maxID) out.push_back(r);
+                else if (!store) delete r;
+            }
+        }
+        return true;
+    }
+
+    std::vector<Resource*> loadResources(const std::string& path, ResourceStore* store) {
+        std::vector<Resource*> resources;
+        Reader reader;
+        std::string reason;
+        if (!reader.open(path, reason)) {
+            CC_LOG_ERROR("Could not open binary catalog " << path << " (" << reason << ")");
+            return resources;
+        }
+        reader.readAll(resources, store);
+        return resources;
+    }
+
+    bool streamResources(const std::string& path, const std::function<void(std::vector<Resource*>&)>& sink,
+                         ResourceStore* store, size_t* delivered) {
+        size_t count = 0;
+        if (delivered) *delivered = 0;
+        Reader reader;
+        std::string reason;
+        if (!reader.open(path, reason)) {
+            CC_LOG_ERROR("Could not open binary catalog " << path << " (" << reason << ")");
+            return false;
+        }
+        std::vector<Resource*> batch;
+        for (size_t i = 0; i < reader.blockCount(); i++) {
+            batch.clear();
+            if (!reader.readBlock(i, batch, store)) {
+                CC_LOG_ERROR("Binary catalog " << path << ": block " << i << " is corrupt");
+                break;
+            }
+            count += batch.size();
+            if (delivered) *delivered = count;
+            if (!batch.empty()) sink(batch);
+        }
+        return count == reader.resourceCount();
+    }
+}
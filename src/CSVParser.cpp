@@ -1,10 +1,468 @@
 #include "CSVParser.h"
 #include <fstream>   // For file handling
 #include <sstream>   // For string stream processing
-#include <iostream>  // For error logging
+#include <string_view>
+#include <charconv>  // For std::from_chars (no exceptions, no locale)
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <atomic>
+#include <queue>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include "MappedFile.h"
+#include "CSVScan.h"
+#include "Log.h"     // For error logging
 
 namespace CSVParser {
 
+    namespace {
+
+        const size_t kColumns = 8; // ID,Title,URL,Topic,Difficulty,Rating,Prereqs,Duration
+
+        // One field of a record, pointing into the input buffer. Quoted fields are
+        // stored without their surrounding quotes; 'escaped' means it still holds "" pairs.
+        struct Field {
+            std::string_view text;
+            bool escaped;
+        };
+
+        enum RecordStatus { RECORD_OK, RECORD_UNTERMINATED_QUOTE, RECORD_BAD_QUOTE };
+
+        /**
+         * Splits the record starting at 'pos' into fields and moves 'pos' past its
+         * line terminator (\n or \r\n). 'lines' receives the number of physical
+         * lines the record used, since quoted fields may contain line breaks.
+         * Delimiters and quotes are located through the scanner's bitmaps.
+         */
+        RecordStatus splitRecord(const char* data, size_t size, CSVScan::Cursor& scan, size_t& pos,
+                                 std::vector<Field>& fields, size_t& lines) {
+            fields.clear();
+            lines = 1;
+            RecordStatus status = RECORD_OK;
+
+            while (true) {
+                Field field = {std::string_view(), false};
+
+                if (pos < size && data[pos] == '"') {
+                    size_t start = ++pos;
+                    while (true) {
+                        size_t at = scan.next(pos, CSVScan::MASK_QUOTE);
+                        if (at == size) {
+                            lines += std::count(data + start, data + size, '\n');
+                            field.text = std::string_view(data + start, size - start);
+                            fields.push_back(field);
+                            pos = size;
+                            return RECORD_UNTERMINATED_QUOTE;
+                        }
+                        if (at + 1 < size && data[at + 1] == '"') { // "" is an escaped quote
+                            field.escaped = true;
+                            pos = at + 2;
+                            continue;
+                        }
+                        lines += std::count(data + start, data + at, '\n');
+                        field.text = std::string_view(data + start, at - start);
+                        pos = at + 1;
+                        break;
+                    }
+                    // Only a delimiter or the end of the line may follow the closing quote
+                    if (pos < size && data[pos] != ',' && data[pos] != '\n' && data[pos] != '\r') {
+                        status = RECORD_BAD_QUOTE;
+                        pos = scan.next(pos, CSVScan::MASK_FIELD_END);
+                    }
+                } else {
+                    size_t start = pos;
+                    pos = scan.next(pos, CSVScan::MASK_FIELD_END);
+                    size_t end = pos;
+                    if (end > start && data[end - 1] == '\r' && (end == size || data[end] == '\n')) end--;
+                    field.text = std::string_view(data + start, end - start);
+                }
+                fields.push_back(field);
+
+                if (pos >= size) return status;
+                char c = data[pos++];
+                if (c == ',') continue;
+                if (c == '\r' && pos < size && data[pos] == '\n') pos++;
+                return status;
+            }
+        }
+
+        // Field text with "" pairs collapsed; 'scratch' holds the result when that means a copy
+        std::string_view unescape(const Field& field, std::string& scratch) {
+            if (!field.escaped) return field.text;
+            scratch.clear();
+            scratch.reserve(field.text.size());
+            for (size_t i = 0; i < field.text.size(); i++) {
+                scratch += field.text[i];
+                if (field.text[i] == '"') i++; // Skip the second quote of a pair
+            }
+            return scratch;
+        }
+
+        std::string_view trim(std::string_view s) {
+            while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+            while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) s.remove_suffix(1);
+            return s;
+        }
+
+        // The whole (trimmed) field must be a number; from_chars never throws
+        template <typename T>
+        bool parseNumber(std::string_view text, T& value) {
+            text = trim(text);
+            if (text.empty()) return false;
+            const char* end = text.data() + text.size();
+            auto result = std::from_chars(text.data(), end, value);
+            return result.ec == std::errc() && result.ptr == end;
+        }
+
+        // "101;102" -> {101, 102}. Bad entries are logged and skipped, like the stream loader.
+        // 'text' points into the scanned buffer, so separators come from the same bitmaps.
+        void parsePrereqList(const char* data, CSVScan::Cursor& scan, std::string_view text,
+                             const std::string& sourceName, size_t line, std::vector<int>& ids) {
+            ids.clear();
+            size_t pos = static_cast<size_t>(text.data() - data);
+            size_t end = pos + text.size();
+            while (pos < end) {
+                size_t semi = scan.next(pos, CSVScan::MASK_SEMICOLON, end);
+                std::string_view segment(data + pos, semi - pos);
+                if (!trim(segment).empty()) {
+                    int id;
+                    if (parseNumber(segment, id)) ids.push_back(id);
+                    else CC_LOG_WARN(sourceName << ":" << line << ": could not parse prereq ID: " << segment);
+                }
+                pos = semi + 1;
+            }
+        }
+    }
+
+    namespace {
+
+        // Incremental parser over one buffer: read() can be called repeatedly,
+        // each call appending up to 'maxRows' resources (see streamResources)
+        class RecordReader {
+        private:
+            const char* data;
+            size_t size;
+            const std::string& sourceName;
+            ResourceStore* store;   // nullptr: standalone heap Resources
+            CSVScan::Cursor scan;
+            std::vector<Field> fields;
+            std::vector<int> prereqs;
+            std::string scratch[3]; // Unescaped title, URL, topic
+            size_t pos, line, rejected;
+            bool header;
+
+        public:
+            RecordReader(const char* d, size_t n, const std::string& source, size_t firstLine, bool skipHeader,
+                         ResourceStore* target)
+                : data(d), size(n), sourceName(source), store(target), scan(d, n),
+                  pos(0), line(firstLine), rejected(0), header(skipHeader) {
+                fields.reserve(kColumns + 1);
+            }
+
+            bool done() const { return pos >= size; }
+            size_t rejectedRows() const { return rejected; }
+
+            size_t read(std::vector<Resource*>& out, size_t maxRows) {
+                static const char* const columnNames[kColumns] = {
+                    "ID", "Title", "URL", "Topic", "Difficulty", "Rating", "Prereqs", "Duration"
+                };
+
+                size_t added = 0;
+                while (pos < size && added < maxRows) {
+                    size_t recordLine = line, lines;
+                    RecordStatus status = splitRecord(data, size, scan, pos, fields, lines);
+                    line += lines;
+
+                    if (header) { header = false; continue; }
+                    if (status == RECORD_OK && fields.size() == 1 && fields[0].text.empty()) continue; // Blank line
+
+                    // Validate the whole row first, so a bad row allocates nothing
+                    std::string problem;
+                    int id = 0, difficulty = 0, duration = 0;
+                    double rating = 0.0;
+                    if (status == RECORD_UNTERMINATED_QUOTE) {
+                        problem = "unterminated quoted field";
+                    } else if (status == RECORD_BAD_QUOTE) {
+                        problem = "unexpected character after closing quote";
+                    } else if (fields.size() < kColumns) {
+                        problem = "expected " + std::to_string(kColumns) + " fields, found " + std::to_string(fields.size());
+                    } else {
+                        int bad = -1;
+                        if (!parseNumber(fields[0].text, id)) bad = 0;
+                        else if (!parseNumber(fields[4].text, difficulty)) bad = 4;
+                        else if (!parseNumber(fields[5].text, rating)) bad = 5;
+                        else if (!parseNumber(fields[7].text, duration)) bad = 7;
+                        if (bad >= 0) {
+                            problem = std::string("bad ") + columnNames[bad] + " value \"" + std::string(fields[bad].text) + "\"";
+                        }
+                    }
+                    if (!problem.empty()) {
+                        CC_LOG_WARN(sourceName << ":" << recordLine << ": " << problem << " (row skipped)");
+                        rejected++;
+                        continue;
+                    }
+
+                    std::string_view title = unescape(fields[1], scratch[0]);
+                    std::string_view url = unescape(fields[2], scratch[1]);
+                    std::string_view topic = unescape(fields[3], scratch[2]);
+                    parsePrereqList(data, scan, fields[6].text, sourceName, recordLine, prereqs);
+                    if (store) {
+                        out.push_back(store->create(id, title, url, topic, difficulty, rating,
+                                                    prereqs.data(), prereqs.size(), duration));
+                    } else {
+                        out.push_back(new Resource(id, title, url, topic, difficulty, rating, prereqs, duration));
+                    }
+                    added++;
+                }
+                return added;
+            }
+        };
+    }
+
+    size_t parseRecords(const char* data, size_t size, std::vector<Resource*>& out,
+                        const std::string& sourceName, size_t firstLine, bool skipHeader, ResourceStore* store) {
+        RecordReader reader(data, size, sourceName, firstLine, skipHeader, store);
+        reader.read(out, static_cast<size_t>(-1));
+        return reader.rejectedRows();
+    }
+
+    std::vector<Resource*> loadResources(const std::string& filename, ResourceStore* store) {
+        std::vector<Resource*> resources;
+        MappedFile file;
+
+        // 1. Check if file opened successfully
+        if (!file.open(filename)) {
+            CC_LOG_ERROR("Could not open file: " << filename
+                         << " (Tip: Check your 'Working Directory' in CLion configurations.)");
+            return resources;
+        }
+        file.adviseSequential();
+
+        // 2. Tokenize in place (the header row is skipped)
+        size_t rejected = parseRecords(file.data(), file.size(), resources, filename, 1, true, store);
+
+        CC_LOG_INFO("Loaded " << resources.size() << " resources from " << filename
+                    << (rejected ? " (" + std::to_string(rejected) + " rows skipped)" : ""));
+        return resources;
+    }
+
+    // =========================================================
+    // STREAMING LOADER
+    // =========================================================
+
+    namespace {
+        // Hand-off between the parser thread and the consumer; push() blocks when full
+        class BatchQueue {
+        private:
+            std::deque<std::vector<Resource*>> batches;
+            size_t capacity;
+            bool closed = false;
+            std::mutex mutex;
+            std::condition_variable changed;
+
+        public:
+            explicit BatchQueue(size_t cap) : capacity(cap) {}
+
+            void push(std::vector<Resource*>&& batch) {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [this] { return batches.size() < capacity; });
+                batches.push_back(std::move(batch));
+                changed.notify_all();
+            }
+
+            // False once the queue is closed and drained
+            bool pop(std::vector<Resource*>& batch) {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [this] { return closed || !batches.empty(); });
+                if (batches.empty()) return false;
+                batch = std::move(batches.front());
+                batches.pop_front();
+                changed.notify_all();
+                return true;
+            }
+
+            void close() {
+                std::lock_guard<std::mutex> lock(mutex);
+                closed = true;
+                changed.notify_all();
+            }
+        };
+    }
+
+    size_t streamResources(const std::string& filename, size_t batchSize,
+                           const std::function<void(std::vector<Resource*>&)>& sink, ResourceStore* store) {
+        MappedFile file;
+        if (!file.open(filename)) {
+            CC_LOG_ERROR("Could not open file: " << filename
+                         << " (Tip: Check your 'Working Directory' in CLion configurations.)");
+            return 0;
+        }
+        file.adviseSequential();
+        if (batchSize == 0) batchSize = 1;
+
+        const size_t kQueueDepth = 4; // Batches the parser may run ahead of the consumer
+        BatchQueue queue(kQueueDepth);
+        RecordReader reader(file.data(), file.size(), filename, 1, true, store);
+
+        std::thread parser([&] {
+            while (!reader.done()) {
+                std::vector<Resource*> batch;
+                batch.reserve(batchSize);
+                if (reader.read(batch, batchSize) > 0) queue.push(std::move(batch));
+            }
+            queue.close();
+        });
+
+        size_t delivered = 0, batches = 0;
+        std::vector<Resource*> batch;
+        while (queue.pop(batch)) {
+            delivered += batch.size();
+            batches++;
+            sink(batch);
+        }
+        parser.join();
+
+        CC_LOG_INFO("Streamed " << delivered << " resources from " << filename << " in " << batches << " batches"
+                    << (reader.rejectedRows() ? " (" + std::to_string(reader.rejectedRows()) + " rows skipped)" : ""));
+        return delivered;
+    }
+
+    // =========================================================
+    // PARALLEL LOADER
+    // =========================================================
+
+    std::vector<size_t> findChunkBoundaries(const char* data, size_t size, size_t chunkCount) {
+        std::vector<size_t> starts(1, 0);
+        size_t pos = 0;
+        bool inQuotes = false; // Quote parity at 'pos'; "" toggles twice, so escapes need no special case
+
+        for (size_t k = 1; k < chunkCount; k++) {
+            size_t target = size / chunkCount * k;
+            if (target <= pos) continue;
+
+            // Carry the quote parity forward to the cut point
+            while (const char* quote = static_cast<const char*>(std::memchr(data + pos, '"', target - pos))) {
+                inQuotes = !inQuotes;
+                pos = static_cast<size_t>(quote - data) + 1;
+            }
+            pos = target;
+
+            // The chunk starts after the next line break that is outside quotes
+            while (pos < size) {
+                const char* newline = static_cast<const char*>(std::memchr(data + pos, '\n', size - pos));
+                const char* stop = newline ? newline : data + size;
+                const char* quote = static_cast<const char*>(std::memchr(data + pos, '"', stop - (data + pos)));
+                if (quote) {
+                    inQuotes = !inQuotes;
+                    pos = static_cast<size_t>(quote - data) + 1;
+                    continue;
+                }
+                pos = static_cast<size_t>(stop - data) + (newline ? 1 : 0);
+                if (!inQuotes) break;
+            }
+            if (pos >= size) break;
+            starts.push_back(pos);
+        }
+        return starts;
+    }
+
+    namespace {
+        // Runs task(0) .. task(count - 1) on 'threads' threads (the caller is one of them)
+        void runParallel(size_t count, int threads, const std::function<void(size_t)>& task) {
+            std::atomic<size_t> next(0);
+            auto worker = [&]() {
+                for (size_t i; (i = next.fetch_add(1)) < count;) task(i);
+            };
+            std::vector<std::thread> pool;
+            for (int t = 1; t < threads; t++) pool.emplace_back(worker);
+            worker();
+            for (auto& t : pool) t.join();
+        }
+    }
+
+    std::vector<Resource*> loadResourcesParallel(const std::string& filename, int threadCount, size_t minChunkBytes,
+                                                 ResourceStore* store) {
+        std::vector<Resource*> resources;
+        MappedFile file;
+        if (!file.open(filename)) {
+            CC_LOG_ERROR("Could not open file: " << filename);
+            return resources;
+        }
+        file.adviseSequential();
+        const char* data = file.data();
+        size_t size = file.size();
+
+        if (threadCount <= 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+        // 1. Cut at record boundaries. A few chunks per thread, so one slow chunk doesn't stall the rest.
+        size_t chunkCount = std::max<size_t>(1, std::min<size_t>(size / std::max<size_t>(minChunkBytes, 1),
+                                                                 static_cast<size_t>(threadCount) * 4));
+        std::vector<size_t> starts = findChunkBoundaries(data, size, chunkCount);
+        chunkCount = starts.size();
+        starts.push_back(size);
+        threadCount = static_cast<int>(std::min<size_t>(threadCount, chunkCount));
+
+        // 2. Line number of each chunk's first record, for error messages
+        std::vector<size_t> firstLine(chunkCount, 0);
+        runParallel(chunkCount, threadCount, [&](size_t i) {
+            firstLine[i] = std::count(data + starts[i], data + starts[i + 1], '\n');
+        });
+        size_t line = 1;
+        for (size_t i = 0; i < chunkCount; i++) {
+            size_t newlines = firstLine[i];
+            firstLine[i] = line;
+            line += newlines;
+        }
+
+        // 3. Parse each chunk (into its own store, arenas are single-writer) and sort it by ID
+        //    (stable: duplicates keep file order)
+        std::vector<std::vector<Resource*>> parts(chunkCount);
+        std::vector<std::unique_ptr<ResourceStore>> partStores(chunkCount);
+        std::atomic<size_t> rejected(0);
+        runParallel(chunkCount, threadCount, [&](size_t i) {
+            if (store) partStores[i].reset(new ResourceStore());
+            rejected += parseRecords(data + starts[i], starts[i + 1] - starts[i], parts[i],
+                                     filename, firstLine[i], i == 0, partStores[i].get());
+            std::stable_sort(parts[i].begin(), parts[i].end(),
+                             [](const Resource* a, const Resource* b) { return a->id < b->id; });
+        });
+
+        if (store) {
+            for (auto& part : partStores) store->absorb(*part);
+        }
+
+        // 4. K-way merge; ties go to the earlier chunk
+        size_t total = 0;
+        for (auto& part : parts) total += part.size();
+        resources.reserve(total);
+
+        typedef std::pair<int, size_t> Head; // (ID, chunk)
+        std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+        std::vector<size_t> cursor(chunkCount, 0);
+        for (size_t i = 0; i < chunkCount; i++) {
+            if (!parts[i].empty()) heads.push(Head(parts[i][0]->id, i));
+        }
+        while (!heads.empty()) {
+            size_t i = heads.top().second;
+            heads.pop();
+            resources.push_back(parts[i][cursor[i]++]);
+            if (cursor[i] < parts[i].size()) heads.push(Head(parts[i][cursor[i]]->id, i));
+        }
+
+        CC_LOG_INFO("Loaded " << resources.size() << " resources from " << filename << " in "
+                    << chunkCount << " chunks on " << threadCount << " threads"
+                    << (rejected ? " (" + std::to_string(rejected.load()) + " rows skipped)" : ""));
+        return resources;
+    }
+
+    // =========================================================
+    // STREAM LOADER (original implementation)
+    // =========================================================
+
     // Helper function to split a string by a specific delimiter
     // Input: "101;102", Delimiter: ';' -> Output: {101, 102}
     std::vector<int> parsePrereqs(const std::string& prereqString) {
@@ -23,20 +481,20 @@ namespace CSVParser {
                     ids.push_back(std::stoi(segment));
                 }
             } catch (...) {
-                std::cerr << "Warning: Could not parse prereq ID: " << segment << std::endl;
+                CC_LOG_WARN("Could not parse prereq ID: " << segment);
             }
         }
         return ids;
     }
 
-    std::vector<Resource*> loadResources(const std::string& filename) {
+    std::vector<Resource*> loadResourcesStream(const std::string& filename) {
         std::vector<Resource*> resources;
         std::ifstream file(filename);
 
         // 1. Check if file opened successfully
         if (!file.is_open()) {
-            std::cerr << "CRITICAL ERROR: Could not open file: " << filename << std::endl;
-            std::cerr << "Tip: Check your 'Working Directory' in CLion configurations." << std::endl;
+            CC_LOG_ERROR("Could not open file: " << filename
+                         << " (Tip: Check your 'Working Directory' in CLion configurations.)");
             return resources;
         }
 
@@ -84,12 +542,12 @@ namespace CSVParser {
                 resources.push_back(newResource);
 
             } catch (const std::exception& e) {
-                std::cerr << "Error parsing row: " << line << "\nReason: " << e.what() << std::endl;
+                CC_LOG_WARN("Error parsing row: " << line << " (Reason: " << e.what() << ")");
             }
         }
 
         file.close();
-        //std::cout << "Successfully loaded " << resources.size() << " resources from " << filename << std::endl;
+        CC_LOG_INFO("Loaded " << resources.size() << " resources from " << filename);
         return resources;
     }
 }
\ No newline at end of file
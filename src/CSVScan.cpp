@@ -0,0 +1,141 @@
+#include "../include/CSVScan.h"
+#include <cstdlib>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #define CC_SCAN_X86 1
+    #include <immintrin.h>
+#else
+    #define CC_SCAN_X86 0
+#endif
+
+namespace CSVScan {
+
+    namespace {
+
+        void scanScalar(const char* block, uint64_t* masks) {
+            uint64_t fieldEnd = 0, quote = 0, semicolon = 0;
+            for (size_t i = 0; i < kBlockSize; i++) {
+                char c = block[i];
+                uint64_t bit = 1ull << i;
+                if (c == ',' || c == '\n') fieldEnd |= bit;
+                else if (c == '"') quote |= bit;
+                else if (c == ';') semicolon |= bit;
+            }
+            masks[MASK_FIELD_END] = fieldEnd;
+            masks[MASK_QUOTE] = quote;
+            masks[MASK_SEMICOLON] = semicolon;
+        }
+
+#if CC_SCAN_X86
+        __attribute__((target("sse2")))
+        void scanSSE2(const char* block, uint64_t* masks) {
+            const __m128i comma = _mm_set1_epi8(',');
+            const __m128i newline = _mm_set1_epi8('\n');
+            const __m128i quote = _mm_set1_epi8('"');
+            const __m128i semicolon = _mm_set1_epi8(';');
+
+            uint64_t fieldEnd = 0, quotes = 0, semis = 0;
+            for (int part = 0; part < 4; part++) {
+                __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + part * 16));
+                __m128i ends = _mm_or_si128(_mm_cmpeq_epi8(bytes, comma), _mm_cmpeq_epi8(bytes, newline));
+                int shift = part * 16;
+                fieldEnd |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(ends))) << shift;
+                quotes |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, quote)))) << shift;
+                semis |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, semicolon)))) << shift;
+            }
+            masks[MASK_FIELD_END] = fieldEnd;
+            masks[MASK_QUOTE] = quotes;
+            masks[MASK_SEMICOLON] = semis;
+        }
+
+        // Combines the byte masks of two 32-byte halves into one 64-bit bitmap
+        __attribute__((target("avx2")))
+        inline uint64_t bits64(__m256i lo, __m256i hi) {
+            return static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(lo))) |
+                   (static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(hi))) << 32);
+        }
+
+        __attribute__((target("avx2")))
+        void scanAVX2(const char* block, uint64_t* masks) {
+            const __m256i comma = _mm256_set1_epi8(',');
+            const __m256i newline = _mm256_set1_epi8('\n');
+            const __m256i quote = _mm256_set1_epi8('"');
+            const __m256i semicolon = _mm256_set1_epi8(';');
+
+            __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+            __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+
+            masks[MASK_FIELD_END] = bits64(_mm256_or_si256(_mm256_cmpeq_epi8(lo, comma), _mm256_cmpeq_epi8(lo, newline)),
+                                           _mm256_or_si256(_mm256_cmpeq_epi8(hi, comma), _mm256_cmpeq_epi8(hi, newline)));
+            masks[MASK_QUOTE] = bits64(_mm256_cmpeq_epi8(lo, quote), _mm256_cmpeq_epi8(hi, quote));
+            masks[MASK_SEMICOLON] = bits64(_mm256_cmpeq_epi8(lo, semicolon), _mm256_cmpeq_epi8(hi, semicolon));
+        }
+#endif
+
+        bool supported(Kernel kernel) {
+            switch (kernel) {
+                case KERNEL_SCALAR: return true;
+#if CC_SCAN_X86
+                case KERNEL_SSE2: return __builtin_cpu_supports("sse2");
+                case KERNEL_AVX2: return __builtin_cpu_supports("avx2");
+#endif
+                default: return false;
+            }
+        }
+
+        BlockKernel functionFor(Kernel kernel) {
+#if CC_SCAN_X86
+            if (kernel == KERNEL_AVX2) return scanAVX2;
+            if (kernel == KERNEL_SSE2) return scanSSE2;
+#endif
+            return scanScalar;
+        }
+
+        // Best supported kernel, unless CODECOMPASS_CSV_KERNEL asks for another one
+        Kernel initialKernel() {
+            Kernel best = KERNEL_SCALAR;
+            for (Kernel k : availableKernels()) best = k;
+
+            const char* env = std::getenv("CODECOMPASS_CSV_KERNEL");
+            if (env) {
+                std::string name(env);
+                for (Kernel k : availableKernels()) {
+                    if (name == kernelName(k)) return k;
+                }
+            }
+            return best;
+        }
+
+        Kernel& selected() {
+            static Kernel kernel = initialKernel();
+            return kernel;
+        }
+    }
+
+    std::vector<Kernel> availableKernels() {
+        std::vector<Kernel> kernels;
+        for (Kernel k : {KERNEL_SCALAR, KERNEL_SSE2, KERNEL_AVX2}) {
+            if (supported(k)) kernels.push_back(k);
+        }
+        return kernels;
+    }
+
+    bool setKernel(Kernel kernel) {
+        if (!supported(kernel)) return false;
+        selected() = kernel;
+        return true;
+    }
+
+    Kernel activeKernel() { return selected(); }
+
+    const char* kernelName(Kernel kernel) {
+        switch (kernel) {
+            case KERNEL_SSE2: return "sse2";
+            case KERNEL_AVX2: return "avx2";
+            default: return "scalar";
+        }
+    }
+
+    BlockKernel blockKernel() { return functionFor(selected()); }
+
+}
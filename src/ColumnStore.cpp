@@ -0,0 +1,261 @@
+#include "../include/ColumnStore.h"
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #define CC_COLUMN_X86 1
+    #include <immintrin.h>
+#else
+    #define CC_COLUMN_X86 0
+#endif
+
+namespace {
+
+    // Each kernel writes matching row numbers to 'out' and returns how many.
+    // 'out' needs room for n + 8 entries: the AVX2 kernel stores whole vectors.
+    typedef size_t (*RangeKernel)(const int32_t* col, size_t n, int32_t lo, int32_t hi, uint32_t* out);
+
+    // Branchless: the slot is always written, the count only moves on a match
+    size_t rangeScalar(const int32_t* col, size_t n, int32_t lo, int32_t hi, uint32_t* out) {
+        size_t count = 0;
+        for (size_t i = 0; i < n; i++) {
+            out[count] = static_cast<uint32_t>(i);
+            count += (col[i] >= lo) & (col[i] <= hi);
+        }
+        return count;
+    }
+
+    // A candidate for the top k: its rating and its position in the selection
+    struct Entry {
+        double rating;
+        uint32_t at;
+    };
+
+    // Best first: higher rating, then earlier in the selection. As a heap comparator
+    // this keeps the worst entry on top.
+    inline bool better(const Entry& a, const Entry& b) {
+        return a.rating > b.rating || (a.rating == b.rating && a.at < b.at);
+    }
+
+    // Keeps the k best entries in 'best'. Once k are kept, a row only gets in by beating
+    // the worst of them; a tie loses to the earlier row, so the threshold test is '>'.
+    struct TopK {
+        std::vector<Entry>& best;
+        size_t k;
+        size_t pushes;
+
+        TopK(std::vector<Entry>& b, size_t want) : best(b), k(want), pushes(0) { best.clear(); }
+
+        bool full() const { return best.size() == k; }
+        double threshold() const { return best.front().rating; }
+
+        void offer(double rating, uint32_t at) {
+            Entry e = {rating, at};
+            if (!full()) {
+                best.push_back(e);
+                std::push_heap(best.begin(), best.end(), better);
+                pushes++;
+            } else if (rating > threshold()) {
+                std::pop_heap(best.begin(), best.end(), better);
+                best.back() = e;
+                std::push_heap(best.begin(), best.end(), better);
+                pushes++;
+            }
+        }
+    };
+
+    // Top k of ratings[sel[i]] into 'best' (unordered); returns how many rows entered the heap
+    typedef size_t (*TopKernel)(const double* ratings, const uint32_t* sel, size_t n, size_t k, std::vector<Entry>& best);
+
+    size_t topScalar(const double* ratings, const uint32_t* sel, size_t n, size_t k, std::vector<Entry>& best) {
+        TopK top(best, k);
+        for (size_t i = 0; i < n; i++) top.offer(ratings[sel[i]], static_cast<uint32_t>(i));
+        return top.pushes;
+    }
+
+#if CC_COLUMN_X86
+    // compressTable[mask] lists the lanes set in 'mask', in order: a permutation
+    // that moves the selected row numbers to the front of the vector
+    struct CompressTable {
+        alignas(32) int32_t lanes[256][8];
+
+        CompressTable() {
+            for (int mask = 0; mask < 256; mask++) {
+                int n = 0;
+                for (int lane = 0; lane < 8; lane++) {
+                    if (mask & (1 << lane)) lanes[mask][n++] = lane;
+                }
+                while (n < 8) lanes[mask][n++] = 0;
+            }
+        }
+    };
+
+    const CompressTable compressTable;
+
+    __attribute__((target("avx2")))
+    inline size_t emit(__m256i index, unsigned mask, uint32_t* out) {
+        __m256i order = _mm256_load_si256(reinterpret_cast<const __m256i*>(compressTable.lanes[mask]));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_permutevar8x32_epi32(index, order));
+        return static_cast<size_t>(__builtin_popcount(mask));
+    }
+
+    __attribute__((target("avx2")))
+    size_t rangeAVX2(const int32_t* col, size_t n, int32_t lo, int32_t hi, uint32_t* out) {
+        const __m256i low = _mm256_set1_epi32(lo);
+        const __m256i high = _mm256_set1_epi32(hi);
+        const __m256i step = _mm256_set1_epi32(8);
+        __m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+        size_t count = 0, i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(col + i));
+            __m256i outside = _mm256_or_si256(_mm256_cmpgt_epi32(low, x), _mm256_cmpgt_epi32(x, high));
+            unsigned mask = ~static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(outside))) & 0xFFu;
+            count += emit(index, mask, out + count);
+            index = _mm256_add_epi32(index, step);
+        }
+        for (; i < n; i++) {
+            out[count] = static_cast<uint32_t>(i);
+            count += (col[i] >= lo) & (col[i] <= hi);
+        }
+        return count;
+    }
+
+    // Gathers 4 selected ratings per step and compares them with the worst one kept;
+    // only a step with a lane above it goes through the heap
+    __attribute__((target("avx2")))
+    size_t topAVX2(const double* ratings, const uint32_t* sel, size_t n, size_t k, std::vector<Entry>& best) {
+        TopK top(best, k);
+        size_t i = 0;
+        for (; i < n && !top.full(); i++) top.offer(ratings[sel[i]], static_cast<uint32_t>(i));
+        if (i == n) return top.pushes;
+
+        __m256d threshold = _mm256_set1_pd(top.threshold());
+        // The masked gather with a zeroed source: the plain one starts from an undefined
+        // register, which GCC flags under -Wmaybe-uninitialized
+        const __m256d allLanes = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+        for (; i + 4 <= n; i += 4) {
+            __m128i rows = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sel + i));
+            __m256d x = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), ratings, rows, allLanes, 8);
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(x, threshold, _CMP_GT_OQ)));
+            if (!mask) continue;
+            for (size_t lane = 0; lane < 4; lane++) {
+                if (mask & (1u << lane)) top.offer(ratings[sel[i + lane]], static_cast<uint32_t>(i + lane));
+            }
+            threshold = _mm256_set1_pd(top.threshold());
+        }
+        for (; i < n; i++) top.offer(ratings[sel[i]], static_cast<uint32_t>(i));
+        return top.pushes;
+    }
+#endif
+
+    struct Kernels {
+        RangeKernel range;
+        TopKernel top;
+        const char* name;
+    };
+
+    // AVX2 if the CPU has it, unless CODECOMPASS_COLUMN_KERNEL=scalar
+    Kernels pickKernels() {
+        Kernels scalar = {rangeScalar, topScalar, "scalar"};
+#if CC_COLUMN_X86
+        const char* env = std::getenv("CODECOMPASS_COLUMN_KERNEL");
+        if (__builtin_cpu_supports("avx2") && !(env && std::string(env) == "scalar")) {
+            Kernels avx2 = {rangeAVX2, topAVX2, "avx2"};
+            return avx2;
+        }
+#endif
+        return scalar;
+    }
+
+    const Kernels& kernels() {
+        static const Kernels selected = pickKernels();
+        return selected;
+    }
+}
+
+void ColumnStore::append(const std::vector<Resource*>& batch) {
+    size_t n = rows.size() + batch.size();
+    ids.reserve(n); difficulties.reserve(n); durations.reserve(n);
+    topicIds.reserve(n); ratings.reserve(n); rows.reserve(n);
+    for (Resource* r : batch) {
+        ids.push_back(r->id);
+        difficulties.push_back(r->difficulty);
+        durations.push_back(r->duration);
+        topicIds.push_back(r->topic.id);
+        ratings.push_back(r->rating);
+        rows.push_back(r);
+        rowOfID.emplace(r->id, static_cast<uint32_t>(rows.size() - 1)); // Duplicate IDs keep the first row
+    }
+}
+
+void ColumnStore::assign(const std::vector<Resource*>& list) {
+    clear();
+    append(list);
+}
+
+void ColumnStore::update(const std::vector<Resource*>& list, const std::vector<uint32_t>& changedRows) {
+    // Forget the IDs of rows that are overwritten or dropped, then record the new ones
+    auto forget = [this](uint32_t row) {
+        auto it = rowOfID.find(ids[row]);
+        if (it != rowOfID.end() && it->second == row) rowOfID.erase(it);
+    };
+    for (uint32_t row : changedRows) {
+        if (row < rows.size()) forget(row);
+    }
+    for (size_t row = list.size(); row < rows.size(); row++) forget(static_cast<uint32_t>(row));
+
+    size_t n = list.size();
+    ids.resize(n); difficulties.resize(n); durations.resize(n);
+    topicIds.resize(n); ratings.resize(n); rows.resize(n);
+    for (uint32_t row : changedRows) {
+        const Resource* r = list[row];
+        ids[row] = r->id;
+        difficulties[row] = r->difficulty;
+        durations[row] = r->duration;
+        topicIds[row] = r->topic.id;
+        ratings[row] = r->rating;
+        rows[row] = list[row];
+        rowOfID[r->id] = row;
+    }
+}
+
+void ColumnStore::clear() {
+    ids.clear(); difficulties.clear(); durations.clear();
+    topicIds.clear(); ratings.clear(); rows.clear();
+    rowOfID.clear();
+}
+
+void ColumnStore::selectAll(Selection& out) const {
+    out.resize(rows.size());
+    for (size_t i = 0; i < out.size(); i++) out[i] = static_cast<uint32_t>(i);
+}
+
+void ColumnStore::selectRange(IntColumn c, int lo, int hi, Selection& out) const {
+    const std::vector<int32_t>& values = column(c);
+    out.resize(values.size() + 8);
+    out.resize(kernels().range(values.data(), values.size(), lo, hi, out.data()));
+}
+
+void ColumnStore::selectIDs(const std::vector<int>& wanted, Selection& out) const {
+    out.clear();
+    out.reserve(wanted.size());
+    for (int id : wanted) {
+        auto it = rowOfID.find(id);
+        if (it != rowOfID.end()) out.push_back(it->second);
+    }
+}
+
+size_t ColumnStore::topByRating(const Selection& sel, size_t k, Selection& top) const {
+    top.clear();
+    if (k == 0 || sel.empty()) return 0; // The kernels expect at least one row to keep
+    std::vector<Entry> best;
+    size_t pushes = kernels().top(ratings.data(), sel.data(), sel.size(), std::min(k, sel.size()), best);
+    std::sort(best.begin(), best.end(), better);
+    top.reserve(best.size());
+    for (const Entry& e : best) top.push_back(sel[e.at]);
+    return pushes;
+}
+
+const char* ColumnStore::kernelName() { return kernels().name; }
@@ -1,12 +1,19 @@
 #include "../include/Engine.h"
 #include "../include/Sorters.h"
 #include "../include/Optimizer.h"
+#include "../include/CSVParser.h"
+#include "../include/BinaryCatalog.h"
+#include "../include/Log.h"
 #include <algorithm>
 #include <cctype>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
 #include <iostream>
 #include <sstream>
 #include <chrono>
 #include <iomanip>
+#include <unordered_map>
 
 // Helper to split string
 std::vector<std::string> splitInternal(const std::string& s, char delimiter) {
@@ -19,38 +26,822 @@ std::vector<std::string> splitInternal(const std::string& s, char delimiter) {
     return tokens;
 }
 
-Engine::Engine(const std::vector<Resource*>& data) : masterList(data) {
+// FUZZY results per request: when no limit is given, and the most a request may ask for
+static const size_t kDefaultFuzzyLimit = 20;
+static const size_t kMaxFuzzyLimit = 1000;
+
+// CRAM's knapsack table has (candidates + 1) x (minutes + 1) cells of 8 bytes: bound both the
+// time budget (one day) and the table (64M cells, 512 MB) so a request can't exhaust memory
+static const int kMaxCramMinutes = 24 * 60;
+static const size_t kMaxCramCells = size_t(64) << 20;
+
+void Engine::allocateStructures() {
     searchIndex = new Trie();
     storageTree = new AVLTree();
-    ratingQueue = new MaxHeap();
+    ratingQueue = new MaxHeap(true); // Position tracking, so RELOAD can remove entries
+    catalogVersion = 0;
+    infixReady = false;
+    textReady = false;
     depGraph = new KnowledgeGraph();
-    cache = new LRUCache(5);
-    historyStack = new Stack();
+    defaultSession = new Session();
+}
+
+// Title key: lower case, surrounding whitespace dropped, inner runs collapsed to one space
+static std::string normalizeTitle(std::string_view title) {
+    std::string key;
+    key.reserve(title.size());
+    bool pendingSpace = false;
+    for (char c : title) {
+        if (isspace(static_cast<unsigned char>(c))) {
+            pendingSpace = !key.empty();
+            continue;
+        }
+        if (pendingSpace) { key += ' '; pendingSpace = false; }
+        key += static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    }
+    return key;
+}
+
+void Engine::buildTitleIndex() {
+    titleIndex.reserve(masterList.size());
+    for (Resource* r : masterList) titleIndex.emplace(normalizeTitle(r->title), r);
+}
+
+void Engine::eraseTitle(Resource* r) {
+    auto range = titleIndex.equal_range(normalizeTitle(r->title));
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == r) { titleIndex.erase(it); return; }
+    }
+}
+
+// Single-resource counterparts of the bulk build, used by reload() (which stages the trie separately)
+void Engine::indexResource(Resource* r) {
+    storageTree->insert(r);
+    ratingQueue->insert(r);
+    depGraph->insertResource(r);
+    titleIndex.emplace(normalizeTitle(r->title), r);
+}
+
+// Packs a trie for serving and ranks its keys for COMPLETE by the ratings in 'list'
+void Engine::freezeSearchIndex(Trie* index, const std::vector<Resource*>& list) {
+    index->freeze();
+    std::vector<std::pair<int, double>> ratings; // (ID, rating), sorted by ID
+    ratings.reserve(list.size());
+    for (Resource* r : list) ratings.push_back(std::make_pair(r->id, r->rating));
+    auto byID = [](const std::pair<int, double>& a, const std::pair<int, double>& b) { return a.first < b.first; };
+    std::stable_sort(ratings.begin(), ratings.end(), byID);
+    index->rankCompletions([&ratings, &byID](int id) {
+        auto it = std::lower_bound(ratings.begin(), ratings.end(), std::make_pair(id, 0.0), byID);
+        return it != ratings.end() && it->first == id ? it->second : 0.0;
+    });
+}
+
+void Engine::unindexResource(Resource* r) {
+    storageTree->remove(r->id);
+    ratingQueue->remove(r);
+    depGraph->removeResource(r);
+    eraseTitle(r);
+}
+
+Engine::Engine() {
+    allocateStructures();
+}
 
-    for (Resource* r : data) {
+Engine::Engine(const std::vector<Resource*>& data) : Engine() {
+    ingest(data);
+    finishIngest();
+}
+
+void Engine::ingest(const std::vector<Resource*>& batch) {
+    std::unique_lock<std::shared_mutex> lock(catalogMutex);
+    masterList.insert(masterList.end(), batch.begin(), batch.end());
+    columns.append(batch);
+    for (Resource* r : batch) {
         searchIndex->insert(r->title, r->id);
         searchIndex->insert(r->topic, r->id);
         storageTree->insert(r);
-        ratingQueue->insert(r, false);
+        ratingQueue->insert(r);
         depGraph->addResource(r);
+        titleIndex.emplace(normalizeTitle(r->title), r);
+    }
+}
+
+void Engine::finishIngest() {
+    // Prereqs may point forward in the file, so edges wait until every resource is known
+    std::unique_lock<std::shared_mutex> lock(catalogMutex);
+    depGraph->buildGraph(masterList);
+    // Loading is done: serve prefix lookups from the flat arrays
+    freezeSearchIndex(searchIndex, masterList);
+    // infixIndex and textIndex wait for the first CONTAINS / RANK (or buildDeferredIndexes)
+}
+
+// Builds a deferred index once, however many readers ask for it at the same time
+template <typename Index>
+static void buildOnce(Index& index, std::atomic<bool>& ready, std::mutex& mutex, const std::vector<Resource*>& list) {
+    if (ready.load(std::memory_order_acquire)) return;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (ready.load(std::memory_order_relaxed)) return;
+    index.build(list);
+    ready.store(true, std::memory_order_release);
+}
+
+void Engine::ensureInfixIndex() const {
+    buildOnce(infixIndex, infixReady, indexBuildMutex, masterList);
+}
+
+void Engine::ensureTextIndex() const {
+    buildOnce(textIndex, textReady, indexBuildMutex, masterList);
+}
+
+void Engine::buildDeferredIndexes() const {
+    std::shared_lock<std::shared_mutex> lock(catalogMutex);
+    ensureTextIndex();
+    ensureInfixIndex();
+}
+
+size_t Engine::resourceCount() const {
+    std::shared_lock<std::shared_mutex> lock(catalogMutex);
+    return masterList.size();
+}
+
+bool Engine::loadSnapshot(const Snapshot::Image& image, std::string& reason) {
+    // 1. Materialize resources (records are stored sorted by ID)
+    size_t n = image.resourceCount();
+    depGraph->reserve(n);
+    if (!image.makeResources(store, masterList, reason)) return false;
+    for (Resource* r : masterList) depGraph->addResource(r);
+
+    // 2. Bulk-load every index from its serialized form, rejecting any that does not fit
+    columns.assign(masterList);
+    storageTree->buildFromSorted(masterList);
+
+    FrozenTrie trie;
+    image.loadTrie(trie);
+    if (!searchIndex->importFrozen(std::move(trie))) { reason = "bad trie"; return false; }
+    if (!searchIndex->isRanked()) freezeSearchIndex(searchIndex, masterList); // Snapshots normally carry the ranking
+    NGramIndex::Arrays infix;
+    image.loadInfixIndex(infix);
+    if (!infixIndex.importArrays(std::move(infix), masterList)) { reason = "bad substring index"; return false; }
+    infixReady = true;
+    TextIndex::Arrays text;
+    image.loadTextIndex(text);
+    if (!textIndex.importArrays(std::move(text), masterList)) { reason = "bad text index"; return false; }
+    textReady = true;
+
+    // Offsets ascend and stay within the targets
+    size_t offsetCount, targetCount;
+    const uint32_t* adjOffsets = image.adjacencyOffsets(offsetCount);
+    const int32_t* adjTargets = image.adjacencyTargets(targetCount);
+    for (size_t i = 0; i < n; i++) {
+        if (adjOffsets[i] > adjOffsets[i + 1] || adjOffsets[i + 1] > targetCount) { reason = "bad adjacency"; return false; }
+        depGraph->loadEdges(masterList[i]->id, adjTargets + adjOffsets[i], adjOffsets[i + 1] - adjOffsets[i]);
     }
-    depGraph->buildGraph(data);
+    depGraph->indexMissingPrereqs(masterList);
+
+    // Each ordering lists every record once
+    auto resolve = [this, n](const uint32_t* indices, size_t count, std::vector<Resource*>& out) {
+        if (count != n) return false;
+        out.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            if (indices[i] >= n) return false;
+            out.push_back(masterList[indices[i]]);
+        }
+        return true;
+    };
+    size_t count;
+    const uint32_t* order = image.orderByDifficulty(count);
+    bool ordered = resolve(order, count, orderByDifficulty);
+    order = image.orderByTopic(count);
+    ordered = ordered && resolve(order, count, orderByTopic);
+
+    std::vector<Resource*> heapLayout;
+    order = image.heapLayout(count);
+    ordered = ordered && resolve(order, count, heapLayout);
+    if (!ordered) { reason = "bad ordering"; return false; }
+    ratingQueue->assign(heapLayout);
+    buildTitleIndex();
+    return true;
+}
+
+bool Engine::saveSnapshot(const std::string& path, const Snapshot::SourceStamp& source) {
+    std::shared_lock<std::shared_mutex> lock(catalogMutex);
+    Snapshot::Contents contents;
+
+    // Resources sorted by ID (stable, so duplicate IDs keep their CSV order)
+    contents.resources = masterList;
+    std::stable_sort(contents.resources.begin(), contents.resources.end(),
+                     [](const Resource* a, const Resource* b) { return a->id < b->id; });
+
+    std::unordered_map<const Resource*, uint32_t> indexOf;
+    indexOf.reserve(contents.resources.size());
+    for (size_t i = 0; i < contents.resources.size(); i++) {
+        indexOf[contents.resources[i]] = static_cast<uint32_t>(i);
+    }
+
+    searchIndex->exportFrozen(contents.trie);
+    ensureInfixIndex();
+    ensureTextIndex();
+
+    // The snapshot's rows are its records; a catalog loaded in ID order already has them
+    if (contents.resources == masterList) {
+        infixIndex.exportArrays(contents.infix);
+        textIndex.exportArrays(contents.text);
+    } else {
+        NGramIndex byID;
+        byID.build(contents.resources);
+        byID.exportArrays(contents.infix);
+        TextIndex textByID;
+        textByID.build(contents.resources);
+        textByID.exportArrays(contents.text);
+    }
+
+    // Edges hang off the first record of each ID, matching AVLTree's duplicate handling
+    contents.dependents.resize(contents.resources.size());
+    for (size_t i = 0; i < contents.resources.size(); i++) {
+        if (i > 0 && contents.resources[i - 1]->id == contents.resources[i]->id) continue;
+        const std::vector<int>* deps = depGraph->getDependents(contents.resources[i]->id);
+        if (deps) contents.dependents[i] = *deps;
+    }
+
+    // Same orderings handleList would compute on demand
+    std::vector<Resource*> byDifficulty = storageTree->inorderTraversal();
+    std::vector<Resource*> byTopic = byDifficulty;
+    Sorters::sortByDifficulty(byDifficulty);
+    Sorters::sortByTopic(byTopic);
+    for (Resource* r : byDifficulty) contents.orderByDifficulty.push_back(indexOf[r]);
+    for (Resource* r : byTopic) contents.orderByTopic.push_back(indexOf[r]);
+    for (Resource* r : ratingQueue->getArray()) contents.heapLayout.push_back(indexOf[r]);
+
+    return Snapshot::write(path, contents, source);
 }
 
 Engine::~Engine() {
     delete searchIndex; delete storageTree;
-    delete ratingQueue; delete depGraph; delete cache; delete historyStack;
+    delete ratingQueue; delete depGraph; delete defaultSession;
 }
 
-std::vector<Resource*> Engine::resourceList() { return masterList; }
+void Engine::setSourcePath(const std::string& path) { sourcePath = path; }
+
+static bool sameContents(const Resource* a, const Resource* b) {
+    return a->title == b->title && a->url == b->url && a->topic == b->topic &&
+           a->difficulty == b->difficulty && a->rating == b->rating &&
+           a->duration == b->duration && a->prereqIDs == b->prereqIDs;
+}
+
+// =========================================================
+// RELOAD
+// Still O(catalog) per reload, however small the edit: the CSV is
+// re-parsed and diffed, the frozen trie is copied, thawed, edited,
+// re-frozen and re-ranked, and the CONTAINS/RANK indexes copy every
+// untouched list's bytes (~0.9 s of staging for one changed row at
+// 200K rows). All of that runs while readers continue. Only the
+// apply step, under the exclusive lock, is proportional to the edit.
+// =========================================================
+
+bool Engine::reload(AnalysisLevel analysis, std::ostream& out) {
+    std::lock_guard<std::mutex> writer(reloadMutex);
+    auto start = std::chrono::high_resolution_clock::now();
+
+    if (sourcePath.empty()) {
+        out << "ERROR:RELOAD needs a source CSV" << '\n';
+        return false;
+    }
+    // Parse into a scratch store; only added resources are copied into the engine's store.
+    // A changed resource keeps its object, overwritten in step 3, so only its changed strings
+    // are allocated and reloading an unchanged catalog doesn't grow the store at all.
+    ResourceStore parsed;
+    std::vector<Resource*> fresh = BinaryCatalog::isBinaryCatalog(sourcePath)
+        ? BinaryCatalog::loadResources(sourcePath, &parsed)
+        : CSVParser::loadResources(sourcePath, &parsed);
+    if (fresh.empty()) {
+        out << "ERROR:RELOAD could not load " << sourcePath << ", catalog unchanged" << '\n';
+        return false;
+    }
+    auto parseEnd = std::chrono::high_resolution_clock::now();
+
+    // 1. Diff by ID. masterList is written by ingest() while the catalog loads and by step 3
+    //    below, both under the exclusive catalogMutex. Reloads start only once loading is done
+    //    and hold reloadMutex, so nothing writes it concurrently and it is read here unlocked.
+    std::unordered_map<int, uint32_t> current; // ID -> row
+    current.reserve(masterList.size());
+    bool duplicateIDs = false;
+    for (uint32_t row = 0; row < masterList.size(); row++) {
+        if (!current.emplace(masterList[row]->id, row).second) duplicateIDs = true;
+    }
+
+    std::vector<Resource*> nextList = masterList; // Changed rows hold the parsed copy until staged
+    std::vector<Resource*> freshOrder;            // The new catalog in CSV order, for a full rebuild
+    std::vector<Resource*> added, removed;
+    std::vector<std::pair<Resource*, Resource*>> changed; // (live, parsed)
+    std::vector<char> dirty(masterList.size(), 0);        // Rows whose contents change
+    std::unordered_map<int, Resource*> seen;
+    freshOrder.reserve(fresh.size());
+    seen.reserve(fresh.size());
+    for (Resource* r : fresh) {
+        if (!seen.emplace(r->id, r).second) {
+            CC_LOG_WARN("RELOAD: duplicate ID " << r->id << " (" << r->title << ") ignored");
+            continue;
+        }
+        auto old = current.find(r->id);
+        if (old == current.end()) {
+            Resource* kept = store.create(*r);
+            added.push_back(kept);
+            freshOrder.push_back(kept);
+        } else if (sameContents(masterList[old->second], r)) {
+            freshOrder.push_back(masterList[old->second]); // Keep the live object, drop the copy
+        } else {
+            changed.push_back(std::make_pair(masterList[old->second], r));
+            nextList[old->second] = r;
+            dirty[old->second] = 1;
+            freshOrder.push_back(r);
+        }
+    }
+    std::vector<uint32_t> holes;
+    for (uint32_t row = 0; row < masterList.size(); row++) {
+        if (!seen.count(masterList[row]->id)) {
+            removed.push_back(masterList[row]);
+            holes.push_back(row);
+        }
+    }
+    size_t unchanged = freshOrder.size() - added.size() - changed.size();
+
+    // Row layout of the new catalog: every row keeps its number, the last row moves into each
+    // removed one's place, and added resources go at the end. The row-keyed indexes (CONTAINS,
+    // RANK, the columns) then only patch the rows listed in changedRows.
+    std::vector<uint32_t> changedRows;
+    if (duplicateIDs) {
+        nextList.swap(freshOrder);
+    } else {
+        for (size_t h = holes.size(); h-- > 0;) {
+            uint32_t hole = holes[h];
+            if (hole + 1 != nextList.size()) {
+                nextList[hole] = nextList.back();
+                dirty[hole] = 1;
+            }
+            nextList.pop_back();
+        }
+        for (uint32_t row = 0; row < nextList.size(); row++) {
+            if (dirty[row]) changedRows.push_back(row);
+        }
+        for (Resource* r : added) {
+            changedRows.push_back(static_cast<uint32_t>(nextList.size()));
+            nextList.push_back(r);
+        }
+    }
+    auto diffEnd = std::chrono::high_resolution_clock::now();
 
-void Engine::printResourceLine(Resource* r) {
-    std::cout << r->id << "," << r->title << "," << r->url << ","
+    // 2. Edit a copy of the frozen trie. Thawing and re-freezing cost O(catalog),
+    //    so this happens before queries are blocked; step 3 only swaps it in.
+    Trie* nextIndex = nullptr;
+    if (!duplicateIDs) {
+        FrozenTrie copy;
+        searchIndex->exportFrozen(copy); // Queries only read searchIndex, like masterList
+        nextIndex = new Trie();
+        nextIndex->importFrozen(std::move(copy));
+        for (Resource* r : removed) {
+            nextIndex->remove(r->title, r->id);
+            nextIndex->remove(r->topic, r->id);
+        }
+        for (auto& change : changed) {
+            const Resource* oldR = change.first;
+            const Resource* newR = change.second;
+            if (oldR->title != newR->title) {
+                nextIndex->remove(oldR->title, oldR->id);
+                nextIndex->insert(newR->title, newR->id);
+            }
+            if (oldR->topic != newR->topic) {
+                nextIndex->remove(oldR->topic, oldR->id);
+                nextIndex->insert(newR->topic, newR->id);
+            }
+        }
+        for (Resource* r : added) {
+            nextIndex->insert(r->title, r->id);
+            nextIndex->insert(r->topic, r->id);
+        }
+        freezeSearchIndex(nextIndex, nextList);
+    }
+    // A deferred index that nobody has built yet stays unbuilt. One that is built is only
+    // written under the exclusive lock (step 3), so it is read here unlocked like masterList.
+    bool patchInfix = infixReady.load(std::memory_order_acquire);
+    bool patchText = textReady.load(std::memory_order_acquire);
+    NGramIndex nextInfix;
+    if (patchInfix && duplicateIDs) nextInfix.build(nextList);
+    else if (patchInfix) nextInfix.update(infixIndex, nextList, changedRows); // Only the changed rows' posting lists
+    TextIndex nextText;
+    if (patchText && duplicateIDs) nextText.build(nextList);
+    else if (patchText) nextText.update(textIndex, nextList, changedRows); // Only the changed rows' word lists
+
+    // Staging read the parsed copies of changed resources; the new catalog keeps the live
+    // objects instead, which step 3 overwrites with those contents
+    auto keepLive = [this, &current](Resource*& r) {
+        auto old = current.find(r->id);
+        if (old != current.end()) r = masterList[old->second];
+    };
+    if (duplicateIDs) {
+        for (Resource*& r : nextList) keepLive(r);
+    } else {
+        for (uint32_t row : changedRows) keepLive(nextList[row]);
+    }
+    if (patchInfix) nextInfix.rebind(nextList);
+    if (patchText) nextText.rebind(nextList);
+    auto stageEnd = std::chrono::high_resolution_clock::now();
+
+    // 3. Apply under the exclusive lock
+    {
+        std::unique_lock<std::shared_mutex> lock(catalogMutex);
+
+        if (duplicateIDs) {
+            // The initial CSV repeated IDs, so the indexes don't map 1:1 to masterList.
+            // Rebuild once; from here on the catalog is unique and reloads are incremental.
+            CC_LOG_WARN("RELOAD: current catalog has duplicate IDs, rebuilding all indexes");
+            for (auto& change : changed) store.update(change.first, *change.second);
+            delete searchIndex; delete storageTree; delete ratingQueue; delete depGraph;
+            searchIndex = new Trie();
+            storageTree = new AVLTree();
+            ratingQueue = new MaxHeap(true);
+            depGraph = new KnowledgeGraph();
+            titleIndex.clear();
+            for (Resource* r : nextList) {
+                searchIndex->insert(r->title, r->id);
+                searchIndex->insert(r->topic, r->id);
+                storageTree->insert(r);
+                ratingQueue->insert(r);
+                depGraph->addResource(r);
+            }
+            depGraph->buildGraph(nextList);
+            masterList.swap(nextList);
+            buildTitleIndex();
+            freezeSearchIndex(searchIndex, masterList);
+            columns.assign(masterList);
+
+            // Fresh structures restart their revisions, so drop every cached dump
+            std::lock_guard<std::mutex> dumps(dumpMutex);
+            treeDump.valid = trieDump.valid = graphDump.valid = heapDump.valid = false;
+            treeStats.valid = false;
+        } else {
+            for (Resource* r : removed) unindexResource(r);
+
+            for (auto& change : changed) {
+                Resource* r = change.first;
+                IdList oldPrereqs = r->prereqIDs;
+                ratingQueue->remove(r); // Both are keyed by the old contents
+                eraseTitle(r);
+                store.update(r, *change.second);
+                storageTree->replace(r); // Same node and object; bumps the tree's revision
+                depGraph->updateResource(r, oldPrereqs);
+                ratingQueue->insert(r);
+                titleIndex.emplace(normalizeTitle(r->title), r);
+            }
+
+            for (Resource* r : added) indexResource(r);
+            masterList.swap(nextList);
+            std::swap(searchIndex, nextIndex);
+
+            columns.update(masterList, changedRows);
+
+            // The staged trie counts its own revisions
+            std::lock_guard<std::mutex> dumps(dumpMutex);
+            trieDump.valid = false;
+        }
+
+        // An index first built during staging describes the old catalog: drop it
+        infixIndex.swap(nextInfix);
+        infixReady = patchInfix;
+        textIndex.swap(nextText);
+        textReady = patchText;
+
+        // Precomputed LIST orders came from the snapshot and are now stale
+        orderByDifficulty.clear();
+        orderByTopic.clear();
+        catalogVersion++;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    delete nextIndex; // The trie that was swapped out
+
+    // Objects that left the catalog may still sit in a session's history, which holds raw
+    // pointers, so their slots are not reused; they stay in the store (or with whoever
+    // owns them) until the engine is destroyed. Changed resources kept their objects.
+
+    CC_LOG_INFO("RELOAD: " << added.size() << " added, " << removed.size() << " removed, "
+                << changed.size() << " changed, " << unchanged << " unchanged");
+    if (analysis == ANALYSIS_NONE) return true;
+
+    auto micros = [](std::chrono::high_resolution_clock::duration d) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+    };
+    out << "---ANALYSIS---" << '\n';
+    out << "OPERATION:RELOAD" << '\n';
+    out << "ADDED:" << added.size() << '\n';
+    out << "REMOVED:" << removed.size() << '\n';
+    out << "CHANGED:" << changed.size() << '\n';
+    out << "UNCHANGED:" << unchanged << '\n';
+    out << "FULL_REBUILD:" << (duplicateIDs ? 1 : 0) << '\n';
+    out << "PARSE_TIME_US:" << micros(parseEnd - start) << '\n';
+    out << "DIFF_TIME_US:" << micros(diffEnd - parseEnd) << '\n';
+    out << "STAGE_TIME_US:" << micros(stageEnd - diffEnd) << '\n';
+    out << "APPLY_TIME_US:" << micros(end - stageEnd) << '\n';
+    out << "TOTAL_TIME_US:" << micros(end - start) << '\n';
+    out << "RESULT_COUNT:" << masterList.size() << '\n';
+    out << "---END_ANALYSIS---" << '\n';
+    return true;
+}
+
+void Engine::printResourceLine(const Resource* r, std::ostream& out) const {
+    out << r->id << "," << r->title << "," << r->url << ","
               << r->topic << "," << r->difficulty << "," << r->rating << ","
-              << r->duration << std::endl;
+              << r->duration << '\n';
+}
+
+static std::string lowerCopy(const std::string& s) {
+    std::string out(s);
+    for (char& c : out) c = static_cast<char>(tolower(c));
+    return out;
+}
+
+std::vector<int> Engine::findByPrefix(const std::string& prefix, const Session& session) const {
+    if (session.prepared) {
+        auto it = session.prepared->prefixResults.find(lowerCopy(prefix));
+        if (it != session.prepared->prefixResults.end()) return it->second;
+    }
+    return searchIndex->getResourcesByPrefix(prefix);
+}
+
+std::vector<int> Engine::findPageByPrefix(const std::string& prefix, const Session& session, int64_t after, size_t limit, bool& more) const {
+    if (session.prepared) {
+        auto it = session.prepared->prefixResults.find(lowerCopy(prefix));
+        if (it != session.prepared->prefixResults.end()) {
+            const std::vector<int>& all = it->second;
+            auto from = std::upper_bound(all.begin(), all.end(), after, [](int64_t a, int id) { return a < id; });
+            size_t take = std::min<size_t>(limit, all.end() - from);
+            more = from + take != all.end();
+            return std::vector<int>(from, from + take);
+        }
+    }
+    return searchIndex->getPageByPrefix(prefix, after, limit, more);
+}
+
+// Search cursor: the last ID of the page (8 hex digits) and a 16-bit tag of the query (4 hex
+// digits), so a cursor handed to a different query is rejected instead of silently skipping results
+static uint32_t cursorTag(const std::string& query) {
+    uint32_t hash = 2166136261u;
+    for (char c : query) hash = (hash ^ static_cast<unsigned char>(tolower(static_cast<unsigned char>(c)))) * 16777619u;
+    return (hash ^ (hash >> 16)) & 0xFFFF;
+}
+
+static std::string encodeCursor(const std::string& query, int lastID) {
+    char token[13];
+    snprintf(token, sizeof(token), "%08x%04x", static_cast<uint32_t>(lastID), cursorTag(query));
+    return token;
+}
+
+bool Engine::decodeCursor(const std::string& token, const std::string& query, int64_t& after) {
+    if (token.size() != 12 || token.find_first_not_of("0123456789abcdef") != std::string::npos) return false;
+    uint32_t id = static_cast<uint32_t>(std::stoul(token.substr(0, 8), nullptr, 16));
+    if (std::stoul(token.substr(8), nullptr, 16) != cursorTag(query)) return false;
+    after = static_cast<int32_t>(id);
+    return true;
+}
+
+Resource* Engine::findByID(int id, const Session& session, int& treeSearches) const {
+    if (session.prepared) {
+        auto it = session.prepared->resources.find(id);
+        if (it != session.prepared->resources.end()) return it->second;
+    }
+    treeSearches++;
+    return storageTree->search(id);
 }
 
-void Engine::execute(const std::string& command) {
+int Engine::lookupTitle(const std::string& title, bool allowPrefix, TitleMatch& match) const {
+    std::string key = normalizeTitle(title);
+
+    // Several titles may share a key: prefer an exact match, then the lowest ID
+    Resource* exact = nullptr;
+    Resource* normalized = nullptr;
+    auto range = titleIndex.equal_range(key);
+    for (auto it = range.first; it != range.second; ++it) {
+        Resource* r = it->second;
+        if (r->title == title && (!exact || r->id < exact->id)) exact = r;
+        if (!normalized || r->id < normalized->id) normalized = r;
+    }
+    if (exact) { match = TITLE_EXACT; return exact->id; }
+    if (normalized) { match = TITLE_NORMALIZED; return normalized->id; }
+
+    if (allowPrefix && !key.empty()) {
+        // The Trie also indexes topics, so keep only IDs whose title has the prefix
+        Resource* best = nullptr;
+        for (int id : searchIndex->getResourcesByPrefix(key)) {
+            Resource* r = storageTree->search(id);
+            if (!r) continue;
+            std::string candidate = normalizeTitle(r->title);
+            if (candidate.compare(0, key.size(), key) != 0) continue;
+            if (!best || r->title.size() < best->title.size() ||
+                (r->title.size() == best->title.size() && r->id < best->id)) {
+                best = r;
+            }
+        }
+        if (best) { match = TITLE_PREFIX; return best->id; }
+    }
+
+    match = TITLE_NONE;
+    return -1;
+}
+
+// PLAN argument: "<title>" or "<title>|PREFIX" to allow the prefix fallback
+static void parsePlanArgument(const std::string& argument, std::string& title, bool& allowPrefix) {
+    static const std::string suffix = "|PREFIX";
+    allowPrefix = argument.size() > suffix.size() &&
+                  argument.compare(argument.size() - suffix.size(), suffix.size(), suffix) == 0;
+    title = allowPrefix ? argument.substr(0, argument.size() - suffix.size()) : argument;
+}
+
+int Engine::findTitle(const std::string& planArgument, const Session& session, TitleMatch& match) const {
+    if (session.prepared) {
+        auto it = session.prepared->titleIDs.find(planArgument);
+        if (it != session.prepared->titleIDs.end()) {
+            match = static_cast<TitleMatch>(it->second.second);
+            return it->second.first;
+        }
+    }
+    std::string title;
+    bool allowPrefix;
+    parsePlanArgument(planArgument, title, allowPrefix);
+    return lookupTitle(title, allowPrefix, match);
+}
+
+std::vector<int> Engine::findCurriculum(int targetID, const Session& session) const {
+    if (session.prepared) {
+        auto it = session.prepared->curricula.find(targetID);
+        if (it != session.prepared->curricula.end()) return it->second;
+    }
+    return depGraph->getCurriculum(targetID);
+}
+
+// =========================================================
+// STRUCTURE DUMPS
+// Serialized once per structure revision and shared by every request
+// =========================================================
+
+std::shared_ptr<const std::string> Engine::cachedDump(CachedDump& slot, unsigned long revision,
+                                                      const std::function<std::string()>& render) const {
+    std::lock_guard<std::mutex> lock(dumpMutex);
+    if (!slot.valid || slot.revision != revision) {
+        slot.text = std::make_shared<const std::string>(render());
+        slot.revision = revision;
+        slot.valid = true;
+    }
+    return slot.text;
+}
+
+// Renders "<NAME>_EDGES_START ... <NAME>_NODES_END" (the layout the UI parses)
+static std::string renderEdgesAndNodes(const std::string& name,
+                                       const std::pair<std::vector<std::string>, std::vector<std::string>>& structure) {
+    std::string text = name + "_EDGES_START\n";
+    for (const auto& edge : structure.first) text += edge + '\n';
+    text += name + "_EDGES_END\n" + name + "_NODES_START\n";
+    for (const auto& node : structure.second) text += node + '\n';
+    text += name + "_NODES_END\n";
+    return text;
+}
+
+// Renders "<NAME>_STRUCTURE_START ... <NAME>_STRUCTURE_END"
+static std::string renderItems(const std::string& name, const std::vector<std::string>& items) {
+    std::string text = name + "_STRUCTURE_START\n";
+    for (const auto& item : items) text += item + '\n';
+    text += name + "_STRUCTURE_END\n";
+    return text;
+}
+
+std::shared_ptr<const std::string> Engine::treeStructure() const {
+    return cachedDump(treeDump, storageTree->getRevision(),
+                      [this] { return renderEdgesAndNodes("TREE", storageTree->getTreeStructure()); });
+}
+
+std::shared_ptr<const std::string> Engine::trieStructure() const {
+    return cachedDump(trieDump, searchIndex->getRevision(),
+                      [this] { return renderEdgesAndNodes("TRIE", searchIndex->getStructure()); });
+}
+
+std::shared_ptr<const std::string> Engine::graphStructure() const {
+    return cachedDump(graphDump, depGraph->getRevision(),
+                      [this] { return renderEdgesAndNodes("GRAPH", depGraph->getStructure()); });
+}
+
+std::shared_ptr<const std::string> Engine::heapStructure() const {
+    return cachedDump(heapDump, ratingQueue->getRevision(),
+                      [this] { return renderItems("HEAP", ratingQueue->getStructure()); });
+}
+
+Engine::TreeStats Engine::currentTreeStats() const {
+    std::lock_guard<std::mutex> lock(dumpMutex);
+    if (!treeStats.valid || treeStats.revision != storageTree->getRevision()) {
+        treeStats.height = storageTree->getHeight();
+        treeStats.nodeCount = storageTree->getNodeCount();
+        treeStats.maxBalance = storageTree->getMaxBalance();
+        treeStats.rootBalance = storageTree->getRootBalance();
+        treeStats.revision = storageTree->getRevision();
+        treeStats.valid = true;
+    }
+    return treeStats;
+}
+
+static bool parseAnalysisLevel(const std::string& name, AnalysisLevel& level) {
+    if (name == "NONE") level = ANALYSIS_NONE;
+    else if (name == "STATS") level = ANALYSIS_STATS;
+    else if (name == "FULL") level = ANALYSIS_FULL;
+    else return false;
+    return true;
+}
+
+// Splits an optional "@LEVEL " request prefix off a command
+static std::string stripAnalysisPrefix(const std::string& command, AnalysisLevel& level) {
+    if (command.empty() || command[0] != '@') return command;
+    size_t space = command.find(' ');
+    if (space == std::string::npos) return command;
+    if (!parseAnalysisLevel(command.substr(1, space - 1), level)) return command;
+    return command.substr(space + 1);
+}
+
+void Engine::prepareBatch(const std::vector<std::string>& commands, PreparedLookups& lookups) const {
+    std::shared_lock<std::shared_mutex> lock(catalogMutex);
+    std::vector<std::string> prefixes;
+    std::vector<std::string> titles;
+
+    for (const std::string& line : commands) {
+        AnalysisLevel ignored = ANALYSIS_STATS;
+        std::string command = stripAnalysisPrefix(line, ignored);
+        size_t bar = command.find('|');
+        if (bar == std::string::npos) continue;
+        std::string action = command.substr(0, bar);
+        std::string value = command.substr(bar + 1);
+
+        if (action == "SEARCH") {
+            std::vector<std::string> parts = splitInternal(value, '|');
+            prefixes.push_back(parts.empty() ? "" : parts[0]);
+        } else if (action == "CRAM") {
+            std::vector<std::string> parts = splitInternal(value, '|');
+            if (parts.size() >= 2) prefixes.push_back(parts[0]);
+        } else if (action == "PLAN") {
+            titles.push_back(value);
+        }
+    }
+
+    // 1. Every distinct prefix walks the trie exactly once
+    std::vector<int> ids;
+    for (const std::string& prefix : prefixes) {
+        std::string key = lowerCopy(prefix);
+        if (lookups.prefixResults.count(key)) continue;
+        std::vector<int>& found = lookups.prefixResults[key];
+        found = searchIndex->getResourcesByPrefix(prefix);
+        ids.insert(ids.end(), found.begin(), found.end());
+    }
+
+    // 2. PLAN targets: title -> ID, then one curriculum per distinct target
+    Session plain;
+    for (const std::string& title : titles) {
+        if (lookups.titleIDs.count(title)) continue;
+        TitleMatch match;
+        int targetID = findTitle(title, plain, match);
+        lookups.titleIDs[title] = std::make_pair(targetID, static_cast<int>(match));
+        if (targetID == -1 || lookups.curricula.count(targetID)) continue;
+        std::vector<int>& path = lookups.curricula[targetID];
+        path = depGraph->getCurriculum(targetID);
+        ids.insert(ids.end(), path.begin(), path.end());
+    }
+
+    // 3. Resolve all IDs in ascending order (neighbouring searches share tree paths)
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    lookups.resources.reserve(ids.size());
+    for (int id : ids) {
+        Resource* r = storageTree->search(id);
+        if (r) lookups.resources[id] = r;
+    }
+}
+
+bool Engine::execute(const std::string& command) {
+    return execute(command, *defaultSession, std::cout);
+}
+
+bool Engine::execute(const std::string& request, Session& session, std::ostream& out) {
+    AnalysisLevel analysis = session.analysis;
+    std::string command = stripAnalysisPrefix(request, analysis);
+    if (command == "RELOAD") return reload(analysis, out);
+
+    const Engine& reader = *this;
+    return reader.execute(request, session, out);
+}
+
+bool Engine::execute(const std::string& request, Session& session, std::ostream& out) const {
+    AnalysisLevel analysis = session.analysis;
+    std::string command = stripAnalysisPrefix(request, analysis);
+
+    // Held for the whole command: a concurrent RELOAD is either fully visible or not at all
+    std::shared_lock<std::shared_mutex> lock(catalogMutex);
+    if (session.catalogVersion != catalogVersion) {
+        session.cache.clear(); // Cached entries may be replaced resources
+        session.catalogVersion = catalogVersion;
+    }
+
     std::string action = "";
     std::string value = "";
 
@@ -62,10 +853,83 @@ void Engine::execute(const std::string& command) {
         action = command;
     }
 
-    if (action == "LIST") handleList(value);
-    else if (action == "PLAN") handlePlan(value);
-    else if (action == "TITLES") handleTitles();
-    else if (action == "SEARCH") handleSearch(value);
+    if (action == "LIST") handleList(value, analysis, out);
+    else if (action == "PLAN") handlePlan(value, session, analysis, out);
+    else if (action == "TITLES") handleTitles(out);
+    else if (action == "SEARCH") {
+        // "Query", or "Query|Limit|Cursor" for one page (cursor: NEXT_CURSOR of the previous page)
+        std::vector<std::string> args = splitInternal(value, '|');
+        std::string query = args.empty() ? "" : args[0];
+        size_t limit = 0; // Every result
+        if (args.size() > 1) {
+            try { limit = static_cast<size_t>(std::max(0, std::stoi(args[1]))); } catch(...) { limit = 0; }
+        }
+        int64_t after = INT64_MIN;
+        if (args.size() > 2 && !args[2].empty() && !decodeCursor(args[2], query, after)) {
+            out << "ERROR:Invalid search cursor: " << args[2] << '\n';
+            return false;
+        }
+        handleSearch(query, limit, after, session, analysis, out);
+    }
+    else if (action == "COMPLETE") {
+        // Parse "Prefix|Count" (e.g. "gra|8")
+        std::vector<std::string> args = splitInternal(value, '|');
+        int k = 10;
+        if (args.size() > 1) {
+            try { k = std::stoi(args[1]); } catch(...) { k = 10; }
+        }
+        handleComplete(args.empty() ? "" : args[0], k, analysis, out);
+    }
+    else if (action == "CONTAINS") {
+        // Parse "Text|Limit" (e.g. "sort|20"); no limit returns every match.
+        // Empty text is contained in every title, so it is rejected.
+        std::vector<std::string> args = splitInternal(value, '|');
+        if (args.empty() || args[0].empty()) {
+            out << "ERROR:CONTAINS needs a text" << '\n';
+            return false;
+        }
+        size_t limit = 0;
+        if (args.size() > 1) {
+            try { limit = static_cast<size_t>(std::max(0, std::stoi(args[1]))); } catch(...) { limit = 0; }
+        }
+        handleContains(args[0], limit, session, analysis, out);
+    }
+    else if (action == "FUZZY") {
+        // Parse "Query|MaxEdits|Limit" (e.g. "dijkstar|1|20"); edits are capped at 2.
+        // An empty query matches every key within a couple of edits (most of the catalog), so it
+        // is rejected, and the limit must be 1..kMaxFuzzyLimit.
+        std::vector<std::string> args = splitInternal(value, '|');
+        int maxEdits = 1;
+        int limit = static_cast<int>(kDefaultFuzzyLimit);
+        if (args.empty() || args[0].empty()) {
+            out << "ERROR:FUZZY needs a query" << '\n';
+            return false;
+        }
+        if (args.size() > 1) {
+            try { maxEdits = std::stoi(args[1]); } catch(...) { maxEdits = 1; }
+        }
+        if (args.size() > 2 && !args[2].empty()) {
+            try { limit = std::stoi(args[2]); } catch(...) { limit = 0; }
+            if (limit < 1 || limit > static_cast<int>(kMaxFuzzyLimit)) {
+                out << "ERROR:FUZZY limit must be between 1 and " << kMaxFuzzyLimit << ": " << args[2] << '\n';
+                return false;
+            }
+        }
+        handleFuzzy(args[0], maxEdits, static_cast<size_t>(limit), session, analysis, out);
+    }
+    else if (action == "RANK") {
+        // Parse "Words|Count|RatingWeight" (e.g. "graph shortest path|10|0.5")
+        std::vector<std::string> args = splitInternal(value, '|');
+        int k = 10;
+        double ratingWeight = 0.0;
+        if (args.size() > 1) {
+            try { k = std::stoi(args[1]); } catch(...) { k = 10; }
+        }
+        if (args.size() > 2) {
+            try { ratingWeight = std::stod(args[2]); } catch(...) { ratingWeight = 0.0; }
+        }
+        handleRank(args.empty() ? "" : args[0], k, ratingWeight, session, analysis, out);
+    }
     else if (action == "SUGGEST") {
         // Parse "Count|Level" from value (e.g. "5|BEGINNER")
         int k = 5;
@@ -76,523 +940,636 @@ void Engine::execute(const std::string& command) {
             try { k = std::stoi(args[0]); } catch(...) { k = 5; }
             if (args.size() > 1) level = args[1];
         }
-        handleTopRated(k, level);
+        handleTopRated(k, level, analysis, out);
+    }
+    else if (action == "BACK") handleBack(session, out);
+    else if (action == "CRAM") return handleCram(value, session, analysis, out);
+    else if (action == "DESCRIBE") return handleDescribe(value, session, out);
+    else if (action == "RELOAD") {
+        out << "ERROR:RELOAD is not available in this mode" << '\n';
+        return false;
+    }
+    else if (action == "ANALYSIS") {
+        if (!parseAnalysisLevel(value, session.analysis)) {
+            out << "ERROR:Unknown analysis level: " << value << '\n';
+            return false;
+        }
     }
-    else if (action == "BACK") handleBack();
-    else if (action == "CRAM") handleCram(value);
     else {
-        std::cerr << "ERROR: Unknown command: " << action << std::endl;
+        out << "ERROR:Unknown command: " << action << '\n';
+        return false;
     }
+    return true;
 }
 
 // ... [Existing implementations for LIST, TITLES, PLAN, SEARCH, BACK] ...
 // (Assume handleList, handleSearch, handlePlan, handleBack, handleCram are here as previously defined)
 
-void Engine::handleList(const std::string& sortMode) {
+void Engine::handleList(const std::string& sortMode, AnalysisLevel analysis, std::ostream& out) const {
     auto start = std::chrono::high_resolution_clock::now();
     
-    // Capture tree state before operation
-    int treeHeightBefore = storageTree->getHeight();
-    int nodeCountBefore = storageTree->getNodeCount();
-    int maxBalanceBefore = storageTree->getMaxBalance();
-    
-    std::cout <<"ID,Title,URL,Topic,Difficulty,Rating,Duration" << std::endl;
+    out <<"ID,Title,URL,Topic,Difficulty,Rating,Duration" << '\n';
     std::vector<Resource*> temp = storageTree->inorderTraversal();
     
     auto traversalEnd = std::chrono::high_resolution_clock::now();
     
-    if (sortMode == "DIFFICULTY") Sorters::sortByDifficulty(temp);
-    else if (sortMode == "TOPIC") Sorters::sortByTopic(temp);
+    bool precomputed = false;
+    if (sortMode == "DIFFICULTY") {
+        if (!orderByDifficulty.empty()) { temp = orderByDifficulty; precomputed = true; }
+        else Sorters::sortByDifficulty(temp);
+    }
+    else if (sortMode == "TOPIC") {
+        if (!orderByTopic.empty()) { temp = orderByTopic; precomputed = true; }
+        else Sorters::sortByTopic(temp);
+    }
     
     auto sortEnd = std::chrono::high_resolution_clock::now();
     
-    for (Resource* r : temp) printResourceLine(r);
+    for (Resource* r : temp) printResourceLine(r, out);
     
     auto end = std::chrono::high_resolution_clock::now();
+    if (analysis == ANALYSIS_NONE) return;
     
-    // Capture tree state after operation
-    int treeHeightAfter = storageTree->getHeight();
-    int nodeCountAfter = storageTree->getNodeCount();
-    int maxBalanceAfter = storageTree->getMaxBalance();
+    TreeStats tree = currentTreeStats();
     
     // Calculate timings
     auto traversalTime = std::chrono::duration_cast<std::chrono::microseconds>(traversalEnd - start).count();
     auto sortTime = std::chrono::duration_cast<std::chrono::microseconds>(sortEnd - traversalEnd).count();
     auto totalTime = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
     
-    // Get tree structure for visualization
-    auto treeStruct = storageTree->getTreeStructure();
-    
     // Output analysis data (for UI parsing)
-    std::cout << "---ANALYSIS---" << std::endl;
-    std::cout << "OPERATION:LIST|" << sortMode << std::endl;
-    std::cout << "TREE_HEIGHT:" << treeHeightAfter << std::endl;
-    std::cout << "NODE_COUNT:" << nodeCountAfter << std::endl;
-    std::cout << "MAX_BALANCE:" << maxBalanceAfter << std::endl;
-    std::cout << "ROOT_BALANCE:" << storageTree->getRootBalance() << std::endl;
-    std::cout << "TRAVERSAL_TIME_US:" << traversalTime << std::endl;
-    std::cout << "SORT_TIME_US:" << sortTime << std::endl;
-    std::cout << "TOTAL_TIME_US:" << totalTime << std::endl;
-    std::cout << "SORT_ALGORITHM:" << (sortMode == "DIFFICULTY" ? "QUICKSORT" : (sortMode == "TOPIC" ? "MERGESORT" : "NONE")) << std::endl;
-    std::cout << "RESULT_COUNT:" << temp.size() << std::endl;
+    out << "---ANALYSIS---" << '\n';
+    out << "OPERATION:LIST|" << sortMode << '\n';
+    out << "TREE_HEIGHT:" << tree.height << '\n';
+    out << "NODE_COUNT:" << tree.nodeCount << '\n';
+    out << "MAX_BALANCE:" << tree.maxBalance << '\n';
+    out << "ROOT_BALANCE:" << tree.rootBalance << '\n';
+    out << "TRAVERSAL_TIME_US:" << traversalTime << '\n';
+    out << "SORT_TIME_US:" << sortTime << '\n';
+    out << "TOTAL_TIME_US:" << totalTime << '\n';
+    out << "SORT_ALGORITHM:" << (sortMode == "DIFFICULTY" ? "QUICKSORT" : (sortMode == "TOPIC" ? "MERGESORT" : "NONE")) << '\n';
+    out << "SORT_PRECOMPUTED:" << (precomputed ? 1 : 0) << '\n';
+    out << "RESULT_COUNT:" << temp.size() << '\n';
     
     // Output tree structure
-    std::cout << "TREE_EDGES_START" << std::endl;
-    for (const auto& edge : treeStruct.first) {
-        std::cout << edge << std::endl;
-    }
-    std::cout << "TREE_EDGES_END" << std::endl;
-    std::cout << "TREE_NODES_START" << std::endl;
-    for (const auto& node : treeStruct.second) {
-        std::cout << node << std::endl;
-    }
-    std::cout << "TREE_NODES_END" << std::endl;
+    if (analysis == ANALYSIS_FULL) out << *treeStructure();
     
-    std::cout << "---END_ANALYSIS---" << std::endl;
+    out << "---END_ANALYSIS---" << '\n';
 }
 
-void Engine::handleTitles() {
-    for (const auto* r : masterList) std::cout << r->title << std::endl;
+void Engine::handleTitles(std::ostream& out) const {
+    for (const auto* r : masterList) out << r->title << '\n';
 }
 
-void Engine::handleSearch(const std::string& query) {
+void Engine::handleSearch(const std::string& query, size_t limit, int64_t after, Session& session,
+                          AnalysisLevel analysis, std::ostream& out) const {
     auto start = std::chrono::high_resolution_clock::now();
     
-    // Capture tree state before operation
-    int treeHeightBefore = storageTree->getHeight();
-    int nodeCountBefore = storageTree->getNodeCount();
-    
-    std::vector<int> results = searchIndex->getResourcesByPrefix(query);
+    // Paged: stop after 'limit' IDs, resuming after the cursor's ID (results are in ID order)
+    bool more = false;
+    std::vector<int> results = limit > 0 ? findPageByPrefix(query, session, after, limit, more)
+                                         : findByPrefix(query, session);
+    std::string nextCursor = more ? encodeCursor(query, results.back()) : "";
     
     auto trieEnd = std::chrono::high_resolution_clock::now();
     
     if (results.empty()) {
+        if (limit > 0) out << "NEXT_CURSOR:" << '\n';
         auto end = std::chrono::high_resolution_clock::now();
+        if (analysis == ANALYSIS_NONE) return;
         auto totalTime = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        TreeStats tree = currentTreeStats();
         
-        std::cout << "---ANALYSIS---" << std::endl;
-        std::cout << "OPERATION:SEARCH|" << query << std::endl;
-        std::cout << "TREE_HEIGHT:" << treeHeightBefore << std::endl;
-        std::cout << "NODE_COUNT:" << nodeCountBefore << std::endl;
-        std::cout << "TRIE_SEARCH_TIME_US:" << std::chrono::duration_cast<std::chrono::microseconds>(trieEnd - start).count() << std::endl;
-        std::cout << "TOTAL_TIME_US:" << totalTime << std::endl;
-        std::cout << "RESULT_COUNT:0" << std::endl;
-        std::cout << "---END_ANALYSIS---" << std::endl;
+        out << "---ANALYSIS---" << '\n';
+        out << "OPERATION:SEARCH|" << query << '\n';
+        out << "TREE_HEIGHT:" << tree.height << '\n';
+        out << "NODE_COUNT:" << tree.nodeCount << '\n';
+        out << "TRIE_SEARCH_TIME_US:" << std::chrono::duration_cast<std::chrono::microseconds>(trieEnd - start).count() << '\n';
+        out << "TOTAL_TIME_US:" << totalTime << '\n';
+        out << "RESULT_COUNT:0" << '\n';
+        out << "---END_ANALYSIS---" << '\n';
         return;
     }
 
-    std::cout << "ID,Title,URL,Topic,Difficulty,Rating,Duration" << std::endl;
+    out << "ID,Title,URL,Topic,Difficulty,Rating,Duration" << '\n';
     int treeSearchCount = 0;
+    Resource* firstHit = nullptr;
     for (int id : results) {
-        Resource* r = cache->get(id, true);
+        Resource* r = session.cache.get(id);
         if (!r) {
-            r = storageTree->search(id);
-            treeSearchCount++;
-            if (r) cache->put(r, true);
+            r = findByID(id, session, treeSearchCount);
+            if (r) session.cache.put(r);
         }
         if (r) {
-            printResourceLine(r);
-            historyStack->push(r, false);
+            printResourceLine(r, out);
+            if (!firstHit) firstHit = r;
+            if (limit == 0) session.history.push(r);
         }
     }
+    if (limit > 0) {
+        // A page only records its first hit, so paging through a large result doesn't fill the history
+        addToHistory(session, firstHit);
+        out << "NEXT_CURSOR:" << nextCursor << '\n';
+    }
     
     auto end = std::chrono::high_resolution_clock::now();
+    if (analysis == ANALYSIS_NONE) return;
     
-    // Capture tree state after operation
-    int treeHeightAfter = storageTree->getHeight();
-    int nodeCountAfter = storageTree->getNodeCount();
+    TreeStats tree = currentTreeStats();
     
     // Calculate timings
     auto trieTime = std::chrono::duration_cast<std::chrono::microseconds>(trieEnd - start).count();
     auto totalTime = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
     
-    // Get tree structure for visualization
-    auto treeStruct = storageTree->getTreeStructure();
-    
-    // Get structures for visualization
-    auto trieStruct = searchIndex->getStructure();
-    auto cacheStruct = cache->getStructure();
-    auto stackStruct = historyStack->getStructure();
-    
     // Output analysis data
-    std::cout << "---ANALYSIS---" << std::endl;
-    std::cout << "OPERATION:SEARCH|" << query << std::endl;
-    std::cout << "TREE_HEIGHT:" << treeHeightAfter << std::endl;
-    std::cout << "NODE_COUNT:" << nodeCountAfter << std::endl;
-    std::cout << "MAX_BALANCE:" << storageTree->getMaxBalance() << std::endl;
-    std::cout << "ROOT_BALANCE:" << storageTree->getRootBalance() << std::endl;
-    std::cout << "TRIE_SEARCH_TIME_US:" << trieTime << std::endl;
-    std::cout << "TREE_SEARCHES:" << treeSearchCount << std::endl;
-    std::cout << "TOTAL_TIME_US:" << totalTime << std::endl;
-    std::cout << "RESULT_COUNT:" << results.size() << std::endl;
-    std::cout << "TRIE_NODE_COUNT:" << searchIndex->getNodeCount() << std::endl;
-    std::cout << "CACHE_SIZE:" << cache->size() << std::endl;
-    std::cout << "STACK_SIZE:" << (historyStack->isEmpty() ? 0 : stackStruct.size() - 1) << std::endl;
-    
-    // Output AVL Tree structure
-    std::cout << "TREE_EDGES_START" << std::endl;
-    for (const auto& edge : treeStruct.first) {
-        std::cout << edge << std::endl;
-    }
-    std::cout << "TREE_EDGES_END" << std::endl;
-    std::cout << "TREE_NODES_START" << std::endl;
-    for (const auto& node : treeStruct.second) {
-        std::cout << node << std::endl;
-    }
-    std::cout << "TREE_NODES_END" << std::endl;
-    
-    // Output Trie structure
-    std::cout << "TRIE_EDGES_START" << std::endl;
-    for (const auto& edge : trieStruct.first) {
-        std::cout << edge << std::endl;
-    }
-    std::cout << "TRIE_EDGES_END" << std::endl;
-    std::cout << "TRIE_NODES_START" << std::endl;
-    for (const auto& node : trieStruct.second) {
-        std::cout << node << std::endl;
-    }
-    std::cout << "TRIE_NODES_END" << std::endl;
-    
-    // Output LRU Cache structure
-    std::cout << "CACHE_STRUCTURE_START" << std::endl;
-    for (const auto& item : cacheStruct) {
-        std::cout << item << std::endl;
-    }
-    std::cout << "CACHE_STRUCTURE_END" << std::endl;
-    
-    // Output Stack structure
-    std::cout << "STACK_STRUCTURE_START" << std::endl;
-    for (const auto& item : stackStruct) {
-        std::cout << item << std::endl;
-    }
-    std::cout << "STACK_STRUCTURE_END" << std::endl;
-    
-    std::cout << "---END_ANALYSIS---" << std::endl;
-}
-
-void Engine::handlePlan(const std::string& targetTitle) {
+    out << "---ANALYSIS---" << '\n';
+    out << "OPERATION:SEARCH|" << query << '\n';
+    out << "TREE_HEIGHT:" << tree.height << '\n';
+    out << "NODE_COUNT:" << tree.nodeCount << '\n';
+    out << "MAX_BALANCE:" << tree.maxBalance << '\n';
+    out << "ROOT_BALANCE:" << tree.rootBalance << '\n';
+    out << "TRIE_SEARCH_TIME_US:" << trieTime << '\n';
+    out << "TREE_SEARCHES:" << treeSearchCount << '\n';
+    out << "TOTAL_TIME_US:" << totalTime << '\n';
+    out << "RESULT_COUNT:" << results.size() << '\n';
+    if (limit > 0) {
+        out << "PAGE_LIMIT:" << limit << '\n';
+        out << "HAS_MORE:" << (more ? 1 : 0) << '\n';
+    }
+    out << "TRIE_NODE_COUNT:" << searchIndex->getNodeCount() << '\n';
+    out << "CACHE_SIZE:" << session.cache.size() << '\n';
+    out << "STACK_SIZE:" << session.history.size() << '\n';
+    
+    if (analysis == ANALYSIS_FULL) {
+        // AVL Tree and Trie dumps are shared; LRU Cache and Stack belong to this session
+        out << *treeStructure();
+        out << *trieStructure();
+        out << renderItems("CACHE", session.cache.getStructure());
+        out << renderItems("STACK", session.history.getStructure());
+    }
+    
+    out << "---END_ANALYSIS---" << '\n';
+}
+
+void Engine::handlePlan(const std::string& targetTitle, const Session& session, AnalysisLevel analysis, std::ostream& out) const {
     auto start = std::chrono::high_resolution_clock::now();
     
-    int targetID = -1;
-    for (Resource* r : masterList) {
-        if (r->title == targetTitle) { targetID = r->id; break; }
-    }
+    TitleMatch match;
+    int targetID = findTitle(targetTitle, session, match);
+    auto lookupEnd = std::chrono::high_resolution_clock::now();
+    auto lookupTime = std::chrono::duration_cast<std::chrono::microseconds>(lookupEnd - start).count();
+    static const char* const matchNames[] = {"NONE", "EXACT", "NORMALIZED", "PREFIX"};
+
     if (targetID == -1) {
         auto end = std::chrono::high_resolution_clock::now();
         auto totalTime = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
         
-        std::cout << "---ANALYSIS---" << std::endl;
-        std::cout << "OPERATION:PLAN|" << targetTitle << std::endl;
-        std::cout << "TOTAL_TIME_US:" << totalTime << std::endl;
-        std::cout << "RESULT_COUNT:0" << std::endl;
-        std::cout << "ERROR:Target not found" << std::endl;
-        std::cout << "---END_ANALYSIS---" << std::endl;
+        out << "---ANALYSIS---" << '\n';
+        out << "OPERATION:PLAN|" << targetTitle << '\n';
+        out << "TITLE_LOOKUP_TIME_US:" << lookupTime << '\n';
+        out << "TOTAL_TIME_US:" << totalTime << '\n';
+        out << "RESULT_COUNT:0" << '\n';
+        out << "ERROR:Target not found" << '\n';
+        out << "---END_ANALYSIS---" << '\n';
         return;
     }
 
-    std::vector<int> path = depGraph->getCurriculum(targetID);
+    std::vector<int> path = findCurriculum(targetID, session);
     
     auto graphEnd = std::chrono::high_resolution_clock::now();
     
     if (path.empty()) {
         auto end = std::chrono::high_resolution_clock::now();
+        if (analysis == ANALYSIS_NONE) return;
         auto totalTime = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
         
-        std::cout << "---ANALYSIS---" << std::endl;
-        std::cout << "OPERATION:PLAN|" << targetTitle << std::endl;
-        std::cout << "GRAPH_SEARCH_TIME_US:" << std::chrono::duration_cast<std::chrono::microseconds>(graphEnd - start).count() << std::endl;
-        std::cout << "TOTAL_TIME_US:" << totalTime << std::endl;
-        std::cout << "RESULT_COUNT:0" << std::endl;
-        std::cout << "---END_ANALYSIS---" << std::endl;
+        out << "---ANALYSIS---" << '\n';
+        out << "OPERATION:PLAN|" << targetTitle << '\n';
+        out << "TITLE_MATCH:" << matchNames[match] << '\n';
+        out << "GRAPH_SEARCH_TIME_US:" << std::chrono::duration_cast<std::chrono::microseconds>(graphEnd - lookupEnd).count() << '\n';
+        out << "TOTAL_TIME_US:" << totalTime << '\n';
+        out << "RESULT_COUNT:0" << '\n';
+        out << "---END_ANALYSIS---" << '\n';
         return;
     }
 
-    std::cout << "ID,Title,URL,Topic,Difficulty,Rating,Duration" << std::endl;
+    out << "ID,Title,URL,Topic,Difficulty,Rating,Duration" << '\n';
     int treeSearchCount = 0;
     for (int id : path) {
-        Resource* r = storageTree->search(id);
-        treeSearchCount++;
-        if (r) printResourceLine(r);
+        Resource* r = findByID(id, session, treeSearchCount);
+        if (r) printResourceLine(r, out);
     }
     
     auto end = std::chrono::high_resolution_clock::now();
+    if (analysis == ANALYSIS_NONE) return;
     
-    auto graphTime = std::chrono::duration_cast<std::chrono::microseconds>(graphEnd - start).count();
+    auto graphTime = std::chrono::duration_cast<std::chrono::microseconds>(graphEnd - lookupEnd).count();
     auto totalTime = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-    
-    // Get structures for visualization
-    auto treeStruct = storageTree->getTreeStructure();
-    auto graphStruct = depGraph->getStructure();
-    
-    std::cout << "---ANALYSIS---" << std::endl;
-    std::cout << "OPERATION:PLAN|" << targetTitle << std::endl;
-    std::cout << "TREE_HEIGHT:" << storageTree->getHeight() << std::endl;
-    std::cout << "NODE_COUNT:" << storageTree->getNodeCount() << std::endl;
-    std::cout << "GRAPH_SEARCH_TIME_US:" << graphTime << std::endl;
-    std::cout << "TREE_SEARCHES:" << treeSearchCount << std::endl;
-    std::cout << "TOTAL_TIME_US:" << totalTime << std::endl;
-    std::cout << "RESULT_COUNT:" << path.size() << std::endl;
-    std::cout << "GRAPH_NODE_COUNT:" << depGraph->getNodeCount() << std::endl;
-    std::cout << "GRAPH_EDGE_COUNT:" << depGraph->getEdgeCount() << std::endl;
-    
-    // Output AVL Tree structure
-    std::cout << "TREE_EDGES_START" << std::endl;
-    for (const auto& edge : treeStruct.first) {
-        std::cout << edge << std::endl;
-    }
-    std::cout << "TREE_EDGES_END" << std::endl;
-    std::cout << "TREE_NODES_START" << std::endl;
-    for (const auto& node : treeStruct.second) {
-        std::cout << node << std::endl;
-    }
-    std::cout << "TREE_NODES_END" << std::endl;
-    
-    // Output Knowledge Graph structure
-    std::cout << "GRAPH_EDGES_START" << std::endl;
-    for (const auto& edge : graphStruct.first) {
-        std::cout << edge << std::endl;
-    }
-    std::cout << "GRAPH_EDGES_END" << std::endl;
-    std::cout << "GRAPH_NODES_START" << std::endl;
-    for (const auto& node : graphStruct.second) {
-        std::cout << node << std::endl;
+    TreeStats tree = currentTreeStats();
+    
+    out << "---ANALYSIS---" << '\n';
+    out << "OPERATION:PLAN|" << targetTitle << '\n';
+    out << "TREE_HEIGHT:" << tree.height << '\n';
+    out << "NODE_COUNT:" << tree.nodeCount << '\n';
+    out << "TITLE_MATCH:" << matchNames[match] << '\n';
+    out << "TITLE_LOOKUP_TIME_US:" << lookupTime << '\n';
+    out << "GRAPH_SEARCH_TIME_US:" << graphTime << '\n';
+    out << "TREE_SEARCHES:" << treeSearchCount << '\n';
+    out << "TOTAL_TIME_US:" << totalTime << '\n';
+    out << "RESULT_COUNT:" << path.size() << '\n';
+    out << "GRAPH_NODE_COUNT:" << depGraph->getNodeCount() << '\n';
+    out << "GRAPH_EDGE_COUNT:" << depGraph->getEdgeCount() << '\n';
+    
+    // Output AVL Tree and Knowledge Graph structure
+    if (analysis == ANALYSIS_FULL) {
+        out << *treeStructure();
+        out << *graphStructure();
     }
-    std::cout << "GRAPH_NODES_END" << std::endl;
     
-    std::cout << "---END_ANALYSIS---" << std::endl;
+    out << "---END_ANALYSIS---" << '\n';
 }
 
-void Engine::handleBack() {
-    if (!historyStack->isEmpty()) {
-        Resource* r = historyStack->pop(true);  // true means don't delete the resource
+void Engine::handleBack(Session& session, std::ostream& out) const {
+    if (!session.history.isEmpty()) {
+        Resource* r = session.history.pop();
         if (r) {
-            std::cout << "ID,Title,URL,Topic,Difficulty,Rating,Duration" << std::endl;
-            printResourceLine(r);
+            out << "ID,Title,URL,Topic,Difficulty,Rating,Duration" << '\n';
+            printResourceLine(r, out);
         }
     }
 }
 
-void Engine::addToHistory(Resource* resource) {
+void Engine::addToHistory(Session& session, Resource* resource) const {
     if (resource) {
         // Don't add the same resource twice in a row
-        if (historyStack->isEmpty() || 
-            historyStack->peek()->id != resource->id) {
-            historyStack->push(resource);
+        if (session.history.isEmpty() || 
+            session.history.peek()->id != resource->id) {
+            session.history.push(resource);
         }
     }
 }
 
-void Engine::handleCram(const std::string& args) {
+bool Engine::handleCram(const std::string& args, Session& session, AnalysisLevel analysis, std::ostream& out) const {
     auto start = std::chrono::high_resolution_clock::now();
     
-    std::vector<std::string> parts = splitInternal(args, '|');
-    if (parts.size() < 2) {
+    auto fail = [&](const std::string& reason) {
         auto end = std::chrono::high_resolution_clock::now();
         auto totalTime = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
         
-        std::cout << "---ANALYSIS---" << std::endl;
-        std::cout << "OPERATION:CRAM|" << args << std::endl;
-        std::cout << "TOTAL_TIME_US:" << totalTime << std::endl;
-        std::cout << "ERROR:Invalid arguments" << std::endl;
-        std::cout << "---END_ANALYSIS---" << std::endl;
-        return;
+        out << "---ANALYSIS---" << '\n';
+        out << "OPERATION:CRAM|" << args << '\n';
+        out << "TOTAL_TIME_US:" << totalTime << '\n';
+        out << "ERROR:" << reason << '\n';
+        out << "---END_ANALYSIS---" << '\n';
+    };
+
+    std::vector<std::string> parts = splitInternal(args, '|');
+    if (parts.size() < 2) {
+        fail("Invalid arguments");
+        return false;
     }
 
     std::string topic = parts[0];
     int maxTime = 0;
     try { maxTime = std::stoi(parts[1]); } catch (...) {
-        auto end = std::chrono::high_resolution_clock::now();
-        auto totalTime = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-        
-        std::cout << "---ANALYSIS---" << std::endl;
-        std::cout << "OPERATION:CRAM|" << args << std::endl;
-        std::cout << "TOTAL_TIME_US:" << totalTime << std::endl;
-        std::cout << "ERROR:Invalid time format" << std::endl;
-        std::cout << "---END_ANALYSIS---" << std::endl;
-        return;
+        fail("Invalid time format");
+        return false;
+    }
+    if (maxTime < 0 || maxTime > kMaxCramMinutes) {
+        fail("Time must be between 0 and " + std::to_string(kMaxCramMinutes) + " minutes");
+        return false;
     }
 
-    // Capture tree state before operation
-    int treeHeightBefore = storageTree->getHeight();
-    int nodeCountBefore = storageTree->getNodeCount();
-    
-    std::vector<int> candidateIDs = searchIndex->getResourcesByPrefix(topic);
+    std::vector<int> candidateIDs = findByPrefix(topic, session);
     
     auto trieEnd = std::chrono::high_resolution_clock::now();
     
-    std::vector<Resource*> candidates;
-    int treeSearchCount = 0;
-    for (int id : candidateIDs) {
-        Resource* r = cache->get(id, false);
-        if (!r) {
-            r = storageTree->search(id);
-            treeSearchCount++;
-            if (r) cache->put(r, false);
-        }
-        if (r) candidates.push_back(r);
+    // Candidate rows, then their durations and ratings straight from the columns
+    Selection candidates;
+    columns.selectIDs(candidateIDs, candidates);
+    std::vector<int> durations(candidates.size());
+    std::vector<double> ratings(candidates.size());
+    for (size_t i = 0; i < candidates.size(); i++) {
+        durations[i] = columns.durationColumn()[candidates[i]];
+        ratings[i] = columns.ratingColumn()[candidates[i]];
+    }
+    if ((candidates.size() + 1) * static_cast<size_t>(maxTime + 1) > kMaxCramCells) {
+        fail("Too many candidates (" + std::to_string(candidates.size()) + ") for " +
+             std::to_string(maxTime) + " minutes, narrow the topic");
+        return false;
     }
     
     auto searchEnd = std::chrono::high_resolution_clock::now();
     
-    std::vector<Resource*> bestPlan = Optimizer::maximizeRating(candidates, maxTime);
+    std::vector<size_t> bestPlan = Optimizer::maximizeRating(durations.data(), ratings.data(), candidates.size(), maxTime);
     
     auto optimizeEnd = std::chrono::high_resolution_clock::now();
     
-    std::cout << "ID,Title,URL,Topic,Difficulty,Rating,Duration" << std::endl;
-    for (Resource* r : bestPlan) printResourceLine(r);
+    out << "ID,Title,URL,Topic,Difficulty,Rating,Duration" << '\n';
+    for (size_t i : bestPlan) printResourceLine(columns.row(candidates[i]), out);
     
     auto end = std::chrono::high_resolution_clock::now();
+    if (analysis == ANALYSIS_NONE) return true;
     
     // Calculate timings
     auto trieTime = std::chrono::duration_cast<std::chrono::microseconds>(trieEnd - start).count();
-    auto searchTime = std::chrono::duration_cast<std::chrono::microseconds>(searchEnd - trieEnd).count();
+    auto lookupTime = std::chrono::duration_cast<std::chrono::microseconds>(searchEnd - trieEnd).count();
     auto optimizeTime = std::chrono::duration_cast<std::chrono::microseconds>(optimizeEnd - searchEnd).count();
     auto totalTime = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-    
-    // Get structures for visualization
-    auto treeStruct = storageTree->getTreeStructure();
-    auto trieStruct = searchIndex->getStructure();
-    auto cacheStruct = cache->getStructure();
+    TreeStats tree = currentTreeStats();
     
     // Output analysis data
-    std::cout << "---ANALYSIS---" << std::endl;
-    std::cout << "OPERATION:CRAM|" << topic << "|" << maxTime << std::endl;
-    std::cout << "TREE_HEIGHT:" << treeHeightBefore << std::endl;
-    std::cout << "NODE_COUNT:" << nodeCountBefore << std::endl;
-    std::cout << "TRIE_SEARCH_TIME_US:" << trieTime << std::endl;
-    std::cout << "TREE_SEARCH_TIME_US:" << searchTime << std::endl;
-    std::cout << "OPTIMIZER_TIME_US:" << optimizeTime << std::endl;
-    std::cout << "TREE_SEARCHES:" << treeSearchCount << std::endl;
-    std::cout << "CANDIDATES:" << candidates.size() << std::endl;
-    std::cout << "TOTAL_TIME_US:" << totalTime << std::endl;
-    std::cout << "DATA_STRUCTURE:KNAPSACK_DP" << std::endl;
-    std::cout << "RESULT_COUNT:" << bestPlan.size() << std::endl;
-    std::cout << "TRIE_NODE_COUNT:" << searchIndex->getNodeCount() << std::endl;
-    std::cout << "CACHE_SIZE:" << cache->size() << std::endl;
-    
-    // Output AVL Tree structure
-    std::cout << "TREE_EDGES_START" << std::endl;
-    for (const auto& edge : treeStruct.first) {
-        std::cout << edge << std::endl;
-    }
-    std::cout << "TREE_EDGES_END" << std::endl;
-    std::cout << "TREE_NODES_START" << std::endl;
-    for (const auto& node : treeStruct.second) {
-        std::cout << node << std::endl;
-    }
-    std::cout << "TREE_NODES_END" << std::endl;
-    
-    // Output Trie structure
-    std::cout << "TRIE_EDGES_START" << std::endl;
-    for (const auto& edge : trieStruct.first) {
-        std::cout << edge << std::endl;
-    }
-    std::cout << "TRIE_EDGES_END" << std::endl;
-    std::cout << "TRIE_NODES_START" << std::endl;
-    for (const auto& node : trieStruct.second) {
-        std::cout << node << std::endl;
-    }
-    std::cout << "TRIE_NODES_END" << std::endl;
-    
-    // Output LRU Cache structure
-    std::cout << "CACHE_STRUCTURE_START" << std::endl;
-    for (const auto& item : cacheStruct) {
-        std::cout << item << std::endl;
-    }
-    std::cout << "CACHE_STRUCTURE_END" << std::endl;
-    
-    std::cout << "---END_ANALYSIS---" << std::endl;
+    out << "---ANALYSIS---" << '\n';
+    out << "OPERATION:CRAM|" << topic << "|" << maxTime << '\n';
+    out << "TREE_HEIGHT:" << tree.height << '\n';
+    out << "NODE_COUNT:" << tree.nodeCount << '\n';
+    out << "TRIE_SEARCH_TIME_US:" << trieTime << '\n';
+    out << "COLUMN_LOOKUP_TIME_US:" << lookupTime << '\n';
+    out << "OPTIMIZER_TIME_US:" << optimizeTime << '\n';
+    out << "CANDIDATES:" << candidates.size() << '\n';
+    out << "TOTAL_TIME_US:" << totalTime << '\n';
+    out << "DATA_STRUCTURE:KNAPSACK_DP" << '\n';
+    out << "RESULT_COUNT:" << bestPlan.size() << '\n';
+    out << "TRIE_NODE_COUNT:" << searchIndex->getNodeCount() << '\n';
+    
+    if (analysis == ANALYSIS_FULL) {
+        out << *treeStructure();
+        out << *trieStructure();
+    }
+    
+    out << "---END_ANALYSIS---" << '\n';
+    return true;
 }
 
 // --- NEW: Smart Recommendations using MaxHeap ---
-void Engine::handleTopRated(int k, const std::string& difficultyLevel) {
+void Engine::handleTopRated(int k, const std::string& difficultyLevel, AnalysisLevel analysis, std::ostream& out) const {
     auto start = std::chrono::high_resolution_clock::now();
     
-    // Capture tree state before operation
-    int treeHeightBefore = storageTree->getHeight();
-    int nodeCountBefore = storageTree->getNodeCount();
-    
-    // 1. Create a filtered subset based on Difficulty
-    MaxHeap tempHeap;
-    
+    // 1. Filter the difficulty column into a selection vector (SIMD scan, no pointer chasing)
     auto filterStart = std::chrono::high_resolution_clock::now();
-    int filteredCount = 0;
-
-    for(Resource* r : masterList) {
-        bool include = false;
-
-        if (difficultyLevel == "ALL") {
-            include = true;
-        } else if (difficultyLevel == "BEGINNER") {
-            if (r->difficulty <= 35) include = true;
-        } else if (difficultyLevel == "INTERMEDIATE") {
-            if (r->difficulty > 35 && r->difficulty <= 70) include = true;
-        } else if (difficultyLevel == "ADVANCED") {
-            if (r->difficulty > 70) include = true;
-        }
-
-        // 2. Insert filtered items into Heap (O(log N))
-        if (include) {
-            tempHeap.insert(r, false);
-            filteredCount++;
-        }
+    Selection selected;
+    if (difficultyLevel == "ALL") {
+        columns.selectAll(selected);
+    } else if (difficultyLevel == "BEGINNER") {
+        columns.selectRange(ColumnStore::DIFFICULTY, INT_MIN, 35, selected);
+    } else if (difficultyLevel == "INTERMEDIATE") {
+        columns.selectRange(ColumnStore::DIFFICULTY, 36, 70, selected);
+    } else if (difficultyLevel == "ADVANCED") {
+        columns.selectRange(ColumnStore::DIFFICULTY, 71, INT_MAX, selected);
     }
+    int filteredCount = static_cast<int>(selected.size());
     
-    auto heapBuildEnd = std::chrono::high_resolution_clock::now();
+    auto filterEnd = std::chrono::high_resolution_clock::now();
+
+    // 2. Top K by rating over the rating column (SIMD threshold scan, bounded heap)
+    Selection top;
+    size_t heapPushes = columns.topByRating(selected, k > 0 ? static_cast<size_t>(k) : 0, top);
 
-    // 3. Extract Top K (O(k log N))
-    std::cout << "ID,Title,URL,Topic,Difficulty,Rating,Duration" << std::endl;
+    out << "ID,Title,URL,Topic,Difficulty,Rating,Duration" << '\n';
     int extractedCount = 0;
-    for(int i=0; i<k; i++) {
-        if(tempHeap.isEmpty()) break;
-        Resource* r = tempHeap.extractMax(false);
-        if(r) {
-            printResourceLine(r);
-            extractedCount++;
-        }
+    for (uint32_t row : top) {
+        printResourceLine(columns.row(row), out);
+        extractedCount++;
     }
     
     auto end = std::chrono::high_resolution_clock::now();
+    if (analysis == ANALYSIS_NONE) return;
     
     // Calculate timings
-    auto filterTime = std::chrono::duration_cast<std::chrono::microseconds>(heapBuildEnd - filterStart).count();
+    auto filterTime = std::chrono::duration_cast<std::chrono::microseconds>(filterEnd - filterStart).count();
     auto totalTime = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-    
-    // Get structures for visualization
-    auto treeStruct = storageTree->getTreeStructure();
-    auto heapStruct = tempHeap.getStructure();
+    TreeStats tree = currentTreeStats();
     
     // Output analysis data
-    std::cout << "---ANALYSIS---" << std::endl;
-    std::cout << "OPERATION:SUGGEST|" << k << "|" << difficultyLevel << std::endl;
-    std::cout << "TREE_HEIGHT:" << treeHeightBefore << std::endl;
-    std::cout << "NODE_COUNT:" << nodeCountBefore << std::endl;
-    std::cout << "FILTER_TIME_US:" << filterTime << std::endl;
-    std::cout << "HEAP_OPERATIONS:" << filteredCount << std::endl;
-    std::cout << "EXTRACTED_COUNT:" << extractedCount << std::endl;
-    std::cout << "TOTAL_TIME_US:" << totalTime << std::endl;
-    std::cout << "DATA_STRUCTURE:MAXHEAP" << std::endl;
-    std::cout << "RESULT_COUNT:" << extractedCount << std::endl;
-    std::cout << "HEAP_SIZE:" << tempHeap.getSize() << std::endl;
-    
-    // Output AVL Tree structure
-    std::cout << "TREE_EDGES_START" << std::endl;
-    for (const auto& edge : treeStruct.first) {
-        std::cout << edge << std::endl;
-    }
-    std::cout << "TREE_EDGES_END" << std::endl;
-    std::cout << "TREE_NODES_START" << std::endl;
-    for (const auto& node : treeStruct.second) {
-        std::cout << node << std::endl;
-    }
-    std::cout << "TREE_NODES_END" << std::endl;
-    
-    // Output MaxHeap structure
-    std::cout << "HEAP_STRUCTURE_START" << std::endl;
-    for (const auto& item : heapStruct) {
-        std::cout << item << std::endl;
-    }
-    std::cout << "HEAP_STRUCTURE_END" << std::endl;
-    
-    std::cout << "---END_ANALYSIS---" << std::endl;
-}
\ No newline at end of file
+    out << "---ANALYSIS---" << '\n';
+    out << "OPERATION:SUGGEST|" << k << "|" << difficultyLevel << '\n';
+    out << "TREE_HEIGHT:" << tree.height << '\n';
+    out << "NODE_COUNT:" << tree.nodeCount << '\n';
+    out << "FILTER_TIME_US:" << filterTime << '\n';
+    out << "HEAP_OPERATIONS:" << heapPushes << '\n';
+    out << "EXTRACTED_COUNT:" << extractedCount << '\n';
+    out << "TOTAL_TIME_US:" << totalTime << '\n';
+    out << "DATA_STRUCTURE:MAXHEAP" << '\n';
+    out << "RESULT_COUNT:" << extractedCount << '\n';
+    out << "HEAP_SIZE:" << (filteredCount - extractedCount) << '\n';
+    
+    // The filtered heap is built per request, so only the AVL dump can be shared
+    if (analysis == ANALYSIS_FULL) {
+        MaxHeap tempHeap;
+        std::vector<char> extracted(columns.size(), 0);
+        for (uint32_t row : top) extracted[row] = 1;
+        for (uint32_t row : selected) {
+            if (!extracted[row]) tempHeap.insert(columns.row(row));
+        }
+        out << *treeStructure();
+        out << renderItems("HEAP", tempHeap.getStructure());
+    }
+    
+    out << "---END_ANALYSIS---" << '\n';
+}
+
+// --- Autocomplete: best-rated distinct titles/topics for a prefix, from the Trie's precomputed top lists ---
+void Engine::handleComplete(const std::string& prefix, int k, AnalysisLevel analysis, std::ostream& out) const {
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<TrieCompletion> found = searchIndex->complete(prefix, k > 0 ? static_cast<size_t>(k) : 0);
+    auto trieEnd = std::chrono::high_resolution_clock::now();
+
+    // Keys are stored lowercased: show the best resource's own spelling of the title or topic
+    out << "Completion,ID,Rating,Count" << '\n';
+    for (const TrieCompletion& c : found) {
+        std::string text = c.key;
+        Resource* r = storageTree->search(c.bestID);
+        if (r && lowerCopy(std::string(r->title)) == c.key) text = std::string(r->title);
+        else if (r && lowerCopy(std::string(r->topic.name())) == c.key) text = std::string(r->topic.name());
+        out << text << "," << c.bestID << "," << (r ? r->rating : c.rating) << "," << c.count << '\n';
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    if (analysis == ANALYSIS_NONE) return;
+
+    out << "---ANALYSIS---" << '\n';
+    out << "OPERATION:COMPLETE|" << prefix << "|" << k << '\n';
+    out << "TRIE_SEARCH_TIME_US:" << std::chrono::duration_cast<std::chrono::microseconds>(trieEnd - start).count() << '\n';
+    out << "TOTAL_TIME_US:" << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << '\n';
+    out << "DATA_STRUCTURE:TRIE_TOPK" << '\n';
+    out << "RESULT_COUNT:" << found.size() << '\n';
+    out << "TRIE_NODE_COUNT:" << searchIndex->getNodeCount() << '\n';
+    out << "---END_ANALYSIS---" << '\n';
+}
+
+// --- Substring search: titles/topics containing the text anywhere, via the trigram index ---
+void Engine::handleContains(const std::string& text, size_t limit, Session& session, AnalysisLevel analysis, std::ostream& out) const {
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<uint32_t> rows;
+    NGramIndex::Stats stats;
+    ensureInfixIndex();
+    infixIndex.find(text, rows, &stats);
+
+    // ID order from the ID column (same rows as the index), touching only the resources printed
+    const int32_t* ids = columns.idColumn();
+    auto byID = [ids](uint32_t a, uint32_t b) { return ids[a] < ids[b] || (ids[a] == ids[b] && a < b); };
+    size_t total = rows.size();
+    if (limit > 0 && rows.size() > limit) {
+        std::partial_sort(rows.begin(), rows.begin() + limit, rows.end(), byID);
+        rows.resize(limit);
+    } else {
+        std::sort(rows.begin(), rows.end(), byID);
+    }
+    std::vector<Resource*> results;
+    results.reserve(rows.size());
+    for (uint32_t row : rows) results.push_back(infixIndex.row(row));
+    auto indexEnd = std::chrono::high_resolution_clock::now();
+
+    if (!results.empty()) {
+        out << "ID,Title,URL,Topic,Difficulty,Rating,Duration" << '\n';
+        for (Resource* r : results) printResourceLine(r, out);
+        addToHistory(session, results.front()); // Only the first match: a short query can list the whole catalog
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    if (analysis == ANALYSIS_NONE) return;
+
+    out << "---ANALYSIS---" << '\n';
+    out << "OPERATION:CONTAINS|" << text << '\n';
+    out << "NGRAM_SEARCH_TIME_US:" << std::chrono::duration_cast<std::chrono::microseconds>(indexEnd - start).count() << '\n';
+    out << "TOTAL_TIME_US:" << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << '\n';
+    out << "DATA_STRUCTURE:NGRAM_INDEX" << '\n';
+    out << "LISTS_READ:" << stats.listsRead << '\n';
+    out << "BLOCKS_DECODED:" << stats.blocksDecoded << '\n';
+    out << "CANDIDATES:" << stats.candidates << '\n';
+    out << "MATCH_COUNT:" << total << '\n';
+    out << "RESULT_COUNT:" << results.size() << '\n';
+    out << "NGRAM_COUNT:" << infixIndex.gramCount() << '\n';
+    out << "STACK_SIZE:" << session.history.size() << '\n';
+    out << "---END_ANALYSIS---" << '\n';
+}
+
+// --- Typo-tolerant search: keys starting within a few edits of the query (Levenshtein automaton over the Trie) ---
+void Engine::handleFuzzy(const std::string& query, int maxEdits, size_t limit, Session& session,
+                         AnalysisLevel analysis, std::ostream& out) const {
+    auto start = std::chrono::high_resolution_clock::now();
+    uint32_t edits = static_cast<uint32_t>(std::min<int>(std::max(0, maxEdits), FrozenTrie::kMaxFuzzyEdits));
+    size_t rowsComputed = 0;
+    // Closest first, so the walk keeps the best 'limit' and skips collecting the rest
+    std::vector<TrieFuzzyMatch> matches = searchIndex->fuzzySearch(query, edits, limit, &rowsComputed);
+    auto trieEnd = std::chrono::high_resolution_clock::now();
+
+    std::vector<size_t> byEdits(edits + 1, 0);
+    int treeSearchCount = 0;
+    if (!matches.empty()) out << "ID,Title,URL,Topic,Difficulty,Rating,Duration" << '\n';
+    Resource* closest = nullptr;
+    for (const TrieFuzzyMatch& m : matches) {
+        byEdits[m.edits]++;
+        Resource* r = findByID(m.id, session, treeSearchCount);
+        if (r) {
+            printResourceLine(r, out);
+            if (!closest) closest = r;
+        }
+    }
+    addToHistory(session, closest); // Only the closest match
+
+    auto end = std::chrono::high_resolution_clock::now();
+    if (analysis == ANALYSIS_NONE) return;
+
+    out << "---ANALYSIS---" << '\n';
+    out << "OPERATION:FUZZY|" << query << "|" << edits << '\n';
+    out << "TRIE_SEARCH_TIME_US:" << std::chrono::duration_cast<std::chrono::microseconds>(trieEnd - start).count() << '\n';
+    out << "TOTAL_TIME_US:" << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << '\n';
+    out << "DATA_STRUCTURE:TRIE_LEVENSHTEIN" << '\n';
+    out << "AUTOMATON_STEPS:" << rowsComputed << '\n';
+    for (uint32_t e = 0; e <= edits; e++) out << "MATCHES_AT_" << e << "_EDITS:" << byEdits[e] << '\n';
+    out << "TREE_SEARCHES:" << treeSearchCount << '\n';
+    out << "RESULT_COUNT:" << matches.size() << '\n';
+    out << "TRIE_NODE_COUNT:" << searchIndex->getNodeCount() << '\n';
+    out << "STACK_SIZE:" << session.history.size() << '\n';
+    out << "---END_ANALYSIS---" << '\n';
+}
+
+// --- Ranked word search: BM25 over title and topic words (plus a rating bonus), top k by WAND ---
+void Engine::handleRank(const std::string& query, int k, double ratingWeight, Session& session,
+                        AnalysisLevel analysis, std::ostream& out) const {
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<TextIndex::Hit> hits;
+    TextIndex::Stats stats;
+    ensureTextIndex();
+    textIndex.topK(query, k > 0 ? static_cast<size_t>(k) : 0, ratingWeight, hits, &stats);
+    auto indexEnd = std::chrono::high_resolution_clock::now();
+
+    if (!hits.empty()) {
+        out << "ID,Title,URL,Topic,Difficulty,Rating,Duration" << '\n';
+        for (const TextIndex::Hit& hit : hits) printResourceLine(textIndex.row(hit.row), out);
+        addToHistory(session, textIndex.row(hits.front().row)); // Only the best hit
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    if (analysis == ANALYSIS_NONE) return;
+
+    out << "---ANALYSIS---" << '\n';
+    out << "OPERATION:RANK|" << query << "|" << k << '\n';
+    out << "TEXT_SEARCH_TIME_US:" << std::chrono::duration_cast<std::chrono::microseconds>(indexEnd - start).count() << '\n';
+    out << "TOTAL_TIME_US:" << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << '\n';
+    out << "DATA_STRUCTURE:INVERTED_INDEX_WAND" << '\n';
+    out << "RATING_WEIGHT:" << std::max(0.0, ratingWeight) << '\n';
+    out << "QUERY_TERMS:" << stats.terms << '\n';
+    out << "POSTINGS:" << stats.postings << '\n';
+    out << "BLOCKS_DECODED:" << stats.blocksDecoded << '\n';
+    out << "BLOCKS_SKIPPED:" << stats.blocksSkipped << '\n';
+    out << "DOCS_SCORED:" << stats.scored << '\n';
+    out << "RESULT_COUNT:" << hits.size() << '\n';
+    if (!hits.empty()) {
+        out << "TOP_SCORE:" << hits.front().score << '\n';
+        out << "KTH_SCORE:" << hits.back().score << '\n';
+    }
+    out << "TERM_COUNT:" << textIndex.termCount() << '\n';
+    out << "STACK_SIZE:" << session.history.size() << '\n';
+    out << "---END_ANALYSIS---" << '\n';
+}
+
+// --- Structure introspection: DESCRIBE|AVL, TRIE, GRAPH, HEAP, CACHE, STACK ---
+bool Engine::handleDescribe(const std::string& target, Session& session, std::ostream& out) const {
+    auto start = std::chrono::high_resolution_clock::now();
+    std::string what = target;
+    for (char& c : what) c = static_cast<char>(toupper(c));
+
+    std::ostringstream body;
+    if (what == "AVL" || what == "TREE") {
+        TreeStats tree = currentTreeStats();
+        body << "TREE_HEIGHT:" << tree.height << '\n';
+        body << "NODE_COUNT:" << tree.nodeCount << '\n';
+        body << "MAX_BALANCE:" << tree.maxBalance << '\n';
+        body << "ROOT_BALANCE:" << tree.rootBalance << '\n';
+        body << *treeStructure();
+    }
+    else if (what == "TRIE") {
+        body << "TRIE_NODE_COUNT:" << searchIndex->getNodeCount() << '\n';
+        body << *trieStructure();
+    }
+    else if (what == "GRAPH") {
+        body << "GRAPH_NODE_COUNT:" << depGraph->getNodeCount() << '\n';
+        body << "GRAPH_EDGE_COUNT:" << depGraph->getEdgeCount() << '\n';
+        body << *graphStructure();
+    }
+    else if (what == "HEAP") {
+        body << *heapStructure(); // Starts with its own HEAP_SIZE line
+    }
+    else if (what == "CACHE") {
+        body << "CACHE_SIZE:" << session.cache.size() << '\n';
+        body << renderItems("CACHE", session.cache.getStructure());
+    }
+    else if (what == "STACK") {
+        body << "STACK_SIZE:" << session.history.size() << '\n';
+        body << renderItems("STACK", session.history.getStructure());
+    }
+    else {
+        out << "ERROR:Unknown structure: " << target << '\n';
+        return false;
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    out << "---ANALYSIS---" << '\n';
+    out << "OPERATION:DESCRIBE|" << what << '\n';
+    out << "TOTAL_TIME_US:" << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << '\n';
+    out << body.str();
+    out << "---END_ANALYSIS---" << '\n';
+    return true;
+}
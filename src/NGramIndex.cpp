@@ -0,0 +1,423 @@
+#include "../include/NGramIndex.h"
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+
+namespace {
+
+    unsigned char lower(char c) { return static_cast<unsigned char>(std::tolower(static_cast<unsigned char>(c))); }
+
+    uint32_t gramAt(std::string_view lowerText, size_t i) {
+        return (static_cast<uint32_t>(static_cast<unsigned char>(lowerText[i])) << 16) |
+               (static_cast<uint32_t>(static_cast<unsigned char>(lowerText[i + 1])) << 8) |
+               static_cast<uint32_t>(static_cast<unsigned char>(lowerText[i + 2]));
+    }
+
+    // Appends 'text' lowercased to 'buffer' and its trigrams to 'out'
+    void appendText(std::string_view text, std::vector<char>& buffer, std::vector<uint32_t>& out) {
+        size_t start = buffer.size();
+        for (char c : text) buffer.push_back(static_cast<char>(lower(c)));
+        std::string_view lowered(buffer.data() + start, text.size());
+        for (size_t i = 0; i + 3 <= lowered.size(); i++) out.push_back(gramAt(lowered, i));
+    }
+
+    // Appends a row's lowercased text ("title<sep>topic<sep>") to 'buffer' and its distinct trigrams to 'out'
+    void appendRow(const Resource* r, std::vector<char>& buffer, std::vector<uint32_t>& out) {
+        out.clear();
+        appendText(r->title, buffer, out);
+        buffer.push_back(NGramIndex::kSeparator);
+        appendText(r->topic.name(), buffer, out);
+        buffer.push_back(NGramIndex::kSeparator); // A short query's scan must not run on into the next row
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+    }
+
+    // Distinct trigrams of text already stored by appendRow (grams never span a separator)
+    void rowGramsOf(std::string_view rowText, std::vector<uint32_t>& out) {
+        out.clear();
+        size_t start = 0;
+        while (start < rowText.size()) {
+            size_t end = rowText.find(NGramIndex::kSeparator, start);
+            if (end == std::string_view::npos) end = rowText.size();
+            for (size_t i = start; i + 3 <= end; i++) out.push_back(gramAt(rowText, i));
+            start = end + 1;
+        }
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+    }
+
+    void putVarint(std::vector<uint8_t>& out, uint32_t v) {
+        while (v >= 0x80) {
+            out.push_back(static_cast<uint8_t>(v | 0x80));
+            v >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(v));
+    }
+
+    uint32_t getVarint(const uint8_t*& p) {
+        uint32_t v = 0;
+        for (int shift = 0;; shift += 7) {
+            uint8_t b = *p++;
+            v |= static_cast<uint32_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) return v;
+        }
+    }
+
+    // Same, but fails instead of reading past 'end' or overflowing (for data read from a file)
+    bool getVarint(const uint8_t*& p, const uint8_t* end, uint32_t& v) {
+        v = 0;
+        for (int shift = 0; shift < 32 && p < end; shift += 7) {
+            uint8_t b = *p++;
+            v |= static_cast<uint32_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) return true;
+        }
+        return false;
+    }
+
+    // One gram's list while building: encoded as rows arrive (rows arrive ascending)
+    struct ListBuilder {
+        std::vector<uint8_t> bytes;
+        std::vector<uint32_t> blockFirst, blockOffset;
+        uint32_t last = 0;
+        uint32_t count = 0;
+
+        void add(uint32_t row) {
+            if (count % NGramIndex::kBlockSize == 0) {
+                blockFirst.push_back(row);
+                blockOffset.push_back(static_cast<uint32_t>(bytes.size()));
+                last = row;
+            }
+            putVarint(bytes, row - last);
+            last = row;
+            count++;
+        }
+    };
+
+}
+
+void NGramIndex::build(const std::vector<Resource*>& list) {
+    clear();
+    rows = list;
+
+    std::unordered_map<uint32_t, ListBuilder> lists;
+    std::vector<uint32_t> rowGrams;
+    textOffsets.reserve(rows.size() + 1);
+    for (uint32_t row = 0; row < rows.size(); row++) {
+        textOffsets.push_back(static_cast<uint32_t>(text.size()));
+        appendRow(rows[row], text, rowGrams);
+        for (uint32_t gram : rowGrams) lists[gram].add(row);
+    }
+    textOffsets.push_back(static_cast<uint32_t>(text.size()));
+    text.shrink_to_fit();
+
+    // Lay the lists out in gram order
+    grams.reserve(lists.size());
+    for (const auto& entry : lists) grams.push_back(entry.first);
+    std::sort(grams.begin(), grams.end());
+    counts.reserve(grams.size());
+    skipOffsets.reserve(grams.size() + 1);
+    for (uint32_t gram : grams) {
+        ListBuilder& b = lists[gram];
+        uint32_t base = static_cast<uint32_t>(data.size());
+        counts.push_back(b.count);
+        skipOffsets.push_back(static_cast<uint32_t>(skips.size()));
+        for (size_t i = 0; i < b.blockFirst.size(); i++) skips.push_back(Skip{b.blockFirst[i], base + b.blockOffset[i]});
+        data.insert(data.end(), b.bytes.begin(), b.bytes.end());
+        ListBuilder().bytes.swap(b.bytes);
+    }
+    skipOffsets.push_back(static_cast<uint32_t>(skips.size()));
+    data.shrink_to_fit();
+    skips.shrink_to_fit();
+}
+
+void NGramIndex::update(const NGramIndex& base, const std::vector<Resource*>& list, const std::vector<uint32_t>& changedRows) {
+    clear();
+    rows = list;
+    size_t oldCount = base.rows.size();
+    std::vector<char> changed(rows.size(), 0);
+    for (uint32_t row : changedRows) changed[row] = 1;
+
+    // 1. Text: unchanged rows copy theirs. Collect (gram, row) pairs leaving and entering the lists:
+    //    the old grams of changed and dropped rows, and the new grams of changed rows.
+    std::vector<std::pair<uint32_t, uint32_t>> leaving, entering;
+    std::vector<uint32_t> rowGrams;
+    auto oldText = [&base](uint32_t row) {
+        return std::string_view(base.text.data() + base.textOffsets[row], base.textOffsets[row + 1] - base.textOffsets[row]);
+    };
+    textOffsets.reserve(rows.size() + 1);
+    text.reserve(base.text.size());
+    for (uint32_t row = 0; row < rows.size(); row++) {
+        textOffsets.push_back(static_cast<uint32_t>(text.size()));
+        if (row < oldCount && !changed[row]) {
+            std::string_view kept = oldText(row);
+            text.insert(text.end(), kept.begin(), kept.end());
+            continue;
+        }
+        if (row < oldCount) {
+            rowGramsOf(oldText(row), rowGrams);
+            for (uint32_t gram : rowGrams) leaving.push_back(std::make_pair(gram, row));
+        }
+        appendRow(rows[row], text, rowGrams);
+        for (uint32_t gram : rowGrams) entering.push_back(std::make_pair(gram, row));
+    }
+    textOffsets.push_back(static_cast<uint32_t>(text.size()));
+    for (uint32_t row = static_cast<uint32_t>(rows.size()); row < oldCount; row++) {
+        rowGramsOf(oldText(row), rowGrams);
+        for (uint32_t gram : rowGrams) leaving.push_back(std::make_pair(gram, row));
+    }
+    std::sort(leaving.begin(), leaving.end());
+    std::sort(entering.begin(), entering.end());
+
+    // 2. Walk base's grams and the touched ones in gram order. Untouched lists keep their
+    //    bytes (skips shifted to the new offset); touched ones are decoded, edited, re-encoded.
+    grams.reserve(base.grams.size());
+    counts.reserve(base.grams.size());
+    skipOffsets.reserve(base.grams.size() + 1);
+    skips.reserve(base.skips.size());
+    data.reserve(base.data.size());
+    size_t g = 0, l = 0, e = 0;
+    std::vector<uint32_t> posting, block, drop, add, edited;
+    while (g < base.grams.size() || l < leaving.size() || e < entering.size()) {
+        uint32_t gram = UINT32_MAX;
+        if (g < base.grams.size()) gram = std::min(gram, base.grams[g]);
+        if (l < leaving.size()) gram = std::min(gram, leaving[l].first);
+        if (e < entering.size()) gram = std::min(gram, entering[e].first);
+        bool inBase = g < base.grams.size() && base.grams[g] == gram;
+
+        drop.clear();
+        add.clear();
+        for (; l < leaving.size() && leaving[l].first == gram; l++) drop.push_back(leaving[l].second);
+        for (; e < entering.size() && entering[e].first == gram; e++) add.push_back(entering[e].second);
+
+        if (inBase && drop.empty() && add.empty()) {
+            uint32_t begin = base.skips[base.skipOffsets[g]].offset;
+            uint32_t end = g + 1 < base.grams.size() ? base.skips[base.skipOffsets[g + 1]].offset
+                                                     : static_cast<uint32_t>(base.data.size());
+            uint32_t shift = static_cast<uint32_t>(data.size()) - begin;
+            grams.push_back(gram);
+            counts.push_back(base.counts[g]);
+            skipOffsets.push_back(static_cast<uint32_t>(skips.size()));
+            for (uint32_t k = base.skipOffsets[g]; k < base.skipOffsets[g + 1]; k++) {
+                skips.push_back(Skip{base.skips[k].firstRow, base.skips[k].offset + shift});
+            }
+            data.insert(data.end(), base.data.begin() + begin, base.data.begin() + end);
+            g++;
+            continue;
+        }
+
+        posting.clear();
+        if (inBase) {
+            for (size_t b = 0; b * kBlockSize < base.counts[g]; b++) {
+                base.decodeBlock(g, b, block);
+                posting.insert(posting.end(), block.begin(), block.end());
+            }
+            g++;
+        }
+        edited.clear();
+        std::set_difference(posting.begin(), posting.end(), drop.begin(), drop.end(), std::back_inserter(edited));
+        posting.clear();
+        std::merge(edited.begin(), edited.end(), add.begin(), add.end(), std::back_inserter(posting));
+        if (posting.empty()) continue; // No row has this gram any more
+
+        ListBuilder b;
+        for (uint32_t row : posting) b.add(row);
+        uint32_t at = static_cast<uint32_t>(data.size());
+        grams.push_back(gram);
+        counts.push_back(b.count);
+        skipOffsets.push_back(static_cast<uint32_t>(skips.size()));
+        for (size_t i = 0; i < b.blockFirst.size(); i++) skips.push_back(Skip{b.blockFirst[i], at + b.blockOffset[i]});
+        data.insert(data.end(), b.bytes.begin(), b.bytes.end());
+    }
+    skipOffsets.push_back(static_cast<uint32_t>(skips.size()));
+}
+
+void NGramIndex::exportArrays(Arrays& out) const {
+    out.grams = grams;
+    out.counts = counts;
+    out.skipOffsets = skipOffsets;
+    out.skips = skips;
+    out.data = data;
+    out.text = text;
+    out.textOffsets = textOffsets;
+}
+
+bool NGramIndex::importArrays(Arrays&& in, const std::vector<Resource*>& list) {
+    clear();
+    if (!isValid(in, list.size())) return false;
+    grams.swap(in.grams);
+    counts.swap(in.counts);
+    skipOffsets.swap(in.skipOffsets);
+    skips.swap(in.skips);
+    data.swap(in.data);
+    text.swap(in.text);
+    textOffsets.swap(in.textOffsets);
+    rows = list;
+    return true;
+}
+
+bool NGramIndex::isValid(const Arrays& a, size_t rowCount) {
+    if (a.textOffsets.size() != rowCount + 1 || a.textOffsets[0] != 0 || a.textOffsets[rowCount] != a.text.size() ||
+        a.counts.size() != a.grams.size() || a.skipOffsets.size() != a.grams.size() + 1 ||
+        a.skipOffsets[0] != 0 || a.skipOffsets[a.grams.size()] != a.skips.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < rowCount; i++) {
+        if (a.textOffsets[i] > a.textOffsets[i + 1]) return false;
+    }
+    for (size_t g = 0; g < a.grams.size(); g++) {
+        if ((g > 0 && a.grams[g] <= a.grams[g - 1]) || a.counts[g] == 0 || a.counts[g] > rowCount) return false;
+        size_t blocks = (a.counts[g] + kBlockSize - 1) / kBlockSize;
+        if (a.skipOffsets[g + 1] < a.skipOffsets[g] || a.skipOffsets[g + 1] - a.skipOffsets[g] != blocks) return false;
+    }
+    // Blocks are laid out in order through 'data'
+    for (size_t k = 0; k < a.skips.size(); k++) {
+        if (a.skips[k].firstRow >= rowCount || a.skips[k].offset >= a.data.size()) return false;
+        if (k > 0 && a.skips[k].offset <= a.skips[k - 1].offset) return false;
+    }
+    // Every posting decodes inside its block to an ascending row below rowCount
+    for (size_t g = 0; g < a.grams.size(); g++) {
+        long last = -1;
+        for (size_t k = a.skipOffsets[g]; k < a.skipOffsets[g + 1]; k++) {
+            size_t n = std::min<size_t>(kBlockSize, a.counts[g] - (k - a.skipOffsets[g]) * kBlockSize);
+            const uint8_t* p = a.data.data() + a.skips[k].offset;
+            const uint8_t* end = a.data.data() + (k + 1 < a.skips.size() ? a.skips[k + 1].offset : a.data.size());
+            uint64_t row = a.skips[k].firstRow;
+            for (size_t i = 0; i < n; i++) {
+                uint32_t delta;
+                if (!getVarint(p, end, delta)) return false;
+                row += delta;
+                if (row >= rowCount || static_cast<long>(row) <= last) return false;
+                last = static_cast<long>(row);
+            }
+        }
+    }
+    return true;
+}
+
+void NGramIndex::clear() {
+    grams.clear();
+    counts.clear();
+    skipOffsets.clear();
+    skips.clear();
+    data.clear();
+    text.clear();
+    textOffsets.clear();
+    rows.clear();
+}
+
+void NGramIndex::swap(NGramIndex& other) {
+    grams.swap(other.grams);
+    counts.swap(other.counts);
+    skipOffsets.swap(other.skipOffsets);
+    skips.swap(other.skips);
+    data.swap(other.data);
+    text.swap(other.text);
+    textOffsets.swap(other.textOffsets);
+    rows.swap(other.rows);
+}
+
+size_t NGramIndex::memoryUsage() const {
+    return (grams.capacity() + counts.capacity() + skipOffsets.capacity() + textOffsets.capacity()) * sizeof(uint32_t) +
+           skips.capacity() * sizeof(Skip) + data.capacity() + text.capacity() + rows.capacity() * sizeof(Resource*);
+}
+
+long NGramIndex::lookup(uint32_t gram) const {
+    auto it = std::lower_bound(grams.begin(), grams.end(), gram);
+    return it != grams.end() && *it == gram ? static_cast<long>(it - grams.begin()) : -1;
+}
+
+void NGramIndex::decodeBlock(size_t g, size_t b, std::vector<uint32_t>& out) const {
+    out.clear();
+    size_t n = std::min<size_t>(kBlockSize, counts[g] - b * kBlockSize);
+    const Skip& skip = skips[skipOffsets[g] + b];
+    const uint8_t* p = data.data() + skip.offset;
+    uint32_t row = skip.firstRow;
+    for (size_t i = 0; i < n; i++) {
+        row += getVarint(p);
+        out.push_back(row);
+    }
+}
+
+bool NGramIndex::matches(uint32_t row, std::string_view lowerText) const {
+    std::string_view rowText(text.data() + textOffsets[row], textOffsets[row + 1] - textOffsets[row]);
+    return rowText.find(lowerText) != std::string_view::npos;
+}
+
+void NGramIndex::find(std::string_view query, std::vector<uint32_t>& out, Stats* stats) const {
+    out.clear();
+    Stats local;
+    Stats& s = stats ? *stats : local;
+    s = Stats();
+
+    std::string needle(query);
+    for (char& c : needle) c = static_cast<char>(lower(c));
+
+    // Too short for a trigram: search the whole text, skipping to the next row after each hit
+    if (needle.size() < 3) {
+        std::string_view all(text.data(), text.size());
+        size_t at = all.find(needle);
+        while (at < all.size()) {
+            uint32_t row = static_cast<uint32_t>(std::upper_bound(textOffsets.begin(), textOffsets.end(), at) - textOffsets.begin()) - 1;
+            out.push_back(row);
+            at = all.find(needle, textOffsets[row + 1]);
+        }
+        s.candidates = rows.size();
+        return;
+    }
+
+    // 1. The query's distinct grams, rarest first; a gram nobody has means no match
+    std::vector<size_t> lists;
+    for (size_t i = 0; i + 3 <= needle.size(); i++) {
+        long g = lookup(gramAt(needle, i));
+        if (g < 0) return;
+        lists.push_back(static_cast<size_t>(g));
+    }
+    std::sort(lists.begin(), lists.end());
+    lists.erase(std::unique(lists.begin(), lists.end()), lists.end());
+    std::sort(lists.begin(), lists.end(), [this](size_t a, size_t b) { return counts[a] < counts[b]; });
+
+    // 2. Decode the rarest list, then keep only candidates present in each next list.
+    //    Candidates ascend, so one cursor per list walks the skips and the decoded block forward.
+    std::vector<uint32_t> candidates, kept, block;
+    for (size_t b = 0; b * kBlockSize < counts[lists[0]]; b++) {
+        decodeBlock(lists[0], b, block);
+        candidates.insert(candidates.end(), block.begin(), block.end());
+        s.blocksDecoded++;
+    }
+    s.listsRead = 1;
+    for (size_t l = 1; l < lists.size() && candidates.size() >= kVerifyBelow; l++) {
+        size_t g = lists[l];
+        const Skip* first = skips.data() + skipOffsets[g];
+        size_t blocks = skipOffsets[g + 1] - skipOffsets[g];
+        size_t b = 0, loaded = SIZE_MAX, pos = 0;
+        kept.clear();
+        for (uint32_t row : candidates) {
+            // Last block starting at or before 'row'
+            while (b + 1 < blocks && first[b + 1].firstRow <= row) b++;
+            if (row < first[b].firstRow) continue;
+            if (b != loaded) {
+                decodeBlock(g, b, block);
+                loaded = b;
+                pos = 0;
+                s.blocksDecoded++;
+            }
+            while (pos < block.size() && block[pos] < row) pos++;
+            if (pos < block.size() && block[pos] == row) kept.push_back(row);
+        }
+        candidates.swap(kept);
+        s.listsRead++;
+    }
+    s.candidates = candidates.size();
+
+    // 3. Verify: every gram matched, but not necessarily contiguously.
+    //    A 3-byte query is its own only gram, so a full intersection is already exact.
+    if (needle.size() == 3) {
+        out.swap(candidates);
+        return;
+    }
+    for (uint32_t row : candidates) {
+        if (matches(row, needle)) out.push_back(row);
+    }
+}
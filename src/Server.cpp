@@ -0,0 +1,320 @@
+#include "../include/Server.h"
+#include <exception>
+#include <iostream>
+#include <sstream>
+#include <memory>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <csignal>
+#include <algorithm>
+
+#if !defined(_WIN32)
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <poll.h>
+    #include <unistd.h>
+    #include <cerrno>
+    #include <cstring>
+#endif
+
+namespace Server {
+
+    bool parseRequestLine(const std::string& line, std::string& requestId, std::string& command) {
+        size_t space = line.find(' ');
+        if (space == std::string::npos || space == 0) return false;
+
+        requestId = line.substr(0, space);
+        command = line.substr(space + 1);
+
+        // Tolerate "\r\n" line endings from Windows clients
+        if (!command.empty() && command.back() == '\r') command.pop_back();
+        return true;
+    }
+
+    bool handleRequest(Engine& engine, Session& session, const std::string& line, std::ostream& out) {
+        std::string requestId, command;
+        if (!parseRequestLine(line, requestId, command)) {
+            out << "---RESPONSE ?---\n";
+            out << "ERROR:Malformed request (expected '<id> <COMMAND>')\n";
+            out << "---END_RESPONSE ?|ERROR---\n";
+            return true;
+        }
+
+        out << "---RESPONSE " << requestId << "---\n";
+        if (command == "QUIT") {
+            out << "---END_RESPONSE " << requestId << "|OK---\n";
+            return false;
+        }
+        // A request that throws (e.g. out of memory) fails alone; the server keeps serving
+        bool ok = false;
+        try {
+            ok = engine.execute(command, session, out);
+        } catch (const std::exception& e) {
+            out << "ERROR:Request failed: " << e.what() << '\n';
+        } catch (...) {
+            out << "ERROR:Request failed" << '\n';
+        }
+        out << "---END_RESPONSE " << requestId << (ok ? "|OK" : "|ERROR") << "---\n";
+        return true;
+    }
+
+    int serveStdio(Engine& engine) {
+        // We flush explicitly once per response, no need to flush before every read
+        std::cin.tie(nullptr);
+
+        std::cout << "---READY---" << std::endl;
+
+        Session session;
+        std::string line;
+        while (std::getline(std::cin, line)) {
+            if (line.empty() || line == "\r") continue;
+            bool keepGoing = handleRequest(engine, session, line, std::cout);
+            std::cout.flush();
+            if (!keepGoing) break;
+        }
+        return 0;
+    }
+
+#if defined(_WIN32)
+
+    int serveSocket(Engine&, const std::string&, int) {
+        std::cerr << "Error: --socket is not supported on Windows, use --serve" << std::endl;
+        return 1;
+    }
+
+#else
+
+    namespace {
+
+        std::atomic<bool> stopRequested(false);
+
+        void onSignal(int) { stopRequested = true; }
+
+        // One client connection == one Session. Requests from the same connection
+        // are executed strictly in arrival order, by whichever worker picks it up.
+        struct Connection {
+            int fd;
+            Session session;
+            std::string readBuffer;          // I/O thread only
+
+            std::mutex mutex;                // Guards the fields below
+            std::deque<std::string> pending; // Complete request lines not yet executed
+            bool scheduled;                  // Sitting in the ready queue or being run
+            bool closing;
+
+            explicit Connection(int f) : fd(f), scheduled(false), closing(false) {}
+            ~Connection() { ::close(fd); }
+        };
+
+        typedef std::shared_ptr<Connection> ConnPtr;
+
+        // Connections with pending work, consumed by the worker pool
+        class ReadyQueue {
+        private:
+            std::deque<ConnPtr> queue;
+            std::mutex mutex;
+            std::condition_variable cv;
+            bool stopped = false;
+
+        public:
+            void push(const ConnPtr& conn) {
+                { std::lock_guard<std::mutex> lock(mutex); queue.push_back(conn); }
+                cv.notify_one();
+            }
+
+            bool pop(ConnPtr& conn) {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [this] { return stopped || !queue.empty(); });
+                if (queue.empty()) return false;
+                conn = queue.front();
+                queue.pop_front();
+                return true;
+            }
+
+            void stop() {
+                { std::lock_guard<std::mutex> lock(mutex); stopped = true; }
+                cv.notify_all();
+            }
+        };
+
+        bool sendAll(int fd, const std::string& data) {
+            size_t sent = 0;
+            while (sent < data.size()) {
+                ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+                if (n < 0) {
+                    if (errno == EINTR) continue;
+                    return false;
+                }
+                sent += static_cast<size_t>(n);
+            }
+            return true;
+        }
+
+        void workerLoop(Engine& engine, ReadyQueue& ready) {
+            ConnPtr conn;
+            for (; ready.pop(conn); conn.reset()) { // reset: don't pin a dropped connection's fd
+                std::string line;
+                {
+                    std::lock_guard<std::mutex> lock(conn->mutex);
+                    if (conn->pending.empty() || conn->closing) {
+                        conn->scheduled = false;
+                        continue;
+                    }
+                    line = std::move(conn->pending.front());
+                    conn->pending.pop_front();
+                }
+
+                // Run one request, then requeue so a chatty client can't starve the others.
+                // 'scheduled' stays true, so no other worker touches this session meanwhile.
+                std::ostringstream response;
+                bool keepGoing = handleRequest(engine, conn->session, line, response);
+                bool delivered = sendAll(conn->fd, response.str());
+
+                std::lock_guard<std::mutex> lock(conn->mutex);
+                if (!keepGoing || !delivered) {
+                    conn->closing = true;
+                    ::shutdown(conn->fd, SHUT_RDWR); // Wakes the I/O thread with EOF
+                }
+                if (!conn->closing && !conn->pending.empty()) {
+                    ready.push(conn);
+                } else {
+                    conn->scheduled = false;
+                }
+            }
+        }
+
+        // Splits newly read bytes into request lines and schedules the connection
+        void enqueueLines(const ConnPtr& conn, ReadyQueue& ready) {
+            std::vector<std::string> lines;
+            size_t start = 0, nl;
+            while ((nl = conn->readBuffer.find('\n', start)) != std::string::npos) {
+                std::string line = conn->readBuffer.substr(start, nl - start);
+                if (!line.empty() && line.back() == '\r') line.pop_back();
+                if (!line.empty()) lines.push_back(std::move(line));
+                start = nl + 1;
+            }
+            conn->readBuffer.erase(0, start);
+            if (lines.empty()) return;
+
+            std::lock_guard<std::mutex> lock(conn->mutex);
+            if (conn->closing) return;
+            for (auto& l : lines) conn->pending.push_back(std::move(l));
+            if (!conn->scheduled) {
+                conn->scheduled = true;
+                ready.push(conn);
+            }
+        }
+    }
+
+    int serveSocket(Engine& engine, const std::string& socketPath, int workerCount) {
+        int listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listenFd < 0) {
+            std::cerr << "Error: socket(): " << std::strerror(errno) << std::endl;
+            return 1;
+        }
+
+        sockaddr_un addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        if (socketPath.size() >= sizeof(addr.sun_path)) {
+            std::cerr << "Error: socket path too long: " << socketPath << std::endl;
+            ::close(listenFd);
+            return 1;
+        }
+        std::strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+        ::unlink(socketPath.c_str()); // Remove a stale socket from a previous run
+
+        if (::bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+            ::listen(listenFd, 128) != 0) {
+            std::cerr << "Error: cannot listen on " << socketPath << ": " << std::strerror(errno) << std::endl;
+            ::close(listenFd);
+            return 1;
+        }
+
+        stopRequested = false;
+        std::signal(SIGINT, onSignal);
+        std::signal(SIGTERM, onSignal);
+
+        if (workerCount <= 0) workerCount = std::max(1u, std::thread::hardware_concurrency());
+        ReadyQueue ready;
+        std::vector<std::thread> workers;
+        for (int i = 0; i < workerCount; i++) {
+            workers.emplace_back(workerLoop, std::ref(engine), std::ref(ready));
+        }
+
+        std::cout << "---READY---" << std::endl;
+        std::cerr << "Listening on " << socketPath << " with " << workerCount << " workers" << std::endl;
+
+        // I/O thread: accept clients and turn incoming bytes into request lines
+        std::vector<ConnPtr> conns;
+        std::vector<pollfd> fds;
+        char chunk[64 * 1024];
+
+        while (!stopRequested) {
+            fds.clear();
+            fds.push_back({listenFd, POLLIN, 0});
+            for (auto& c : conns) fds.push_back({c->fd, POLLIN, 0});
+
+            int n = ::poll(fds.data(), fds.size(), 500); // Timeout so signals are noticed
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+            if (n == 0) continue;
+
+            // Existing clients first; conns[i] matches fds[i + 1]
+            std::vector<ConnPtr> alive;
+            alive.reserve(conns.size());
+            for (size_t i = 0; i < conns.size(); i++) {
+                const ConnPtr& c = conns[i];
+                bool open = true;
+                bool failed = false;
+                if (fds[i + 1].revents & (POLLIN | POLLHUP | POLLERR)) {
+                    ssize_t got = ::recv(c->fd, chunk, sizeof(chunk), 0);
+                    if (got > 0) {
+                        c->readBuffer.append(chunk, static_cast<size_t>(got));
+                        enqueueLines(c, ready);
+                    } else if (got == 0) {
+                        // Client finished sending; already queued requests still get answered
+                        open = false;
+                    } else if (errno != EINTR && errno != EAGAIN) {
+                        open = false;
+                        failed = true;
+                    }
+                }
+                if (open) {
+                    std::lock_guard<std::mutex> lock(c->mutex);
+                    open = !c->closing;
+                }
+                if (open) {
+                    alive.push_back(c);
+                } else if (failed) {
+                    std::lock_guard<std::mutex> lock(c->mutex);
+                    c->closing = true;
+                    c->pending.clear();
+                }
+                // Dropped connections may still be referenced by the ready queue or a
+                // worker; the fd is closed together with the last reference.
+            }
+            conns.swap(alive);
+
+            if (fds[0].revents & POLLIN) {
+                int clientFd = ::accept(listenFd, nullptr, nullptr);
+                if (clientFd >= 0) conns.push_back(std::make_shared<Connection>(clientFd));
+            }
+        }
+
+        ready.stop();
+        for (auto& t : workers) t.join();
+        conns.clear();
+        ::close(listenFd);
+        ::unlink(socketPath.c_str());
+        return 0;
+    }
+
+#endif
+}
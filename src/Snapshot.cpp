@@ -0,0 +1,451 @@
+#include "../include/Snapshot.h"
+#include <fstream>
+#include <cstring>
+#include <filesystem>
+#include <unordered_map>
+
+namespace Snapshot {
+
+    namespace {
+        const char kMagic[8] = {'C', 'C', 'S', 'N', 'A', 'P', '\0', '\0'};
+        const uint32_t kEndianTag = 0x01020304u;
+
+        uint64_t fnv1a(const char* data, size_t length) {
+            uint64_t hash = 1469598103934665603ull;
+            for (size_t i = 0; i < length; i++) {
+                hash ^= static_cast<unsigned char>(data[i]);
+                hash *= 1099511628211ull;
+            }
+            return hash;
+        }
+
+        // Appends raw bytes of a section to the payload, 8-byte aligned
+        template <typename T>
+        void appendSection(std::string& payload, SectionEntry& entry, const std::vector<T>& items) {
+            while (payload.size() % 8 != 0) payload.push_back('\0');
+            entry.offset = sizeof(Header) + payload.size();
+            entry.length = items.size() * sizeof(T);
+            if (!items.empty()) payload.append(reinterpret_cast<const char*>(items.data()), entry.length);
+        }
+
+        bool fitsU32(size_t n) { return n <= 0xFFFFFFFFull; }
+
+        uint64_t headerChecksum(const Header& h) {
+            Header copy = h;
+            copy.headerChecksum = 0;
+            return fnv1a(reinterpret_cast<const char*>(&copy), sizeof(copy));
+        }
+
+        bool inStrings(const StringRef& ref, size_t stringBytes) { return (uint64_t)ref.offset + ref.length <= stringBytes; }
+
+        // Every index of a record points inside its section
+        bool recordInBounds(const ResourceRecord& r, size_t stringBytes, size_t prereqCount,
+                            size_t topicCount, size_t urlPrefixCount) {
+            return inStrings(StringRef{r.titleOffset, r.titleLength}, stringBytes) &&
+                   inStrings(StringRef{r.urlRestOffset, r.urlRestLength}, stringBytes) &&
+                   r.topic < topicCount && r.urlPrefix < urlPrefixCount &&
+                   (uint64_t)r.prereqOffset + r.prereqCount <= prereqCount;
+        }
+    }
+
+    bool stampFile(const std::string& path, SourceStamp& stamp) {
+        std::error_code ec;
+        auto size = std::filesystem::file_size(path, ec);
+        if (ec) return false;
+        auto mtime = std::filesystem::last_write_time(path, ec);
+        if (ec) return false;
+        stamp.size = static_cast<uint64_t>(size);
+        stamp.mtime = static_cast<int64_t>(mtime.time_since_epoch().count());
+        return true;
+    }
+
+    std::string defaultPathFor(const std::string& csvPath) {
+        std::filesystem::path p(csvPath);
+        p.replace_extension(".ccsnap");
+        return p.string();
+    }
+
+    bool write(const std::string& path, const Contents& contents, const SourceStamp& source) {
+        // 1. Flatten resources into fixed-size records + string/prereq pools.
+        // Topics and URL prefixes go into dictionaries (indexed by record) so
+        // loading interns each distinct one once.
+        std::vector<ResourceRecord> records;
+        std::vector<char> strings;
+        std::vector<int32_t> prereqs;
+        std::vector<StringRef> topics, urlPrefixes;
+        std::unordered_map<uint32_t, uint32_t> topicIndex, urlPrefixIndex; // Symbol ID -> dictionary index
+        records.reserve(contents.resources.size());
+
+        auto pushString = [&strings](std::string_view s, uint32_t& offset, uint32_t& length) {
+            offset = static_cast<uint32_t>(strings.size());
+            length = static_cast<uint32_t>(s.size());
+            strings.insert(strings.end(), s.begin(), s.end());
+        };
+        auto dictionaryIndex = [&pushString](std::vector<StringRef>& dictionary,
+                                             std::unordered_map<uint32_t, uint32_t>& index,
+                                             uint32_t symbol, std::string_view name) {
+            auto it = index.find(symbol);
+            if (it != index.end()) return it->second;
+            StringRef ref;
+            pushString(name, ref.offset, ref.length);
+            dictionary.push_back(ref);
+            uint32_t i = static_cast<uint32_t>(dictionary.size() - 1);
+            index.emplace(symbol, i);
+            return i;
+        };
+
+        for (const Resource* r : contents.resources) {
+            ResourceRecord rec;
+            std::memset(&rec, 0, sizeof(rec));
+            rec.id = r->id;
+            rec.difficulty = r->difficulty;
+            rec.duration = r->duration;
+            rec.rating = r->rating;
+            pushString(r->title, rec.titleOffset, rec.titleLength);
+            pushString(r->url.restText(), rec.urlRestOffset, rec.urlRestLength);
+            rec.urlPrefix = dictionaryIndex(urlPrefixes, urlPrefixIndex, r->url.prefix, r->url.prefixText());
+            rec.topic = dictionaryIndex(topics, topicIndex, r->topic.id, r->topic.name());
+            rec.prereqOffset = static_cast<uint32_t>(prereqs.size());
+            rec.prereqCount = static_cast<uint32_t>(r->prereqIDs.size());
+            prereqs.insert(prereqs.end(), r->prereqIDs.begin(), r->prereqIDs.end());
+            records.push_back(rec);
+        }
+        if (!fitsU32(strings.size()) || !fitsU32(prereqs.size())) return false;
+
+        // 2. Flatten the adjacency lists (CSR, one row per resource record)
+        std::vector<uint32_t> adjOffsets;
+        std::vector<int32_t> adjTargets;
+        adjOffsets.reserve(contents.resources.size() + 1);
+        adjOffsets.push_back(0);
+        for (size_t i = 0; i < contents.resources.size(); i++) {
+            if (i < contents.dependents.size()) {
+                adjTargets.insert(adjTargets.end(), contents.dependents[i].begin(), contents.dependents[i].end());
+            }
+            if (!fitsU32(adjTargets.size())) return false;
+            adjOffsets.push_back(static_cast<uint32_t>(adjTargets.size()));
+        }
+
+        // 3. Lay out the payload
+        Header header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.endianTag = kEndianTag;
+        header.sourceSize = source.size;
+        header.sourceMtime = source.mtime;
+        header.sectionCount = SECTION_COUNT;
+
+        std::string payload;
+        appendSection(payload, header.sections[RESOURCES], records);
+        appendSection(payload, header.sections[STRINGS], strings);
+        appendSection(payload, header.sections[PREREQS], prereqs);
+        appendSection(payload, header.sections[TOPICS], topics);
+        appendSection(payload, header.sections[URL_PREFIXES], urlPrefixes);
+        appendSection(payload, header.sections[TRIE_NODES], contents.trie.nodes);
+        appendSection(payload, header.sections[TRIE_CHILD_KEYS], contents.trie.childKeys);
+        appendSection(payload, header.sections[TRIE_CHILD_NODES], contents.trie.childNodes);
+        appendSection(payload, header.sections[TRIE_IDS], contents.trie.ids);
+        appendSection(payload, header.sections[TRIE_LABELS], contents.trie.labels);
+        appendSection(payload, header.sections[TRIE_POSTING_OFFSETS], contents.trie.postingOffsets);
+        appendSection(payload, header.sections[TRIE_POSTINGS], contents.trie.postings);
+        appendSection(payload, header.sections[TRIE_KEY_SCORES], contents.trie.keyScore);
+        appendSection(payload, header.sections[TRIE_KEY_BEST], contents.trie.keyBest);
+        appendSection(payload, header.sections[TRIE_COMPLETION_SLOTS], contents.trie.completionSlot);
+        appendSection(payload, header.sections[TRIE_COMPLETIONS], contents.trie.completions);
+        appendSection(payload, header.sections[ADJ_OFFSETS], adjOffsets);
+        appendSection(payload, header.sections[ADJ_TARGETS], adjTargets);
+        appendSection(payload, header.sections[ORDER_DIFFICULTY], contents.orderByDifficulty);
+        appendSection(payload, header.sections[ORDER_TOPIC], contents.orderByTopic);
+        appendSection(payload, header.sections[HEAP_LAYOUT], contents.heapLayout);
+        appendSection(payload, header.sections[INFIX_GRAMS], contents.infix.grams);
+        appendSection(payload, header.sections[INFIX_COUNTS], contents.infix.counts);
+        appendSection(payload, header.sections[INFIX_SKIP_OFFSETS], contents.infix.skipOffsets);
+        appendSection(payload, header.sections[INFIX_SKIPS], contents.infix.skips);
+        appendSection(payload, header.sections[INFIX_DATA], contents.infix.data);
+        appendSection(payload, header.sections[INFIX_TEXT], contents.infix.text);
+        appendSection(payload, header.sections[INFIX_TEXT_OFFSETS], contents.infix.textOffsets);
+        const TextIndex::Arrays& text = contents.text;
+        std::vector<double> textStatistics = {text.averageLength, text.boundLength, text.maxRating};
+        appendSection(payload, header.sections[TEXT_WORDS], text.words);
+        appendSection(payload, header.sections[TEXT_WORD_OFFSETS], text.wordOffsets);
+        appendSection(payload, header.sections[TEXT_TERMS], text.terms);
+        appendSection(payload, header.sections[TEXT_SKIPS], text.skips);
+        appendSection(payload, header.sections[TEXT_DATA], text.data);
+        appendSection(payload, header.sections[TEXT_LENGTHS], text.lengths);
+        appendSection(payload, header.sections[TEXT_RATINGS], text.ratings);
+        appendSection(payload, header.sections[TEXT_STATISTICS], textStatistics);
+        while (payload.size() % 8 != 0) payload.push_back('\0');
+
+        header.payloadSize = payload.size();
+        header.payloadChecksum = fnv1a(payload.data(), payload.size());
+        header.headerChecksum = headerChecksum(header);
+
+        // 4. Write to a temp file and rename, so readers never map a half-written snapshot
+        std::string tmpPath = path + ".tmp";
+        {
+            std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+            if (!out.is_open()) return false;
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(payload.data(), payload.size());
+            if (!out.good()) return false;
+        }
+        std::error_code ec;
+        std::filesystem::rename(tmpPath, path, ec);
+        return !ec;
+    }
+
+    bool Image::open(const std::string& path, const SourceStamp& expected, std::string& reason, bool verify) {
+        header = nullptr;
+        if (!file.open(path)) { reason = "not found"; return false; }
+
+        if (file.size() < sizeof(Header)) { reason = "truncated header"; return false; }
+        const Header* h = reinterpret_cast<const Header*>(file.data());
+
+        if (std::memcmp(h->magic, kMagic, sizeof(kMagic)) != 0) { reason = "bad magic"; return false; }
+        if (h->endianTag != kEndianTag) { reason = "endianness mismatch"; return false; }
+        if (h->version != kVersion || h->sectionCount != SECTION_COUNT) { reason = "version mismatch"; return false; }
+        if (headerChecksum(*h) != h->headerChecksum) { reason = "header checksum mismatch"; return false; }
+        if (h->sourceSize != expected.size || h->sourceMtime != expected.mtime) { reason = "stale (CSV changed)"; return false; }
+        if (h->payloadSize != file.size() - sizeof(Header)) { reason = "size mismatch"; return false; }
+
+        static const size_t elementSize[SECTION_COUNT] = {
+            sizeof(ResourceRecord), 1, sizeof(int32_t), sizeof(StringRef), sizeof(StringRef),
+            sizeof(FrozenTrieNode), 1, sizeof(uint32_t), sizeof(int32_t), 1, sizeof(uint32_t), sizeof(int32_t),
+            sizeof(float), sizeof(int32_t), sizeof(uint32_t), sizeof(uint32_t),
+            sizeof(uint32_t), sizeof(int32_t), sizeof(uint32_t), sizeof(uint32_t), sizeof(uint32_t),
+            sizeof(uint32_t), sizeof(uint32_t), sizeof(uint32_t), sizeof(NGramIndex::Skip), 1, 1, sizeof(uint32_t),
+            1, sizeof(uint32_t), sizeof(TextIndex::Term), sizeof(TextIndex::Skip), 1, sizeof(uint16_t), sizeof(float),
+            sizeof(double)
+        };
+        for (uint32_t s = 0; s < SECTION_COUNT; s++) {
+            const SectionEntry& e = h->sections[s];
+            if (e.offset % 8 != 0 || e.offset > file.size() || e.length > file.size() - e.offset ||
+                e.length % elementSize[s] != 0) {
+                reason = "bad section table";
+                return false;
+            }
+        }
+        header = h;
+
+        // Section sizes that must agree; O(1), so checked on every open
+        size_t n, adjCount, targetCount, keyCount, childCount, trieCount, offsetCount;
+        const ResourceRecord* records = section<ResourceRecord>(RESOURCES, n);
+        const uint32_t* adj = section<uint32_t>(ADJ_OFFSETS, adjCount);
+        section<int32_t>(ADJ_TARGETS, targetCount);
+        section<unsigned char>(TRIE_CHILD_KEYS, keyCount);
+        section<uint32_t>(TRIE_CHILD_NODES, childCount);
+        section<FrozenTrieNode>(TRIE_NODES, trieCount);
+        section<uint32_t>(TRIE_POSTING_OFFSETS, offsetCount);
+        size_t scoreCount, bestCount, slotCount;
+        section<float>(TRIE_KEY_SCORES, scoreCount);
+        section<int32_t>(TRIE_KEY_BEST, bestCount);
+        section<uint32_t>(TRIE_COMPLETION_SLOTS, slotCount);
+        size_t gramCount, countCount, skipOffsetCount, textOffsetCount;
+        section<uint32_t>(INFIX_GRAMS, gramCount);
+        section<uint32_t>(INFIX_COUNTS, countCount);
+        section<uint32_t>(INFIX_SKIP_OFFSETS, skipOffsetCount);
+        section<uint32_t>(INFIX_TEXT_OFFSETS, textOffsetCount);
+        size_t wordOffsetCount, termCount, lengthCount, ratingCount, statisticCount;
+        section<uint32_t>(TEXT_WORD_OFFSETS, wordOffsetCount);
+        section<TextIndex::Term>(TEXT_TERMS, termCount);
+        section<uint16_t>(TEXT_LENGTHS, lengthCount);
+        section<float>(TEXT_RATINGS, ratingCount);
+        section<double>(TEXT_STATISTICS, statisticCount);
+        if (adjCount != n + 1 || adj[n] != targetCount || keyCount != childCount ||
+            (offsetCount != 0 && offsetCount != trieCount) ||
+            scoreCount != slotCount || bestCount != slotCount || (slotCount != 0 && slotCount + 1 != trieCount) ||
+            countCount != gramCount || skipOffsetCount != gramCount + 1 || textOffsetCount != n + 1 ||
+            wordOffsetCount != termCount + 1 || lengthCount != n || ratingCount != n || statisticCount != 3) {
+            reason = "bad section sizes";
+            header = nullptr;
+            return false;
+        }
+        if (!verify) return true;
+
+        if (fnv1a(file.data() + sizeof(Header), h->payloadSize) != h->payloadChecksum) {
+            reason = "checksum mismatch";
+            header = nullptr;
+            return false;
+        }
+
+        // Cross-check references so the accessors can trust every index
+        size_t stringBytes, prereqCount, topicCount, urlPrefixCount;
+        section<char>(STRINGS, stringBytes);
+        section<int32_t>(PREREQS, prereqCount);
+        const StringRef* topics = section<StringRef>(TOPICS, topicCount);
+        const StringRef* urlPrefixes = section<StringRef>(URL_PREFIXES, urlPrefixCount);
+
+        for (size_t i = 0; i < topicCount; i++) {
+            if (!inStrings(topics[i], stringBytes)) { reason = "bad dictionary"; header = nullptr; return false; }
+        }
+        for (size_t i = 0; i < urlPrefixCount; i++) {
+            if (!inStrings(urlPrefixes[i], stringBytes)) { reason = "bad dictionary"; header = nullptr; return false; }
+        }
+        for (size_t i = 0; i < n; i++) {
+            if (!recordInBounds(records[i], stringBytes, prereqCount, topicCount, urlPrefixCount)) {
+                reason = "bad resource record";
+                header = nullptr;
+                return false;
+            }
+        }
+        for (size_t i = 0; i < n; i++) {
+            if (adj[i] > adj[i + 1] || adj[i + 1] > targetCount) { reason = "bad adjacency"; header = nullptr; return false; }
+        }
+        const Section orders[] = {ORDER_DIFFICULTY, ORDER_TOPIC, HEAP_LAYOUT};
+        for (Section s : orders) {
+            size_t count;
+            const uint32_t* idx = section<uint32_t>(s, count);
+            for (size_t i = 0; i < count; i++) {
+                if (idx[i] >= n) { reason = "bad ordering"; header = nullptr; return false; }
+            }
+        }
+
+        // Trie: the arrays must describe exactly one preorder tree (see FrozenTrie::validate)
+        size_t trieIDCount, labelBytes, postingCount;
+        const FrozenTrieNode* trie = section<FrozenTrieNode>(TRIE_NODES, trieCount);
+        const unsigned char* keys = section<unsigned char>(TRIE_CHILD_KEYS, keyCount);
+        const uint32_t* children = section<uint32_t>(TRIE_CHILD_NODES, childCount);
+        section<int32_t>(TRIE_IDS, trieIDCount);
+        section<char>(TRIE_LABELS, labelBytes);
+        const uint32_t* postingOffsets = section<uint32_t>(TRIE_POSTING_OFFSETS, offsetCount);
+        section<int32_t>(TRIE_POSTINGS, postingCount);
+        size_t completionCount;
+        const uint32_t* slots = section<uint32_t>(TRIE_COMPLETION_SLOTS, slotCount);
+        const uint32_t* completions = section<uint32_t>(TRIE_COMPLETIONS, completionCount);
+        if (!FrozenTrie::validate(trie, trieCount, keys, children, childCount, trieIDCount, labelBytes) ||
+            !FrozenTrie::validatePostings(postingOffsets, offsetCount, trieCount, postingCount) ||
+            !FrozenTrie::validateRanking(trieCount, scoreCount, bestCount, slots, slotCount, completions, completionCount)) {
+            reason = "bad trie";
+            header = nullptr;
+            return false;
+        }
+
+        NGramIndex::Arrays infix;
+        loadInfixIndex(infix);
+        if (!NGramIndex::isValid(infix, n)) {
+            reason = "bad substring index";
+            header = nullptr;
+            return false;
+        }
+        TextIndex::Arrays text;
+        loadTextIndex(text);
+        if (!TextIndex::isValid(text, n)) {
+            reason = "bad text index";
+            header = nullptr;
+            return false;
+        }
+        return true;
+    }
+
+    void Image::loadTrie(FrozenTrie& out) const {
+        size_t count;
+        const FrozenTrieNode* nodes = section<FrozenTrieNode>(TRIE_NODES, count);
+        out.nodes.assign(nodes, nodes + count);
+        const unsigned char* keys = section<unsigned char>(TRIE_CHILD_KEYS, count);
+        out.childKeys.assign(keys, keys + count);
+        const uint32_t* children = section<uint32_t>(TRIE_CHILD_NODES, count);
+        out.childNodes.assign(children, children + count);
+        const int32_t* ids = section<int32_t>(TRIE_IDS, count);
+        out.ids.assign(ids, ids + count);
+        const char* labels = section<char>(TRIE_LABELS, count);
+        out.labels.assign(labels, labels + count);
+        const uint32_t* postingOffsets = section<uint32_t>(TRIE_POSTING_OFFSETS, count);
+        out.postingOffsets.assign(postingOffsets, postingOffsets + count);
+        const int32_t* postings = section<int32_t>(TRIE_POSTINGS, count);
+        out.postings.assign(postings, postings + count);
+        const float* scores = section<float>(TRIE_KEY_SCORES, count);
+        out.keyScore.assign(scores, scores + count);
+        const int32_t* best = section<int32_t>(TRIE_KEY_BEST, count);
+        out.keyBest.assign(best, best + count);
+        const uint32_t* slots = section<uint32_t>(TRIE_COMPLETION_SLOTS, count);
+        out.completionSlot.assign(slots, slots + count);
+        const uint32_t* completions = section<uint32_t>(TRIE_COMPLETIONS, count);
+        out.completions.assign(completions, completions + count);
+    }
+
+    void Image::loadInfixIndex(NGramIndex::Arrays& out) const {
+        size_t count;
+        const uint32_t* grams = section<uint32_t>(INFIX_GRAMS, count);
+        out.grams.assign(grams, grams + count);
+        const uint32_t* counts = section<uint32_t>(INFIX_COUNTS, count);
+        out.counts.assign(counts, counts + count);
+        const uint32_t* skipOffsets = section<uint32_t>(INFIX_SKIP_OFFSETS, count);
+        out.skipOffsets.assign(skipOffsets, skipOffsets + count);
+        const NGramIndex::Skip* skips = section<NGramIndex::Skip>(INFIX_SKIPS, count);
+        out.skips.assign(skips, skips + count);
+        const uint8_t* data = section<uint8_t>(INFIX_DATA, count);
+        out.data.assign(data, data + count);
+        const char* text = section<char>(INFIX_TEXT, count);
+        out.text.assign(text, text + count);
+        const uint32_t* textOffsets = section<uint32_t>(INFIX_TEXT_OFFSETS, count);
+        out.textOffsets.assign(textOffsets, textOffsets + count);
+    }
+
+    void Image::loadTextIndex(TextIndex::Arrays& out) const {
+        size_t count;
+        const char* words = section<char>(TEXT_WORDS, count);
+        out.words.assign(words, words + count);
+        const uint32_t* wordOffsets = section<uint32_t>(TEXT_WORD_OFFSETS, count);
+        out.wordOffsets.assign(wordOffsets, wordOffsets + count);
+        const TextIndex::Term* terms = section<TextIndex::Term>(TEXT_TERMS, count);
+        out.terms.assign(terms, terms + count);
+        const TextIndex::Skip* skips = section<TextIndex::Skip>(TEXT_SKIPS, count);
+        out.skips.assign(skips, skips + count);
+        const uint8_t* data = section<uint8_t>(TEXT_DATA, count);
+        out.data.assign(data, data + count);
+        const uint16_t* lengths = section<uint16_t>(TEXT_LENGTHS, count);
+        out.lengths.assign(lengths, lengths + count);
+        const float* ratings = section<float>(TEXT_RATINGS, count);
+        out.ratings.assign(ratings, ratings + count);
+        const double* statistics = section<double>(TEXT_STATISTICS, count);
+        out.averageLength = statistics[0];
+        out.boundLength = statistics[1];
+        out.maxRating = statistics[2];
+    }
+
+    size_t Image::resourceCount() const {
+        size_t n;
+        section<ResourceRecord>(RESOURCES, n);
+        return n;
+    }
+
+    bool Image::makeResources(ResourceStore& store, std::vector<Resource*>& out, std::string& reason) const {
+        size_t n, stringBytes, prereqCount, topicCount, urlPrefixCount;
+        const ResourceRecord* records = section<ResourceRecord>(RESOURCES, n);
+        const char* strings = section<char>(STRINGS, stringBytes);
+        const int32_t* prereqs = section<int32_t>(PREREQS, prereqCount);
+        const StringRef* topicNames = section<StringRef>(TOPICS, topicCount);
+        const StringRef* urlPrefixNames = section<StringRef>(URL_PREFIXES, urlPrefixCount);
+
+        // Intern each distinct topic and URL prefix once, not once per record
+        std::vector<Topic> topics(topicCount);
+        std::vector<uint32_t> urlPrefixes(urlPrefixCount);
+        for (size_t i = 0; i < topicCount; i++) {
+            if (!inStrings(topicNames[i], stringBytes)) { reason = "bad dictionary"; return false; }
+            topics[i] = Topic(std::string_view(strings + topicNames[i].offset, topicNames[i].length));
+        }
+        for (size_t i = 0; i < urlPrefixCount; i++) {
+            if (!inStrings(urlPrefixNames[i], stringBytes)) { reason = "bad dictionary"; return false; }
+            urlPrefixes[i] = SymbolTable::urlPrefixes().intern(
+                std::string_view(strings + urlPrefixNames[i].offset, urlPrefixNames[i].length));
+        }
+
+        out.reserve(out.size() + n);
+        for (size_t i = 0; i < n; i++) {
+            const ResourceRecord& rec = records[i];
+            if (!recordInBounds(rec, stringBytes, prereqCount, topicCount, urlPrefixCount) ||
+                (i > 0 && rec.id < records[i - 1].id)) {
+                reason = "bad resource record";
+                return false;
+            }
+            out.push_back(store.createView(rec.id,
+                                           std::string_view(strings + rec.titleOffset, rec.titleLength),
+                                           urlPrefixes[rec.urlPrefix],
+                                           std::string_view(strings + rec.urlRestOffset, rec.urlRestLength),
+                                           topics[rec.topic],
+                                           rec.difficulty, rec.rating, prereqs + rec.prereqOffset, rec.prereqCount,
+                                           rec.duration));
+        }
+        return true;
+    }
+}
@@ -0,0 +1,652 @@
+#include "../include/TextIndex.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+
+namespace {
+
+    bool isWordByte(unsigned char c) { return std::isalnum(c) || c >= 0x80; }
+
+    void putVarint(std::vector<uint8_t>& out, uint32_t v) {
+        while (v >= 0x80) {
+            out.push_back(static_cast<uint8_t>(v | 0x80));
+            v >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(v));
+    }
+
+    uint32_t getVarint(const uint8_t*& p) {
+        uint32_t v = 0;
+        for (int shift = 0;; shift += 7) {
+            uint8_t b = *p++;
+            v |= static_cast<uint32_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) return v;
+        }
+    }
+
+    // Same, but fails instead of reading past 'end' or overflowing (for data read from a file)
+    bool getVarint(const uint8_t*& p, const uint8_t* end, uint32_t& v) {
+        v = 0;
+        for (int shift = 0; shift < 32 && p < end; shift += 7) {
+            uint8_t b = *p++;
+            v |= static_cast<uint32_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) return true;
+        }
+        return false;
+    }
+
+    // One word's list while building: encoded as rows arrive (rows arrive ascending)
+    struct ListBuilder {
+        std::vector<uint8_t> bytes;
+        std::vector<uint32_t> blockFirst, blockLast, blockOffset;
+        uint32_t last = 0;
+        uint32_t count = 0;
+
+        void add(uint32_t row, uint32_t freq) {
+            if (count % TextIndex::kBlockSize == 0) {
+                blockFirst.push_back(row);
+                blockLast.push_back(row);
+                blockOffset.push_back(static_cast<uint32_t>(bytes.size()));
+                last = row;
+            }
+            putVarint(bytes, row - last);
+            putVarint(bytes, freq);
+            last = row;
+            blockLast.back() = row;
+            count++;
+        }
+    };
+
+    // Distinct words of a resource's title and topic with their counts, by word. Returns the word total.
+    size_t countWords(const Resource* r, std::vector<std::pair<std::string, uint32_t>>& out) {
+        out.clear();
+        std::vector<std::string> words = TextIndex::tokenize(r->title);
+        std::vector<std::string> topicWords = TextIndex::tokenize(r->topic.name());
+        words.insert(words.end(), topicWords.begin(), topicWords.end());
+        std::sort(words.begin(), words.end());
+        for (size_t i = 0; i < words.size();) {
+            size_t j = i;
+            while (j < words.size() && words[j] == words[i]) j++;
+            out.push_back(std::make_pair(std::move(words[i]), static_cast<uint32_t>(j - i)));
+            i = j;
+        }
+        return words.size();
+    }
+
+    // Ranking order: higher score, then earlier in the catalog. As a heap comparator it keeps the worst hit in front.
+    bool betterHit(const TextIndex::Hit& a, const TextIndex::Hit& b) {
+        return a.score != b.score ? a.score > b.score : a.row < b.row;
+    }
+
+}
+
+std::vector<std::string> TextIndex::tokenize(std::string_view text) {
+    std::vector<std::string> words;
+    size_t i = 0;
+    while (i < text.size()) {
+        while (i < text.size() && !isWordByte(static_cast<unsigned char>(text[i]))) i++;
+        size_t start = i;
+        while (i < text.size() && isWordByte(static_cast<unsigned char>(text[i]))) i++;
+        if (i > start) {
+            std::string word(text.substr(start, i - start));
+            for (char& c : word) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            words.push_back(std::move(word));
+        }
+    }
+    return words;
+}
+
+void TextIndex::build(const std::vector<Resource*>& list) {
+    clear();
+    rows = list;
+    lengths.reserve(rows.size());
+    ratings.reserve(rows.size());
+
+    std::vector<ListBuilder> lists;
+    std::vector<std::pair<std::string, uint32_t>> words;
+    for (uint32_t row = 0; row < rows.size(); row++) {
+        size_t length = countWords(rows[row], words);
+        lengths.push_back(static_cast<uint16_t>(std::min<size_t>(length, UINT16_MAX)));
+        ratings.push_back(static_cast<float>(rows[row]->rating));
+        for (const auto& word : words) {
+            auto inserted = termIDs.emplace(word.first, static_cast<uint32_t>(lists.size()));
+            if (inserted.second) lists.emplace_back();
+            lists[inserted.first->second].add(row, word.second);
+        }
+    }
+
+    // Concatenate the lists, then score each word's rows once for its bounds
+    terms.resize(lists.size());
+    for (size_t t = 0; t < lists.size(); t++) {
+        ListBuilder& b = lists[t];
+        Term& term = terms[t];
+        uint32_t base = static_cast<uint32_t>(data.size());
+        term.count = b.count;
+        term.firstSkip = static_cast<uint32_t>(skips.size());
+        term.maxWeight = 0;
+        for (size_t i = 0; i < b.blockFirst.size(); i++) {
+            skips.push_back(Skip{b.blockFirst[i], b.blockLast[i], base + b.blockOffset[i], 0.0f});
+        }
+        data.insert(data.end(), b.bytes.begin(), b.bytes.end());
+        ListBuilder().bytes.swap(b.bytes);
+    }
+    computeStatistics();
+    boundLength = averageLength; // Exact bounds for a fresh build
+    for (Term& term : terms) computeBounds(term);
+    data.shrink_to_fit();
+    skips.shrink_to_fit();
+}
+
+void TextIndex::update(const TextIndex& base, const std::vector<Resource*>& list, const std::vector<uint32_t>& changedRows) {
+    clear();
+    rows = list;
+    size_t oldCount = base.rows.size();
+    std::vector<char> changed(rows.size(), 0);
+    for (uint32_t row : changedRows) changed[row] = 1;
+
+    // 1. Lengths and ratings: unchanged rows copy theirs. Collect the rows leaving each old
+    //    word's list (changed and dropped rows) and the (row, count) entering each new word's.
+    std::unordered_map<uint32_t, std::vector<uint32_t>> leaving;   // Base term -> rows, ascending
+    std::unordered_map<std::string, std::vector<std::pair<uint32_t, uint32_t>>> entering; // Word -> (row, count)
+    std::vector<std::pair<std::string, uint32_t>> words;
+    auto leave = [&](uint32_t row) {
+        countWords(base.rows[row], words);
+        for (const auto& word : words) {
+            auto it = base.termIDs.find(word.first);
+            if (it != base.termIDs.end()) leaving[it->second].push_back(row);
+        }
+    };
+    lengths.reserve(rows.size());
+    ratings.reserve(rows.size());
+    for (uint32_t row = 0; row < rows.size(); row++) {
+        if (row < oldCount && !changed[row]) {
+            lengths.push_back(base.lengths[row]);
+            ratings.push_back(base.ratings[row]);
+            continue;
+        }
+        if (row < oldCount) leave(row);
+        size_t length = countWords(rows[row], words);
+        lengths.push_back(static_cast<uint16_t>(std::min<size_t>(length, UINT16_MAX)));
+        ratings.push_back(static_cast<float>(rows[row]->rating));
+        for (auto& word : words) entering[word.first].push_back(std::make_pair(row, word.second));
+    }
+    for (uint32_t row = static_cast<uint32_t>(rows.size()); row < oldCount; row++) leave(row);
+
+    // 2. Lists in base's term order. Untouched ones keep their bytes and bounds (skips shifted
+    //    to the new offset); touched ones are decoded, edited and re-encoded; emptied ones go.
+    std::vector<const std::string*> baseWords(base.terms.size());
+    for (const auto& entry : base.termIDs) baseWords[entry.second] = &entry.first;
+    termIDs.reserve(base.termIDs.size() + entering.size());
+    terms.reserve(base.terms.size() + entering.size());
+    skips.reserve(base.skips.size());
+    data.reserve(base.data.size());
+    std::vector<uint32_t> touched, listRows, listFreqs, blockRows, blockFreqs, keptRows, keptFreqs;
+    for (uint32_t t = 0; t < base.terms.size(); t++) {
+        const Term& old = base.terms[t];
+        auto out = leaving.find(t);
+        auto in = entering.find(*baseWords[t]);
+        if (out == leaving.end() && in == entering.end()) {
+            uint32_t begin = base.skips[old.firstSkip].offset;
+            uint32_t end = t + 1 < base.terms.size() ? base.skips[base.terms[t + 1].firstSkip].offset
+                                                     : static_cast<uint32_t>(base.data.size());
+            Term term = old;
+            term.firstSkip = static_cast<uint32_t>(skips.size());
+            for (size_t b = 0; b * kBlockSize < old.count; b++) {
+                Skip skip = base.skips[old.firstSkip + b];
+                skip.offset = skip.offset - begin + static_cast<uint32_t>(data.size());
+                skips.push_back(skip);
+            }
+            data.insert(data.end(), base.data.begin() + begin, base.data.begin() + end);
+            termIDs.emplace(*baseWords[t], static_cast<uint32_t>(terms.size()));
+            terms.push_back(term);
+            continue;
+        }
+
+        keptRows.clear();
+        keptFreqs.clear();
+        size_t drop = 0;
+        for (size_t b = 0; b * kBlockSize < old.count; b++) {
+            base.decodeBlock(old, b, blockRows, blockFreqs);
+            for (size_t i = 0; i < blockRows.size(); i++) {
+                if (out != leaving.end()) {
+                    while (drop < out->second.size() && out->second[drop] < blockRows[i]) drop++;
+                    if (drop < out->second.size() && out->second[drop] == blockRows[i]) continue;
+                }
+                keptRows.push_back(blockRows[i]);
+                keptFreqs.push_back(blockFreqs[i]);
+            }
+        }
+        listRows.clear();
+        listFreqs.clear();
+        size_t k = 0;
+        if (in != entering.end()) {
+            for (const auto& entry : in->second) {
+                for (; k < keptRows.size() && keptRows[k] < entry.first; k++) {
+                    listRows.push_back(keptRows[k]);
+                    listFreqs.push_back(keptFreqs[k]);
+                }
+                listRows.push_back(entry.first);
+                listFreqs.push_back(entry.second);
+            }
+            entering.erase(in);
+        }
+        listRows.insert(listRows.end(), keptRows.begin() + k, keptRows.end());
+        listFreqs.insert(listFreqs.end(), keptFreqs.begin() + k, keptFreqs.end());
+        if (listRows.empty()) continue; // No row has this word any more
+
+        termIDs.emplace(*baseWords[t], static_cast<uint32_t>(terms.size()));
+        touched.push_back(static_cast<uint32_t>(terms.size()));
+        appendList(listRows, listFreqs);
+    }
+    // Words no row had before, in the order build() would meet them
+    std::vector<std::pair<uint32_t, const std::string*>> fresh; // (first row, word)
+    for (const auto& entry : entering) fresh.push_back(std::make_pair(entry.second.front().first, &entry.first));
+    std::sort(fresh.begin(), fresh.end(), [](const std::pair<uint32_t, const std::string*>& a,
+                                             const std::pair<uint32_t, const std::string*>& b) {
+        return a.first != b.first ? a.first < b.first : *a.second < *b.second;
+    });
+    for (const auto& word : fresh) {
+        listRows.clear();
+        listFreqs.clear();
+        for (const auto& entry : entering[*word.second]) {
+            listRows.push_back(entry.first);
+            listFreqs.push_back(entry.second);
+        }
+        termIDs.emplace(*word.second, static_cast<uint32_t>(terms.size()));
+        touched.push_back(static_cast<uint32_t>(terms.size()));
+        appendList(listRows, listFreqs);
+    }
+
+    // 3. idf for every word; bounds for the touched ones, or for all once rows outgrow base's bounds
+    computeStatistics();
+    if (averageLength <= base.boundLength) {
+        boundLength = base.boundLength;
+        for (uint32_t t : touched) computeBounds(terms[t]);
+    } else {
+        boundLength = averageLength * kBoundHeadroom;
+        for (Term& term : terms) computeBounds(term);
+    }
+}
+
+void TextIndex::appendList(const std::vector<uint32_t>& listRows, const std::vector<uint32_t>& freqs) {
+    ListBuilder b;
+    for (size_t i = 0; i < listRows.size(); i++) b.add(listRows[i], freqs[i]);
+    uint32_t base = static_cast<uint32_t>(data.size());
+    Term term;
+    term.count = b.count;
+    term.firstSkip = static_cast<uint32_t>(skips.size());
+    term.idf = term.maxWeight = term.maxScore = 0;
+    for (size_t i = 0; i < b.blockFirst.size(); i++) {
+        skips.push_back(Skip{b.blockFirst[i], b.blockLast[i], base + b.blockOffset[i], 0.0f});
+    }
+    data.insert(data.end(), b.bytes.begin(), b.bytes.end());
+    terms.push_back(term);
+}
+
+// Bounds are maxima at boundLength, blocks rounded up to float. A weight only grows with the
+// average length, so maxima at boundLength >= averageLength bound the actual weights; topK() adds
+// bounds in the same order as the scores, so floating point rounding can't put a row's score
+// above its bound.
+void TextIndex::computeBounds(Term& term) {
+    std::vector<uint32_t> blockRows, blockFreqs;
+    term.maxWeight = 0;
+    for (size_t b = 0; b * kBlockSize < term.count; b++) {
+        decodeBlock(term, b, blockRows, blockFreqs);
+        double blockMax = 0;
+        for (size_t i = 0; i < blockRows.size(); i++) {
+            blockMax = std::max(blockMax, tfWeight(blockFreqs[i], lengths[blockRows[i]], boundLength));
+        }
+        float rounded = static_cast<float>(blockMax);
+        if (rounded < blockMax) rounded = std::nextafter(rounded, HUGE_VALF);
+        skips[term.firstSkip + b].maxWeight = rounded;
+        term.maxWeight = std::max(term.maxWeight, blockMax);
+    }
+    term.maxScore = term.idf * term.maxWeight;
+}
+
+void TextIndex::computeStatistics() {
+    uint64_t totalLength = 0;
+    for (uint16_t length : lengths) totalLength += length;
+    averageLength = rows.empty() ? 0 : static_cast<double>(totalLength) / rows.size();
+    maxRating = 0;
+    for (size_t row = 0; row < ratings.size(); row++) {
+        maxRating = row == 0 ? ratings[row] : std::max<double>(maxRating, ratings[row]);
+    }
+    for (Term& term : terms) {
+        term.idf = std::log(1.0 + (rows.size() - term.count + 0.5) / (term.count + 0.5));
+        term.maxScore = term.idf * term.maxWeight;
+    }
+}
+
+void TextIndex::exportArrays(Arrays& out) const {
+    std::vector<const std::string*> words(terms.size());
+    for (const auto& entry : termIDs) words[entry.second] = &entry.first;
+    out.words.clear();
+    out.wordOffsets.clear();
+    for (const std::string* word : words) {
+        out.wordOffsets.push_back(static_cast<uint32_t>(out.words.size()));
+        out.words.insert(out.words.end(), word->begin(), word->end());
+    }
+    out.wordOffsets.push_back(static_cast<uint32_t>(out.words.size()));
+    out.terms = terms;
+    out.skips = skips;
+    out.data = data;
+    out.lengths = lengths;
+    out.ratings = ratings;
+    out.averageLength = averageLength;
+    out.boundLength = boundLength;
+    out.maxRating = maxRating;
+}
+
+bool TextIndex::importArrays(Arrays&& in, const std::vector<Resource*>& list) {
+    clear();
+    if (!isValid(in, list.size())) return false;
+    termIDs.reserve(in.terms.size());
+    for (uint32_t t = 0; t < in.terms.size(); t++) {
+        uint32_t begin = in.wordOffsets[t], end = in.wordOffsets[t + 1];
+        if (begin > end || end > in.words.size()) {
+            clear();
+            return false;
+        }
+        termIDs.emplace(std::string(in.words.data() + begin, end - begin), t);
+    }
+    terms.swap(in.terms);
+    skips.swap(in.skips);
+    data.swap(in.data);
+    lengths.swap(in.lengths);
+    ratings.swap(in.ratings);
+    averageLength = in.averageLength;
+    boundLength = in.boundLength;
+    maxRating = in.maxRating;
+    rows = list;
+    return true;
+}
+
+bool TextIndex::isValid(const Arrays& a, size_t rowCount) {
+    if (a.wordOffsets.size() != a.terms.size() + 1 || a.wordOffsets[0] != 0 ||
+        a.wordOffsets[a.terms.size()] != a.words.size() || a.lengths.size() != rowCount ||
+        a.ratings.size() != rowCount || !(a.boundLength >= a.averageLength)) {
+        return false;
+    }
+    for (size_t t = 0; t < a.terms.size(); t++) {
+        if (a.wordOffsets[t] > a.wordOffsets[t + 1]) return false;
+    }
+    // Lists are laid out in term order, each block after the last
+    size_t nextSkip = 0;
+    for (const Term& term : a.terms) {
+        if (term.count == 0 || term.count > rowCount || term.firstSkip != nextSkip) return false;
+        nextSkip += (term.count + kBlockSize - 1) / kBlockSize;
+        if (nextSkip > a.skips.size()) return false;
+    }
+    if (nextSkip != a.skips.size()) return false;
+    for (size_t k = 0; k < a.skips.size(); k++) {
+        const Skip& skip = a.skips[k];
+        if (skip.firstRow > skip.lastRow || skip.lastRow >= rowCount || skip.offset >= a.data.size()) return false;
+        if (k > 0 && skip.offset <= a.skips[k - 1].offset) return false;
+    }
+    // Every posting decodes inside its block to an ascending row within the block's range
+    for (const Term& term : a.terms) {
+        long last = -1;
+        size_t blocks = (term.count + kBlockSize - 1) / kBlockSize;
+        for (size_t b = 0; b < blocks; b++) {
+            size_t k = term.firstSkip + b;
+            const Skip& skip = a.skips[k];
+            size_t n = std::min<size_t>(kBlockSize, term.count - b * kBlockSize);
+            const uint8_t* p = a.data.data() + skip.offset;
+            const uint8_t* end = a.data.data() + (k + 1 < a.skips.size() ? a.skips[k + 1].offset : a.data.size());
+            uint64_t row = skip.firstRow;
+            for (size_t i = 0; i < n; i++) {
+                uint32_t delta, freq;
+                if (!getVarint(p, end, delta) || !getVarint(p, end, freq)) return false;
+                row += delta;
+                if (row > skip.lastRow || static_cast<long>(row) <= last) return false;
+                last = static_cast<long>(row);
+            }
+        }
+    }
+    return true;
+}
+
+void TextIndex::clear() {
+    termIDs.clear();
+    terms.clear();
+    skips.clear();
+    data.clear();
+    lengths.clear();
+    ratings.clear();
+    rows.clear();
+    averageLength = 0;
+    boundLength = 0;
+    maxRating = 0;
+}
+
+void TextIndex::swap(TextIndex& other) {
+    termIDs.swap(other.termIDs);
+    terms.swap(other.terms);
+    skips.swap(other.skips);
+    data.swap(other.data);
+    lengths.swap(other.lengths);
+    ratings.swap(other.ratings);
+    rows.swap(other.rows);
+    std::swap(averageLength, other.averageLength);
+    std::swap(boundLength, other.boundLength);
+    std::swap(maxRating, other.maxRating);
+}
+
+size_t TextIndex::memoryUsage() const {
+    size_t bytes = terms.capacity() * sizeof(Term) + skips.capacity() * sizeof(Skip) + data.capacity() +
+                   lengths.capacity() * sizeof(uint16_t) + ratings.capacity() * sizeof(float) +
+                   rows.capacity() * sizeof(Resource*);
+    for (const auto& entry : termIDs) bytes += sizeof(entry) + entry.first.capacity() + sizeof(void*);
+    return bytes;
+}
+
+void TextIndex::decodeBlock(const Term& term, size_t b, std::vector<uint32_t>& rowsOut, std::vector<uint32_t>& freqsOut) const {
+    rowsOut.clear();
+    freqsOut.clear();
+    size_t n = std::min<size_t>(kBlockSize, term.count - b * kBlockSize);
+    const Skip& skip = skips[term.firstSkip + b];
+    const uint8_t* p = data.data() + skip.offset;
+    uint32_t row = skip.firstRow;
+    for (size_t i = 0; i < n; i++) {
+        row += getVarint(p);
+        rowsOut.push_back(row);
+        freqsOut.push_back(getVarint(p));
+    }
+}
+
+double TextIndex::tfWeight(uint32_t freq, uint32_t length, double average) {
+    double norm = kK1 * (1.0 - kB + kB * length / average);
+    return freq * (kK1 + 1.0) / (freq + norm);
+}
+
+double TextIndex::termScore(const Term& term, uint32_t freq, uint32_t row) const {
+    return term.idf * tfWeight(freq, lengths[row], averageLength);
+}
+
+size_t TextIndex::blockFor(const Cursor& c, uint32_t target) const {
+    size_t blocks = (c.term->count + kBlockSize - 1) / kBlockSize;
+    const Skip* first = skips.data() + c.term->firstSkip;
+    if (first[c.block].lastRow >= target) return c.block;
+    return static_cast<size_t>(std::lower_bound(first + c.block + 1, first + blocks, target,
+                                                [](const Skip& s, uint32_t t) { return s.lastRow < t; }) - first);
+}
+
+void TextIndex::seek(Cursor& c, uint32_t target, Stats& stats) const {
+    if (c.row >= target) return;
+    size_t blocks = (c.term->count + kBlockSize - 1) / kBlockSize;
+    size_t b = blockFor(c, target);
+    if (b != c.block) {
+        if (b == blocks) {
+            c.row = UINT32_MAX;
+            return;
+        }
+        decodeBlock(*c.term, b, c.rows, c.freqs);
+        stats.blocksDecoded++;
+        c.block = b;
+        c.pos = 0;
+    }
+    while (c.rows[c.pos] < target) c.pos++;
+    c.row = c.rows[c.pos];
+}
+
+std::vector<const TextIndex::Term*> TextIndex::lookup(std::string_view query) const {
+    std::vector<std::string> words = tokenize(query);
+    std::vector<const Term*> found;
+    for (size_t i = 0; i < words.size(); i++) {
+        if (std::find(words.begin(), words.begin() + i, words[i]) != words.begin() + i) continue; // Repeated word
+        auto it = termIDs.find(words[i]);
+        if (it != termIDs.end()) found.push_back(&terms[it->second]);
+    }
+    return found;
+}
+
+void TextIndex::topK(std::string_view query, size_t k, double ratingWeight, std::vector<Hit>& out, Stats* stats) const {
+    out.clear();
+    Stats local;
+    Stats& s = stats ? *stats : local;
+    s = Stats();
+    ratingWeight = std::max(0.0, ratingWeight);
+
+    std::vector<const Term*> found = lookup(query);
+    s.terms = found.size();
+    if (k == 0 || found.empty()) return;
+
+    std::vector<Cursor> cursors(found.size());
+    std::vector<Cursor*> order;
+    for (size_t i = 0; i < found.size(); i++) {
+        Cursor& c = cursors[i];
+        c.term = found[i];
+        c.block = 0;
+        c.pos = 0;
+        decodeBlock(*c.term, 0, c.rows, c.freqs);
+        c.row = c.rows[0];
+        s.blocksDecoded++;
+        s.postings += c.term->count;
+        order.push_back(&c);
+    }
+    const double bonusBound = ratingWeight * std::max(0.0, maxRating);
+
+    // Sum of 'bounds' over the cursors flagged in 'in', in query order like the scores, so that
+    // floating point rounding can't put a row's score above its bound
+    std::vector<char> in(cursors.size());
+    std::vector<double> bounds(cursors.size());
+    auto boundSum = [&]() {
+        double sum = 0;
+        for (size_t i = 0; i < cursors.size(); i++) {
+            if (in[i]) sum += bounds[i];
+        }
+        return sum + bonusBound;
+    };
+
+    // 'out' is a min-heap of the best k so far; a row must beat its front to get in
+    while (true) {
+        // Few cursors, and only those that moved are out of place
+        for (size_t i = 1; i < order.size(); i++) {
+            for (size_t j = i; j > 0 && order[j]->row < order[j - 1]->row; j--) std::swap(order[j], order[j - 1]);
+        }
+
+        // Pivot: the first cursor whose bound, with every cursor before it, could beat the k-th best
+        size_t pivot = order.size();
+        std::fill(in.begin(), in.end(), 0);
+        for (size_t i = 0; i < order.size() && order[i]->row != UINT32_MAX; i++) {
+            size_t c = static_cast<size_t>(order[i] - cursors.data());
+            in[c] = 1;
+            bounds[c] = order[i]->term->maxScore;
+            if (out.size() < k || boundSum() > out.front().score) {
+                pivot = i;
+                break;
+            }
+        }
+        if (pivot == order.size()) break;
+        uint32_t target = order[pivot]->row;
+        while (pivot + 1 < order.size() && order[pivot + 1]->row == target) pivot++;
+
+        // Block-max check: the blocks that would hold 'target' may all be weak even if the lists aren't
+        if (out.size() == k) {
+            uint32_t next = pivot + 1 < order.size() ? order[pivot + 1]->row : UINT32_MAX;
+            std::fill(in.begin(), in.end(), 0);
+            for (size_t i = 0; i <= pivot; i++) {
+                size_t b = blockFor(*order[i], target);
+                if (b * kBlockSize >= order[i]->term->count) continue; // List ends before 'target'
+                const Skip& skip = skips[order[i]->term->firstSkip + b];
+                size_t c = static_cast<size_t>(order[i] - cursors.data());
+                in[c] = 1;
+                bounds[c] = order[i]->term->idf * skip.maxWeight;
+                next = std::min(next, skip.lastRow + 1);
+            }
+            if (boundSum() <= out.front().score) {
+                // Nothing up to the end of the shortest of those blocks can make it
+                s.blocksSkipped++;
+                for (size_t i = 0; i <= pivot; i++) seek(*order[i], next, s);
+                continue;
+            }
+        }
+
+        if (order[0]->row != target) {
+            // Rows before 'target' can't make the top k: skip the lagging lists past them
+            for (size_t i = 0; i < pivot; i++) seek(*order[i], target, s);
+            continue;
+        }
+
+        // Score 'target', summing words in query order
+        double score = 0;
+        for (const Cursor& c : cursors) {
+            if (c.row == target) score += termScore(*c.term, c.freqs[c.pos], target);
+        }
+        score += ratingWeight * ratings[target];
+        s.scored++;
+        Hit hit{target, score};
+        if (out.size() < k) {
+            out.push_back(hit);
+            std::push_heap(out.begin(), out.end(), betterHit);
+        } else if (betterHit(hit, out.front())) {
+            std::pop_heap(out.begin(), out.end(), betterHit);
+            out.back() = hit;
+            std::push_heap(out.begin(), out.end(), betterHit);
+        }
+        for (Cursor& c : cursors) {
+            if (c.row == target) seek(c, target + 1, s);
+        }
+    }
+
+    std::sort(out.begin(), out.end(), betterHit);
+}
+
+void TextIndex::topKExhaustive(std::string_view query, size_t k, double ratingWeight, std::vector<Hit>& out,
+                               Stats* stats) const {
+    out.clear();
+    Stats local;
+    Stats& s = stats ? *stats : local;
+    s = Stats();
+    ratingWeight = std::max(0.0, ratingWeight);
+
+    std::vector<const Term*> found = lookup(query);
+    s.terms = found.size();
+    std::vector<double> scores(rows.size(), 0.0);
+    std::vector<bool> touched(rows.size(), false);
+    std::vector<uint32_t> matched, blockRows, blockFreqs;
+    for (const Term* term : found) {
+        s.postings += term->count;
+        for (size_t b = 0; b * kBlockSize < term->count; b++) {
+            decodeBlock(*term, b, blockRows, blockFreqs);
+            s.blocksDecoded++;
+            for (size_t i = 0; i < blockRows.size(); i++) {
+                uint32_t row = blockRows[i];
+                scores[row] += termScore(*term, blockFreqs[i], row);
+                if (!touched[row]) {
+                    touched[row] = true;
+                    matched.push_back(row);
+                }
+            }
+        }
+    }
+    for (uint32_t row : matched) out.push_back(Hit{row, scores[row] + ratingWeight * ratings[row]});
+    s.scored = out.size();
+    if (out.size() > k) {
+        std::partial_sort(out.begin(), out.begin() + k, out.end(), betterHit);
+        out.resize(k);
+    } else {
+        std::sort(out.begin(), out.end(), betterHit);
+    }
+}
@@ -3,9 +3,15 @@
 #include <vector>
 #include <fstream>
 #include <sstream>
+#include <cstdlib>
+#include <thread>
 #include "../include/Resource.h"
 #include "../include/CSVParser.h"
 #include "../include/Engine.h"
+#include "../include/Server.h"
+#include "../include/Batch.h"
+#include "../include/Snapshot.h"
+#include "../include/BinaryCatalog.h"
 
 using namespace std;
 
@@ -20,25 +26,163 @@ int main(int argc, char* argv[]) {
     string csvPath = "data/resources.csv";
     if (!fileExists(csvPath)) csvPath = "../data/resources.csv"; // Check parent
     if (!fileExists(csvPath)) csvPath = "../../data/resources.csv"; // Check grandparent
+    // Serving nodes can point at a binary catalog (or another CSV) instead
+    if (const char* catalog = getenv("CODECOMPASS_CATALOG")) {
+        if (*catalog) csvPath = catalog;
+    }
+    bool binaryCatalog = BinaryCatalog::isBinaryCatalog(csvPath);
+
+    string mode = argc > 1 ? argv[1] : "";
+
+    if (mode == "--export-catalog") {
+        // --- BINARY CATALOG EXPORT ---
+        // Usage: --export-catalog [out]   (default: the CSV's path with a .ccbin extension)
+        string outPath = argc > 2 ? argv[2] : BinaryCatalog::defaultPathFor(csvPath);
+        ResourceStore store;
+        vector<Resource*> data = binaryCatalog ? BinaryCatalog::loadResources(csvPath, &store)
+                                               : CSVParser::loadResources(csvPath, &store);
+        if (data.empty()) {
+            cerr << "Error: Could not load resources from " << csvPath << endl;
+            return 1;
+        }
+        if (!BinaryCatalog::write(outPath, data)) {
+            cerr << "Error: Could not write binary catalog to " << outPath << endl;
+            return 1;
+        }
+        cerr << "Binary catalog (" << data.size() << " resources) written to " << outPath << endl;
+        return 0;
+    }
+    string snapPath = Snapshot::defaultPathFor(csvPath);
+
+    Snapshot::SourceStamp stamp = {0, 0};
+    Snapshot::stampFile(csvPath, stamp);
 
-    // 2. Load Data
-    vector<Resource*> data = CSVParser::loadResources(csvPath);
-    if (data.empty()) {
-        cerr << "Error: Could not load resources.csv from " << csvPath << endl;
+    if (mode == "--verify-snapshot") {
+        // --- SNAPSHOT CHECK ---
+        // Usage: --verify-snapshot [path]   Startup only checks the header; this reads everything.
+        if (argc > 2) snapPath = argv[2];
+        Snapshot::Image image;
+        string reason;
+        if (!image.open(snapPath, stamp, reason, true)) {
+            cerr << "Snapshot " << snapPath << " is not usable (" << reason << ")" << endl;
+            return 1;
+        }
+        cerr << "Snapshot " << snapPath << " is valid (" << image.resourceCount() << " resources)" << endl;
+        return 0;
+    }
+
+    // 2. Build the Engine: from a valid snapshot if there is one, otherwise from the CSV.
+    // The image stays mapped for the engine's lifetime: its resources point into it.
+    Engine* engine = nullptr;
+    Snapshot::Image image;
+    if (mode != "--build-snapshot") {
+        string reason;
+        if (image.open(snapPath, stamp, reason)) {
+            engine = new Engine();
+            if (!engine->loadSnapshot(image, reason)) {
+                delete engine;
+                engine = nullptr;
+            }
+        }
+        if (!engine && reason != "not found") {
+            cerr << "Snapshot " << snapPath << " ignored (" << reason << "), rebuilding from CSV" << endl;
+        }
+    }
+
+    if (!engine && mode == "--build-snapshot") {
+        // Snapshot builds (nightly rebuilds of large catalogs) parse on every core;
+        // the result is sorted by ID, which is the order the snapshot stores anyway.
+        engine = new Engine();
+        vector<Resource*> data = binaryCatalog
+            ? BinaryCatalog::loadResources(csvPath, &engine->resources())
+            : CSVParser::loadResourcesParallel(csvPath, 0, 1 << 20, &engine->resources());
+        engine->ingest(data);
+        engine->finishIngest();
+    } else if (!engine) {
+        // Index each batch while the parser works on the next one (binary catalogs: one block per batch)
+        engine = new Engine();
+        auto sink = [engine](vector<Resource*>& batch) { engine->ingest(batch); };
+        if (binaryCatalog && !BinaryCatalog::streamResources(csvPath, sink, &engine->resources())) {
+            // Serving part of the catalog would look like success to every client
+            cerr << "Error: " << csvPath << " is incomplete or damaged, not starting" << endl;
+            delete engine;
+            return 1;
+        }
+        if (!binaryCatalog) CSVParser::streamResources(csvPath, 4096, sink, &engine->resources());
+        engine->finishIngest();
+    }
+    if (engine && engine->resourceCount() == 0) {
+        delete engine;
+        engine = nullptr;
+    }
+    if (!engine) {
+        cerr << "Error: Could not load resources from " << csvPath << endl;
         return 1;
     }
 
-    // 3. Initialize Engine (Builds Trie, AVL, Graph, Heap)
-    Engine engine(data);
+    engine->setSourcePath(csvPath); // For RELOAD
 
-    // 4. Mode Selection
-    if (argc > 1) {
+    // 3. Mode Selection
+    int rc = 0;
+    if (mode == "--build-snapshot") {
+        // --- SNAPSHOT BUILD MODE ---
+        if (argc > 2) snapPath = argv[2];
+        // Verify the written file in full, so startup can get by with a header check
+        string reason;
+        Snapshot::Image written;
+        if (!engine->saveSnapshot(snapPath, stamp)) {
+            cerr << "Error: Could not write snapshot to " << snapPath << endl;
+            rc = 1;
+        } else if (!written.open(snapPath, stamp, reason, true)) {
+            cerr << "Error: Snapshot written to " << snapPath << " does not verify (" << reason << ")" << endl;
+            rc = 1;
+        } else {
+            cerr << "Snapshot written to " << snapPath << endl;
+        }
+    }
+    else if (mode == "--serve") {
+        // --- PERSISTENT SERVER MODE ---
+        // Engine is built once above; every framed request reuses it. Indexes deferred
+        // to first use are built in the background meanwhile.
+        thread warm([engine] { engine->buildDeferredIndexes(); });
+        rc = Server::serveStdio(*engine);
+        warm.join();
+    }
+    else if (mode == "--socket") {
+        // --- CONCURRENT SOCKET SERVER MODE ---
+        // Usage: --socket <path> [workers]
+        string socketPath = argc > 2 ? argv[2] : "codecompass.sock";
+        int workers = 0;
+        if (argc > 3) {
+            try { workers = stoi(argv[3]); } catch (...) { workers = 0; }
+        }
+        thread warm([engine] { engine->buildDeferredIndexes(); });
+        rc = Server::serveSocket(*engine, socketPath, workers);
+        warm.join();
+    }
+    else if (mode == "--batch") {
+        // --- BATCH MODE ---
+        // Usage: --batch [file]   (no file or "-" reads commands from stdin)
+        string batchPath = argc > 2 ? argv[2] : "-";
+        if (batchPath == "-") {
+            rc = Batch::run(*engine, cin, cout);
+        } else {
+            ifstream batchFile(batchPath);
+            if (!batchFile.is_open()) {
+                cerr << "Error: Could not open batch file " << batchPath << endl;
+                rc = 1;
+            } else {
+                rc = Batch::run(*engine, batchFile, cout);
+            }
+        }
+    }
+    else if (argc > 1) {
         // --- CLI / SUBPROCESS MODE ---
         // Now fully delegated to Engine.
         // Commands like "CRAM|Topic|Time" are handled via engine.execute()
         // utilizing Trie and Cache internally.
         string command = argv[1];
-        engine.execute(command);
+        if (!engine->execute(command)) rc = 1;
     }
     else {
         // --- INTERACTIVE DEBUG MODE ---
@@ -50,11 +194,11 @@ int main(int argc, char* argv[]) {
             cout << "> ";
             if(!getline(cin, input)) break;
             if(input == "exit") break;
-            engine.execute(input);
+            engine->execute(input);
         }
     }
 
-    // Cleanup
-    for (auto* r : data) delete r;
-    return 0;
-}
\ No newline at end of file
+    // Cleanup: every resource lives in the engine's store and goes with it
+    delete engine;
+    return rc;
+}
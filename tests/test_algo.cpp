@@ -1,8 +1,12 @@
 #include "../include/CSVParser.h"
 #include "../include/Sorters.h"
+#include "../include/ColumnStore.h"
+#include "../include/MaxHeap.h"
+#include <cassert>
 #include <iostream>
 #include <iomanip> // For std::setw
 #include <vector>
+#include <algorithm>
 #include <chrono>  // For timing
 #include <random>  // For generating large datasets
 
@@ -203,6 +207,61 @@ void runScriptDemo() {
     for(auto* r : items) delete r;
 }
 
+// Column filters must agree with a plain loop, and topByRating with a stable sort (ties included)
+void testColumnStore() {
+    std::cout << "\n[TEST] Running Column Store Test (" << ColumnStore::kernelName() << " kernel)..." << std::endl;
+
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> diff(1, 100), rating(1, 10);
+    const char* topics[] = {"Graphs", "Trees", "Heaps"};
+    std::vector<Resource*> items;
+    for (int i = 0; i < 1003; i++) { // Not a multiple of 8: exercises the scalar tail
+        items.push_back(new Resource(i, "T", "u", topics[i % 3], diff(rng), rating(rng) / 2.0, {}, 30));
+    }
+
+    ColumnStore columns;
+    columns.append(std::vector<Resource*>(items.begin(), items.begin() + 500));
+    columns.append(std::vector<Resource*>(items.begin() + 500, items.end()));
+    assert(columns.size() == items.size() && columns.row(700) == items[700]);
+
+    Selection sel;
+    columns.selectRange(ColumnStore::DIFFICULTY, 36, 70, sel);
+    Selection expected;
+    for (uint32_t i = 0; i < items.size(); i++) {
+        if (items[i]->difficulty >= 36 && items[i]->difficulty <= 70) expected.push_back(i);
+    }
+    assert(sel == expected);
+
+    columns.selectIDs({700, 5, 99999, 12}, sel);
+    assert((sel == Selection{700, 5, 12}));
+    columns.selectRange(ColumnStore::DIFFICULTY, 200, 300, sel);
+    assert(sel.empty());
+
+    // Best first, ties in selection order: a stable sort of the selection by rating
+    Selection sorted = expected;
+    std::stable_sort(sorted.begin(), sorted.end(), [&items](uint32_t a, uint32_t b) {
+        return items[a]->rating > items[b]->rating;
+    });
+    for (size_t k : {0, 1, 10, 64, 1003}) {
+        Selection top;
+        size_t pushes = columns.topByRating(expected, k, top);
+        size_t want = std::min(k, expected.size());
+        assert(top.size() == want && pushes >= want);
+        assert(std::equal(top.begin(), top.end(), sorted.begin()));
+    }
+
+    // RELOAD-style update: the last row moves into row 5, whose resource left
+    std::vector<Resource*> list(items.begin(), items.end() - 1);
+    list[5] = items.back();
+    columns.update(list, {5});
+    assert(columns.size() == 1002 && columns.row(5) == items.back() && columns.idColumn()[5] == 1002);
+    columns.selectIDs({1002, 5, 6}, sel);
+    assert((sel == Selection{5, 6}));
+
+    for (auto* r : items) delete r;
+    std::cout << "[PASS] Column Store Test Passed." << std::endl;
+}
+
 int main() {
     // ---------------------------------------------------------
     // PHASE 1: Verify Correctness on Real Data
@@ -227,6 +286,7 @@ int main() {
     // PHASE 2 & 3: Rigorous Tests
     // ---------------------------------------------------------
     testEdgeCases();
+    testColumnStore();
     comparePerformance();
 
     // ---------------------------------------------------------
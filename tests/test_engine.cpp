@@ -0,0 +1,195 @@
+#include "../include/Engine.h"
+#include "../include/CSVParser.h"
+#include "../include/Snapshot.h"
+#include <iostream>
+#include <cassert>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Commands whose output depends on every index the engine loads
+static const std::vector<std::string> kCommands = {
+    "SEARCH|a", "SEARCH|gr|5", "COMPLETE|a|10", "COMPLETE|g|5", "CONTAINS|sort", "CONTAINS|s",
+    "FUZZY|dijkstar|1|20", "RANK|graph shortest path|10|0.3", "RANK|sorting|5",
+    "LIST|DIFFICULTY", "LIST|TOPIC", "SUGGEST|5|BEGINNER", "SUGGEST|10|ALL",
+    "PLAN|Heap Sort", "CRAM|Graphs|120", "TITLES", "BACK"
+};
+
+// Runs every command in one session, without analysis output (it carries timings)
+static std::string runAll(Engine& engine) {
+    Session session;
+    session.analysis = ANALYSIS_NONE;
+    std::ostringstream out;
+    for (const std::string& command : kCommands) {
+        out << "> " << command << '\n';
+        engine.execute(command, session, out);
+    }
+    return out.str();
+}
+
+static std::string readFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream bytes;
+    bytes << in.rdbuf();
+    return bytes.str();
+}
+
+static void writeFile(const std::string& path, const std::string& bytes) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+void testSnapshotRoundTrip() {
+    std::cout << "\n[TEST] Running Snapshot Round-Trip Test..." << std::endl;
+
+    const std::string csvPath = "data/resources.csv";
+    const std::string snapPath = "test_engine.tmp.ccsnap";
+    Snapshot::SourceStamp stamp;
+    assert(Snapshot::stampFile(csvPath, stamp));
+
+    Engine fromCSV;
+    std::vector<Resource*> data = CSVParser::loadResources(csvPath, &fromCSV.resources());
+    assert(!data.empty());
+    fromCSV.ingest(data);
+    fromCSV.finishIngest();
+    std::string expected = runAll(fromCSV);
+    assert(fromCSV.saveSnapshot(snapPath, stamp));
+
+    {
+        Snapshot::Image image;
+        std::string reason;
+        assert(image.open(snapPath, stamp, reason, true));
+        assert(image.resourceCount() == data.size());
+        Engine fromSnapshot;
+        assert(fromSnapshot.loadSnapshot(image, reason));
+        assert(fromSnapshot.resourceCount() == data.size());
+        assert(runAll(fromSnapshot) == expected);
+    }
+
+    // A changed CSV makes the snapshot stale
+    {
+        Snapshot::Image image;
+        std::string reason;
+        Snapshot::SourceStamp changed = stamp;
+        changed.size++;
+        assert(!image.open(snapPath, changed, reason));
+        assert(reason == "stale (CSV changed)");
+    }
+
+    // Damaged payloads: the header still checks out, so only loading (or verifying) can tell
+    const std::string original = readFile(snapPath);
+    const Snapshot::Header& header = *reinterpret_cast<const Snapshot::Header*>(original.data());
+    auto damage = [&](Snapshot::Section s, size_t at, uint32_t value, const std::string& expectedReason) {
+        std::string bytes = original;
+        size_t offset = static_cast<size_t>(header.sections[s].offset) + at;
+        assert(offset + sizeof(value) <= bytes.size());
+        std::memcpy(&bytes[offset], &value, sizeof(value));
+        writeFile(snapPath, bytes);
+
+        Snapshot::Image image;
+        std::string reason;
+        assert(image.open(snapPath, stamp, reason));
+        Engine damaged;
+        assert(!damaged.loadSnapshot(image, reason));
+        assert(reason == expectedReason);
+        assert(!image.open(snapPath, stamp, reason, true));
+        assert(reason == "checksum mismatch");
+    };
+    damage(Snapshot::RESOURCES, offsetof(Snapshot::ResourceRecord, topic), 0xFFFFFFFFu, "bad resource record");
+    damage(Snapshot::RESOURCES, offsetof(Snapshot::ResourceRecord, titleLength), 0x7FFFFFFFu, "bad resource record");
+    damage(Snapshot::ADJ_OFFSETS, sizeof(uint32_t), 0x00FFFFFFu, "bad adjacency");
+    damage(Snapshot::ORDER_TOPIC, 0, 0x00FFFFFFu, "bad ordering");
+    damage(Snapshot::TRIE_CHILD_NODES, 0, 0x00FFFFFFu, "bad trie");
+    damage(Snapshot::INFIX_DATA, 0, 0xFFFFFFFFu, "bad substring index");
+    damage(Snapshot::TEXT_DATA, 0, 0xFFFFFFFFu, "bad text index");
+
+    std::remove(snapPath.c_str());
+    std::cout << "[PASS] Snapshot Round-Trip Test Passed." << std::endl;
+}
+
+// Replaces line 'index' (0 = header) of a CSV
+static void setLine(std::vector<std::string>& lines, size_t index, const std::string& line) {
+    assert(index < lines.size());
+    lines[index] = line;
+}
+
+void testReloadMatchesFreshStart() {
+    std::cout << "\n[TEST] Running RELOAD Test..." << std::endl;
+
+    const std::string livePath = "test_engine.tmp.csv";
+    const std::string editedPath = "test_engine.tmp.edited.csv";
+    std::string base = readFile("data/resources.csv");
+    std::vector<std::string> lines;
+    std::istringstream in(base);
+    for (std::string line; std::getline(in, line);) lines.push_back(line);
+
+    // Change a title and a prereq list, drop two rows, add two (one unlocked by Heap Sort)
+    setLine(lines, 3, "103,Arrays and Pointer Tricks,https://www.google.com/search?q=array+data+structure,Arrays,5,4.2,,10");
+    setLine(lines, 8, "108,Binary Search Algorithm,https://www.google.com/search?q=binary+search,Searching,30,4.7,103;104,30");
+    lines.erase(lines.begin() + 40);
+    lines.erase(lines.begin() + 5);
+    lines.push_back("9001,Advanced Heap Sorting,https://example.com/heaps,Sorting,70,4.9,131,30");
+    lines.push_back("9002,Pointer Graph Walks,https://example.com/walks,Graphs,20,4.0,,10");
+    std::string edited;
+    for (const std::string& line : lines) edited += line + "\n";
+    writeFile(editedPath, edited);
+
+    const std::vector<std::string> queries = {
+        "SEARCH|a", "SEARCH|Arr", "SEARCH|Pointer", "PLAN|Advanced Heap Sorting", "PLAN|Binary Search Algorithm",
+        "CONTAINS|pointer", "CONTAINS|sort", "CONTAINS|tricks", "RANK|pointer graph|5", "RANK|heap sorting|5",
+        "COMPLETE|a|10", "COMPLETE|p|5", "SEARCH|Singly"
+    };
+    auto answers = [&queries](Engine& engine) {
+        Session session;
+        session.analysis = ANALYSIS_NONE;
+        std::ostringstream out;
+        for (const std::string& query : queries) {
+            out << "> " << query << '\n';
+            engine.execute(query, session, out);
+        }
+        return out.str();
+    };
+
+    Engine fresh;
+    std::vector<Resource*> freshData = CSVParser::loadResources(editedPath, &fresh.resources());
+    fresh.ingest(freshData);
+    fresh.finishIngest();
+    std::string expected = answers(fresh);
+    assert(expected.find("Advanced Heap Sorting") != std::string::npos);
+    assert(expected.find("Singly Linked List") == std::string::npos);
+
+    // With the CONTAINS/RANK indexes still unbuilt at reload time, and with them built (patched)
+    for (int warm = 0; warm < 2; warm++) {
+        writeFile(livePath, base);
+        Engine live;
+        std::vector<Resource*> data = CSVParser::loadResources(livePath, &live.resources());
+        live.ingest(data);
+        live.finishIngest();
+        live.setSourcePath(livePath);
+        if (warm) {
+            live.buildDeferredIndexes();
+            assert(answers(live) != expected);
+        }
+
+        writeFile(livePath, edited);
+        Session session;
+        std::ostringstream out;
+        assert(live.execute("RELOAD", session, out));
+        assert(live.resourceCount() == freshData.size());
+        assert(answers(live) == expected);
+    }
+
+    std::remove(livePath.c_str());
+    std::remove(editedPath.c_str());
+    std::cout << "[PASS] RELOAD Test Passed." << std::endl;
+}
+
+int main() {
+    testSnapshotRoundTrip();
+    testReloadMatchesFreshStart();
+    return 0;
+}
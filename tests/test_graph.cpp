@@ -7,6 +7,7 @@
 #include "../include/KnowledgeGraph.h"
 #include "../include/MaxHeap.h"
 #include "../include/Resource.h"
+#include "../include/Log.h"
 
 using namespace std;
 
@@ -43,8 +44,7 @@ void testMaxHeapPerformance() {
     // --- Insertion Timing (O(N log N)) ---
     auto start_insert = chrono::high_resolution_clock::now();
     for (Resource& r : resources) {
-        // PASSING 'false' TO DISABLE PRINTING during bulk test
-        heap.insert(&r, false);
+        heap.insert(&r);
     }
     auto end_insert = chrono::high_resolution_clock::now();
     auto duration_insert = chrono::duration_cast<chrono::microseconds>(end_insert - start_insert);
@@ -53,8 +53,7 @@ void testMaxHeapPerformance() {
     const int NUM_EXTRACT = NUM_RESOURCES / 5; // Extract 10,000 elements
     auto start_extract = chrono::high_resolution_clock::now();
     for (int i = 0; i < NUM_EXTRACT; ++i) {
-        // PASSING 'false' TO DISABLE PRINTING
-        if (heap.extractMax(false) == nullptr) break;
+        if (heap.extractMax() == nullptr) break;
     }
     auto end_extract = chrono::high_resolution_clock::now();
     auto duration_extract = chrono::duration_cast<chrono::microseconds>(end_extract - start_extract);
@@ -65,10 +64,9 @@ void testMaxHeapPerformance() {
          << duration_extract.count() << " us" << endl;
 
     // Cleanup for next test
-    // PASSING 'false' TO DISABLE PRINTING during cleanup
     int cleanup_count = 0;
     const int MAX_CLEANUP_ITERATIONS = NUM_RESOURCES * 2;
-    while (heap.extractMax(false) != nullptr) {
+    while (heap.extractMax() != nullptr) {
         cleanup_count++;
         if (cleanup_count > MAX_CLEANUP_ITERATIONS) {
             cerr << "[ERROR] MaxHeap Cleanup failed to terminate. Potential infinite loop in extractMax()." << endl;
@@ -88,7 +86,8 @@ void testMaxHeapVisualization() {
 
     MaxHeap heap;
 
-    // Default call uses doPrint=true
+    // Trace logging shows the heap array after every operation (on stderr)
+    Log::setLevel(Log::LEVEL_TRACE);
     heap.insert(&r3);
     heap.insert(&r2);
     heap.insert(&r1);
@@ -100,8 +99,9 @@ void testMaxHeapVisualization() {
     Resource* max2 = heap.extractMax();
     assert(max2 != nullptr && max2->id == 2);
 
-    // Clean up remaining elements - passing 'false' to avoid clutter
-    while (heap.extractMax(false) != nullptr);
+    // Clean up remaining elements quietly
+    Log::setLevel(Log::LEVEL_WARN);
+    while (heap.extractMax() != nullptr);
 
     cout << "[PASS] MaxHeap Visualization Tests Passed." << endl;
 }
@@ -122,10 +122,7 @@ void testGraphAdjacencyListVisualization() {
 
     std::vector<Resource*> testResources = {&r1, &r2, &r3, &r4, &r5};
 
-    // Suppress verbose output for clean test run
-    std::cout.setstate(std::ios_base::failbit);
-    kg.buildGraph(testResources);
-    std::cout.clear();
+    kg.buildGraph(testResources); // Edge-by-edge output is trace-level logging now
 
     // Print the full graph structure (Adjacency List)
     kg.printGraphState();
@@ -182,10 +179,7 @@ void verifyComplexity() {
             kg.addResource(resources.back());
         }
 
-        // Suppress output during benchmark
-        std::cout.setstate(std::ios_base::failbit);
         kg.buildGraph(resources);
-        std::cout.clear();
 
         auto start = std::chrono::high_resolution_clock::now();
         // Get curriculum for the last node (forces traversal of entire chain)
@@ -230,10 +224,7 @@ void runScriptDemo() {
     kg.addResource(&r1); kg.addResource(&r2); kg.addResource(&r3);
     std::vector<Resource*> list = {&r1, &r2, &r3};
 
-    // Suppress verbose output from buildGraph for clean demo
-    std::cout.setstate(std::ios_base::failbit);
     kg.buildGraph(list);
-    std::cout.clear();
 
     std::cout << "[TEST] Generating Learning Path for 'Dijkstra' (ID:3)...\n";
     std::cout << "       Dependency Chain detected: Dijkstra -> Heaps -> Arrays\n";
@@ -252,8 +243,57 @@ void runScriptDemo() {
     }
 }
 
+// Incremental edits must leave the same graph/heap a full rebuild would produce
+void testIncrementalUpdates() {
+    cout << "\n[TEST] Running Incremental Update (RELOAD) Test..." << endl;
+
+    Resource a = {1, "A", "", "", 10, 4.0f, {}, 20};
+    Resource b = {2, "B", "", "", 20, 4.5f, {1}, 25};
+    Resource c = {3, "C", "", "", 30, 5.0f, {2}, 30};
+    Resource c2 = {3, "C v2", "", "", 30, 3.0f, {1}, 30};
+
+    KnowledgeGraph kg;
+    for (Resource* r : {&a, &b, &c}) kg.addResource(r);
+    kg.buildGraph({&a, &b, &c});
+
+    // Removing B parks C's edge; re-adding B restores it
+    kg.removeResource(&b);
+    assert(kg.getEdgeCount() == 0);
+    assert(kg.getDependents(2) == nullptr && kg.getDependents(1) == nullptr);
+    kg.insertResource(&b);
+    assert(kg.getEdgeCount() == 2);
+    assert((kg.getCurriculum(3) == vector<int>{1, 2, 3}));
+
+    // Updating C in place re-links only its prerequisites
+    IdList before = c.prereqIDs;
+    c.prereqIDs = c2.prereqIDs;
+    kg.updateResource(&c, before);
+    assert(kg.getEdgeCount() == 2);
+    assert(kg.getDependents(2) == nullptr);
+    assert((kg.getCurriculum(3) == vector<int>{1, 3}));
+
+    // Heap: arbitrary removal with position tracking keeps max order
+    std::vector<Resource> resources = generateRandomResources(500, 1);
+    MaxHeap heap(true);
+    for (Resource& r : resources) heap.insert(&r);
+    for (size_t i = 0; i < resources.size(); i += 3) assert(heap.remove(&resources[i]));
+    assert(!heap.remove(&resources[0]));
+    float last = 6.0f;
+    int count = 0;
+    while (Resource* r = heap.extractMax()) {
+        assert(r->rating <= last);
+        assert(r->id % 3 != 1); // Removed entries never come back out
+        last = r->rating;
+        count++;
+    }
+    assert(count == 333);
+
+    cout << "[PASS] Incremental Update Test Passed." << endl;
+}
+
 int main() {
     // testMaxHeapPerformance();
+    testIncrementalUpdates();
     verifyComplexity(); // <--- NEW
     runScriptDemo();
     return 0;
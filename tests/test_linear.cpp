@@ -7,6 +7,7 @@
 #include "../include/LRUCache.h"
 #include "../include/Stack.h"
 #include "../include/Resource.h"
+#include "../include/Log.h"
 
 using namespace std;
 
@@ -43,8 +44,7 @@ void testStackPerformance() {
     // --- Push Timing (O(1)) ---
     auto start_push = chrono::high_resolution_clock::now();
     for (Resource& r : resources) {
-        // Suppress print output for performance test
-        s.push(&r, false);
+        s.push(&r);
     }
     auto end_push = chrono::high_resolution_clock::now();
     auto duration_push = chrono::duration_cast<chrono::microseconds>(end_push - start_push);
@@ -52,8 +52,7 @@ void testStackPerformance() {
     // --- Pop Timing (O(1)) ---
     auto start_pop = chrono::high_resolution_clock::now();
     for (int i = 0; i < NUM_OPERATIONS; ++i) {
-        // Suppress print output for performance test
-        s.pop(false);
+        s.pop();
     }
     auto end_pop = chrono::high_resolution_clock::now();
     auto duration_pop = chrono::duration_cast<chrono::microseconds>(end_pop - start_pop);
@@ -75,8 +74,7 @@ void testLRUCachePerformance() {
 
     // 1. Fill the cache
     for (Resource& r : resources) {
-        // Suppress print output for performance test
-        cache.put(&r, false);
+        cache.put(&r);
     }
 
     // 2. Perform Random Access (mostly Cache Hits, checking O(1) behavior)
@@ -87,8 +85,7 @@ void testLRUCachePerformance() {
     // --- Get Timing (O(1)) ---
     auto start_get = chrono::high_resolution_clock::now();
     for (int i = 0; i < NUM_OPERATIONS; ++i) {
-        // Suppress print output for performance test
-        cache.get(distrib(gen), false);
+        cache.get(distrib(gen));
     }
     auto end_get = chrono::high_resolution_clock::now();
     auto duration_get = chrono::duration_cast<chrono::microseconds>(end_get - start_get);
@@ -101,8 +98,7 @@ void testLRUCachePerformance() {
     auto start_put = chrono::high_resolution_clock::now();
     for (int i = 0; i < NUM_OPERATIONS; ++i) {
         // Use a small set of resources to ensure high cache hit rate and check complexity
-        // Suppress print output for performance test
-        cache.put(&resources[i % CACHE_CAPACITY], false);
+        cache.put(&resources[i % CACHE_CAPACITY]);
     }
     auto end_put = chrono::high_resolution_clock::now();
     auto duration_put = chrono::duration_cast<chrono::microseconds>(end_put - start_put);
@@ -122,7 +118,8 @@ void testStack() {
 
     Stack history;
 
-    // Default calls (no 'false' flag) use doPrint=true for visualization
+    // Trace logging shows the state after every operation (on stderr)
+    Log::setLevel(Log::LEVEL_TRACE);
     history.push(&r1);
     history.push(&r2);
     history.push(&r3);
@@ -133,8 +130,9 @@ void testStack() {
     Resource* peeked = history.peek();
     assert(peeked != nullptr && peeked->id == 1);
 
-    // Clean up remaining element, suppressing print
-    history.pop(false);
+    // Clean up remaining element quietly
+    Log::setLevel(Log::LEVEL_WARN);
+    history.pop();
 
     cout << "[PASS] Stack Tests Passed." << endl;
 }
@@ -150,7 +148,8 @@ void testLRUCacheVisualization() {
 
     LRUCache cache(3);
 
-    // Default calls (no 'false' flag) use doPrint=true for visualization
+    // Trace logging shows the state after every operation (on stderr)
+    Log::setLevel(Log::LEVEL_TRACE);
     cache.put(&r1);
     cache.put(&r2);
     cache.put(&r3);
@@ -160,12 +159,13 @@ void testLRUCacheVisualization() {
     cout << "\n--- CAUSING EVICTION (Resource B [ID 20] should be evicted) ---" << endl;
     cache.put(&r4);
 
-    // Suppress prints during assertion checks
-    assert(cache.get(20, false) == nullptr);
+    // Quiet again for the assertion checks
+    Log::setLevel(Log::LEVEL_WARN);
+    assert(cache.get(20) == nullptr);
     assert(cache.size() == 3);
 
-    assert(cache.get(30, false) != nullptr);
-    assert(cache.get(40, false) != nullptr);
+    assert(cache.get(30) != nullptr);
+    assert(cache.get(40) != nullptr);
 
     cout << "[PASS] LRU Cache Visualization Tests Passed." << endl;
 }
@@ -188,13 +188,13 @@ void verifyComplexity() {
     for (int N : op_counts) {
         LRUCache cache(1000); // Fixed capacity
         std::vector<Resource> resources = generateRandomResources(1000, 1);
-        for(auto& r : resources) cache.put(&r, false); // Fill
+        for(auto& r : resources) cache.put(&r); // Fill
 
         auto start = std::chrono::high_resolution_clock::now();
         for(int i=0; i<N; i++) {
             // Mix of hits (ID < 1000) and misses (ID > 1000)
             int id = rand() % 2000;
-            cache.get(id, false);
+            cache.get(id);
         }
         auto end = std::chrono::high_resolution_clock::now();
         std::chrono::duration<double, std::milli> elapsed = end - start;
@@ -223,18 +223,18 @@ void runScriptDemo() {
     Resource r3 = {3, "R3", "", "", 30, 5.0f, {}, 40};
 
     std::cout << "[STEP 1] Filling Cache (Cap: 2)...\n";
-    cache.put(&r1, false);
-    cache.put(&r2, false);
+    cache.put(&r1);
+    cache.put(&r2);
     std::cout << "       Added R1, R2. Cache Size: " << cache.size() << "\n";
 
     std::cout << "[STEP 2] Accessing R1 (Move to Head)...\n";
-    cache.get(1, false);
+    cache.get(1);
 
     std::cout << "[STEP 3] Adding R3 (Should Evict Tail: R2)...\n";
-    cache.put(&r3, false);
+    cache.put(&r3);
 
     // Verify
-    if (cache.get(2, false) == nullptr && cache.get(1, false) != nullptr) {
+    if (cache.get(2) == nullptr && cache.get(1) != nullptr) {
         std::cout << "       Eviction Confirmed: ID 2 (R2) Removed.\n";
         std::cout << "[PASS] O(1) Eviction & O(1) Access Verified.\n";
     } else {
@@ -1,5 +1,315 @@
 #include "../include/CSVParser.h"
+#include "../include/CSVScan.h"
+#include "../include/BinaryCatalog.h"
 #include <iostream>
+#include <cassert>
+#include <cstring>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+// Parses an in-memory CSV (with header row) through the mapped-file code path
+static std::vector<Resource*> parseText(const char* text, size_t& rejected) {
+    std::vector<Resource*> out;
+    rejected = CSVParser::parseRecords(text, std::strlen(text), out, "inline", 1, true);
+    return out;
+}
+
+void testQuotedFields() {
+    std::cout << "\n[TEST] Running RFC 4180 Quoting Test..." << std::endl;
+
+    const char* text =
+        "ID,Title,URL,Topic,Difficulty,Rating,Prereqs,Duration\r\n"
+        "1,\"Graphs, Part 1\",http://a,Graphs,10,4.5,,15\r\n"
+        "2,\"The \"\"Best\"\" Heap\",http://b,Heaps,20,4.0,1;3,25\r\n"
+        "\r\n"
+        "3,\"Two\nLines\",http://c,Trees, 30 ,5,1,40";
+    size_t rejected;
+    std::vector<Resource*> data = parseText(text, rejected);
+
+    assert(rejected == 0);
+    assert(data.size() == 3);
+    assert(data[0]->title == "Graphs, Part 1" && data[0]->topic == "Graphs");
+    assert(data[1]->title == "The \"Best\" Heap");
+    assert((data[1]->prereqIDs == std::vector<int>{1, 3}));
+    assert(data[2]->title == "Two\nLines" && data[2]->difficulty == 30 && data[2]->duration == 40);
+
+    for (auto* r : data) delete r;
+    std::cout << "[PASS] RFC 4180 Quoting Test Passed." << std::endl;
+}
+
+void testRowErrors() {
+    std::cout << "\n[TEST] Running Per-Row Error Test..." << std::endl;
+
+    const char* text =
+        "ID,Title,URL,Topic,Difficulty,Rating,Prereqs,Duration\n"
+        "1,Good,http://a,Arrays,10,4.5,,15\n"
+        "x2,Bad ID,http://b,Arrays,10,4.5,,15\n"
+        "3,Short Row,http://c\n"
+        "4,\"Bad\"quote,http://d,Arrays,10,4.5,,15\n"
+        "5,Bad Rating,http://e,Arrays,10,high,,15\n"
+        "6,Good Again,http://f,Arrays,10,4.5,,15\n"
+        "7,\"Never closed,http://g,Arrays,10,4.5,,15\n";
+    size_t rejected;
+    std::vector<Resource*> data = parseText(text, rejected);
+
+    assert(rejected == 5);
+    assert(data.size() == 2);
+    assert(data[0]->id == 1 && data[1]->id == 6);
+
+    for (auto* r : data) delete r;
+    std::cout << "[PASS] Per-Row Error Test Passed." << std::endl;
+}
+
+// The mapped loader must agree with the original getline loader on unquoted data
+void testMatchesStreamLoader() {
+    std::cout << "\n[TEST] Running Mapped vs Stream Loader Test..." << std::endl;
+
+    std::vector<Resource*> mapped = CSVParser::loadResources("data/resources.csv");
+    std::vector<Resource*> stream = CSVParser::loadResourcesStream("data/resources.csv");
+    assert(!mapped.empty() && mapped.size() == stream.size());
+    for (size_t i = 0; i < mapped.size(); i++) {
+        const Resource* a = mapped[i];
+        const Resource* b = stream[i];
+        assert(a->id == b->id && a->title == b->title && a->url == b->url && a->topic == b->topic);
+        assert(a->difficulty == b->difficulty && a->rating == b->rating && a->duration == b->duration);
+        assert(a->prereqIDs == b->prereqIDs);
+    }
+
+    for (auto* r : mapped) delete r;
+    for (auto* r : stream) delete r;
+    std::cout << "[PASS] Mapped vs Stream Loader Test Passed." << std::endl;
+}
+
+// Chunk starts must land on record boundaries even when quoted fields hold line breaks
+void testChunkBoundaries() {
+    std::cout << "\n[TEST] Running Quote-Aware Chunking Test..." << std::endl;
+
+    std::string text = "ID,Title,URL,Topic,Difficulty,Rating,Prereqs,Duration\n";
+    for (int i = 1; i <= 200; i++) {
+        text += std::to_string(i) + ",\"Title " + std::to_string(i) + "\nline two, \"\"quoted\"\"\n\",http://x,T,1,4.5,,10\n";
+    }
+
+    size_t rejected;
+    std::vector<Resource*> whole = parseText(text.c_str(), rejected);
+    assert(rejected == 0 && whole.size() == 200);
+
+    for (size_t chunks : {2, 7, 64, 1000}) {
+        std::vector<size_t> starts = CSVParser::findChunkBoundaries(text.data(), text.size(), chunks);
+        assert(starts[0] == 0 && starts.size() <= chunks);
+        starts.push_back(text.size());
+
+        std::vector<Resource*> pieces;
+        for (size_t i = 0; i + 1 < starts.size(); i++) {
+            assert(text[starts[i + 1] - 1] == '\n');
+            rejected += CSVParser::parseRecords(text.data() + starts[i], starts[i + 1] - starts[i],
+                                                pieces, "chunk", 1, i == 0);
+        }
+        assert(rejected == 0 && pieces.size() == whole.size());
+        for (size_t i = 0; i < pieces.size(); i++) assert(pieces[i]->title == whole[i]->title);
+        for (auto* r : pieces) delete r;
+    }
+
+    for (auto* r : whole) delete r;
+    std::cout << "[PASS] Quote-Aware Chunking Test Passed." << std::endl;
+}
+
+// Every SIMD kernel must produce exactly the scalar bitmaps, and parse the same rows
+void testScanKernels() {
+    std::cout << "\n[TEST] Running Structural Scanner Kernel Test..." << std::endl;
+
+    std::string text;
+    const char alphabet[] = "ab,\n\";;1 \r";
+    unsigned seed = 7;
+    for (int i = 0; i < 1000; i++) {
+        seed = seed * 1103515245 + 12345;
+        text += alphabet[(seed >> 16) % (sizeof(alphabet) - 1)];
+    }
+
+    CSVScan::Kernel original = CSVScan::activeKernel();
+    std::vector<std::vector<size_t>> reference;
+    for (CSVScan::Kernel kernel : CSVScan::availableKernels()) {
+        assert(CSVScan::setKernel(kernel));
+        std::vector<std::vector<size_t>> found(CSVScan::MASK_COUNT);
+        for (int kind = 0; kind < CSVScan::MASK_COUNT; kind++) {
+            CSVScan::Cursor scan(text.data(), text.size());
+            CSVScan::MaskKind mask = static_cast<CSVScan::MaskKind>(kind);
+            for (size_t pos = scan.next(0, mask); pos < text.size(); pos = scan.next(pos + 1, mask)) {
+                found[kind].push_back(pos);
+            }
+        }
+        if (reference.empty()) {
+            // Scalar kernel comes first; check it against the bytes themselves
+            for (size_t pos : found[CSVScan::MASK_QUOTE]) assert(text[pos] == '"');
+            for (size_t pos : found[CSVScan::MASK_SEMICOLON]) assert(text[pos] == ';');
+            size_t ends = 0;
+            for (char c : text) ends += (c == ',' || c == '\n');
+            assert(found[CSVScan::MASK_FIELD_END].size() == ends);
+            reference = found;
+        }
+        assert(found == reference);
+
+        std::vector<Resource*> data = CSVParser::loadResources("data/resources.csv");
+        assert(data.size() > 0);
+        for (auto* r : data) delete r;
+        std::cout << "  kernel " << CSVScan::kernelName(kernel) << " OK" << std::endl;
+    }
+    CSVScan::setKernel(original);
+
+    std::cout << "[PASS] Structural Scanner Kernel Test Passed." << std::endl;
+}
+
+// Streaming delivers the same resources, in file order, in bounded batches
+void testStreamResources() {
+    std::cout << "\n[TEST] Running Streaming Loader Test..." << std::endl;
+
+    std::vector<Resource*> whole = CSVParser::loadResources("data/resources.csv");
+    std::vector<Resource*> streamed;
+    size_t batches = 0;
+    size_t delivered = CSVParser::streamResources("data/resources.csv", 16, [&](std::vector<Resource*>& batch) {
+        assert(!batch.empty() && batch.size() <= 16);
+        streamed.insert(streamed.end(), batch.begin(), batch.end());
+        batches++;
+    });
+    assert(delivered == whole.size() && streamed.size() == whole.size());
+    assert(batches == (whole.size() + 15) / 16);
+    for (size_t i = 0; i < whole.size(); i++) {
+        assert(streamed[i]->id == whole[i]->id && streamed[i]->title == whole[i]->title);
+    }
+    assert(CSVParser::streamResources("no/such/file.csv", 16, [](std::vector<Resource*>&) { assert(false); }) == 0);
+
+    for (auto* r : whole) delete r;
+    for (auto* r : streamed) delete r;
+    std::cout << "[PASS] Streaming Loader Test Passed." << std::endl;
+}
+
+// The parallel loader returns the same resources, ordered by ID
+void testParallelLoader() {
+    std::cout << "\n[TEST] Running Parallel Loader Test..." << std::endl;
+
+    std::vector<Resource*> serial = CSVParser::loadResources("data/resources.csv");
+    std::stable_sort(serial.begin(), serial.end(), [](const Resource* a, const Resource* b) { return a->id < b->id; });
+
+    // Tiny minimum chunk size so the small sample file is really split
+    std::vector<Resource*> parallel = CSVParser::loadResourcesParallel("data/resources.csv", 4, 256);
+    assert(parallel.size() == serial.size());
+    for (size_t i = 0; i < serial.size(); i++) {
+        assert(parallel[i]->id == serial[i]->id && parallel[i]->title == serial[i]->title);
+        assert(parallel[i]->prereqIDs == serial[i]->prereqIDs);
+    }
+
+    for (auto* r : serial) delete r;
+    for (auto* r : parallel) delete r;
+    std::cout << "[PASS] Parallel Loader Test Passed." << std::endl;
+}
+
+// Arena-backed resources must match heap ones field for field
+void testResourceStore() {
+    std::cout << "\n[TEST] Running Resource Store Test..." << std::endl;
+
+    ResourceStore store;
+    std::vector<Resource*> stored = CSVParser::loadResources("data/resources.csv", &store);
+    std::vector<Resource*> heap = CSVParser::loadResources("data/resources.csv");
+    assert(!stored.empty() && stored.size() == heap.size() && store.size() == stored.size());
+    for (size_t i = 0; i < stored.size(); i++) {
+        const Resource* a = stored[i];
+        const Resource* b = heap[i];
+        assert(a->id == b->id && a->title == b->title && a->url == b->url && a->topic == b->topic);
+        assert(a->url.str() == b->url.str() && a->prereqIDs == b->prereqIDs && a->rating == b->rating);
+    }
+
+    // Same topic, same interned ID; URL prefixes are shared and rejoin losslessly
+    Resource x(1, "X", "https://example.com/search?q=one", "Graphs", 10, 4.0, {}, 10);
+    Resource y(2, "Y", "https://example.com/search?q=two", "Graphs", 10, 4.0, {2, 3}, 10);
+    assert(x.topic.id == y.topic.id && x.topic == "Graphs" && x.topic.id != Topic("Trees").id);
+    assert(x.url.prefix == y.url.prefix && x.url.str() == "https://example.com/search?q=one");
+    assert(x.url == std::string_view("https://example.com/search?q=one") && x.url != y.url);
+
+    // Copies into another store are deep
+    ResourceStore other;
+    Resource* copy = other.create(y);
+    assert(copy->title == "Y" && copy->title.data() != y.title.data());
+    assert((copy->prereqIDs == std::vector<int>{2, 3}) && copy->url == y.url && copy->topic == y.topic);
+
+    // absorb() keeps the resources alive after their store is emptied
+    store.absorb(other);
+    assert(other.size() == 0 && copy->title == "Y");
+
+    for (auto* r : heap) delete r;
+    std::cout << "[PASS] Resource Store Test Passed." << std::endl;
+}
+
+// CSV -> binary catalog -> resources must be lossless, in file order, with partial reads
+void testBinaryCatalog() {
+    std::cout << "\n[TEST] Running Binary Catalog Test..." << std::endl;
+
+    ResourceStore store;
+    std::vector<Resource*> csv = CSVParser::loadResources("data/resources.csv", &store);
+    // Odd ratings (stored raw) and negative deltas must survive too
+    csv.push_back(store.create(7, "Odd Rating", "http://x/odd", "Graphs", -5, 3.14159, nullptr, 0, 12));
+    int prereqs[] = {900000, 1, 7};
+    csv.push_back(store.create(2000000000, "Far ID", "", "Zeta", 0, 4.25, prereqs, 3, 0));
+
+    const std::string path = "test_parser.tmp.ccbin";
+    assert(BinaryCatalog::write(path, csv, 16)); // Small blocks so the sample spans many
+    assert(BinaryCatalog::isBinaryCatalog(path) && !BinaryCatalog::isBinaryCatalog("data/resources.csv"));
+
+    BinaryCatalog::Reader reader;
+    std::string reason;
+    assert(reader.open(path, reason));
+    assert(reader.resourceCount() == csv.size() && reader.blockCount() == (csv.size() + 15) / 16);
+
+    ResourceStore binaryStore;
+    std::vector<Resource*> binary;
+    assert(reader.readAll(binary, &binaryStore));
+    assert(binary.size() == csv.size());
+    for (size_t i = 0; i < csv.size(); i++) {
+        const Resource* a = csv[i];
+        const Resource* b = binary[i];
+        assert(a->id == b->id && a->title == b->title && a->url == b->url && a->topic == b->topic);
+        assert(a->difficulty == b->difficulty && a->rating == b->rating && a->duration == b->duration);
+        assert(a->prereqIDs == b->prereqIDs);
+    }
+
+    // Heap resources and block-at-a-time streaming agree with the store path
+    std::vector<Resource*> heap = BinaryCatalog::loadResources(path);
+    assert(heap.size() == csv.size() && heap.back()->url.empty() && heap[heap.size() - 2]->rating == 3.14159);
+    auto dropBatch = [](std::vector<Resource*>& batch) {
+        assert(!batch.empty() && batch.size() <= 16);
+        for (auto* r : batch) delete r;
+    };
+    size_t streamed = 0;
+    assert(BinaryCatalog::streamResources(path, dropBatch, nullptr, &streamed));
+    assert(streamed == csv.size());
+
+    // An ID range decodes only the blocks that overlap it
+    std::vector<Resource*> range;
+    assert(reader.readRange(10, 20, range, &binaryStore));
+    size_t expected = 0;
+    for (auto* r : csv) expected += r->id >= 10 && r->id <= 20;
+    assert(range.size() == expected);
+    for (auto* r : range) assert(r->id >= 10 && r->id <= 20);
+
+    // A flipped byte in a block is caught by that block's checksum
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(static_cast<std::streamoff>(reader.block(1).offset + 2));
+        file.put('\x7f');
+    }
+    BinaryCatalog::Reader damaged;
+    std::vector<Resource*> partial;
+    assert(damaged.open(path, reason));
+    assert(damaged.readBlock(0, partial) && !damaged.readBlock(1, partial));
+    assert(BinaryCatalog::loadResources(path).empty());
+    // Streaming delivers the intact first block, then reports the catalog incomplete
+    assert(!BinaryCatalog::streamResources(path, dropBatch, nullptr, &streamed));
+    assert(streamed == reader.block(0).count);
+
+    for (auto* r : heap) delete r;
+    for (auto* r : partial) delete r;
+    std::remove(path.c_str());
+    std::cout << "[PASS] Binary Catalog Test Passed." << std::endl;
+}
 
 int main() {
     // Test the loading function
@@ -34,5 +344,15 @@ int main() {
     // Cleanup
     for(auto* ptr : data) delete ptr;
 
+    testQuotedFields();
+    testRowErrors();
+    testMatchesStreamLoader();
+    testChunkBoundaries();
+    testScanKernels();
+    testParallelLoader();
+    testStreamResources();
+    testResourceStore();
+    testBinaryCatalog();
+
     return 0;
 }
\ No newline at end of file
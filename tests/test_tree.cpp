@@ -6,8 +6,13 @@
 #include <random>
 #include <iomanip>
 #include <algorithm>
+#include <map>
+#include <tuple>
+#include <cstdint>
 #include "../include/AVLTree.h"
 #include "../include/Trie.h"
+#include "../include/NGramIndex.h"
+#include "../include/TextIndex.h"
 #include "../include/Resource.h"
 
 using namespace std;
@@ -214,6 +219,636 @@ void testTriePerformance() {
          << fixed << setprecision(2) << (double)trie.getNodeCount() / (NUM_WORDS * WORD_LENGTH) * 100 << "%)" << endl;
 }
 
+// Path compression: edges split on insert, re-merge on remove, and prefixes may end mid-edge
+void testRadixTrie() {
+    cout << "\n[TEST] Running Radix Trie Test..." << endl;
+
+    Trie trie;
+    trie.insert("Graph Theory", 1);
+    assert(trie.getNodeCount() == 2); // Root + one edge for the whole key
+    trie.insert("graph traversal", 2);
+    assert(trie.getNodeCount() == 4); // "graph t" splits into "heory" and "raversal"
+    assert(trie.getResourcesByPrefix("GRAPH T").size() == 2);
+    assert(trie.getResourcesByPrefix("graph tr") == vector<int>{2});
+    assert(trie.getResourcesByPrefix("graph tx").empty());
+    assert(trie.getResourcesByPrefix("graph theory and more").empty());
+
+    // A key ending inside an edge splits it and becomes an end node itself
+    trie.insert("graph", 3);
+    assert(trie.getNodeCount() == 5);
+    auto structure = trie.getStructure();
+    assert(find(structure.first.begin(), structure.first.end(), "ROOT->graph:graph") != structure.first.end());
+    assert(find(structure.second.begin(), structure.second.end(), "graph:1:1") != structure.second.end());
+
+    // Removing re-merges single-child chains, back to the original shape
+    assert(trie.remove("graph", 3));
+    assert(trie.getNodeCount() == 4);
+    assert(trie.remove("Graph Traversal", 2));
+    assert(trie.getNodeCount() == 2);
+    assert(trie.getResourcesByPrefix("g") == vector<int>{1});
+    assert(!trie.remove("graph the", 1)); // Not a stored key
+
+    // Wide nodes switch to the dense table and keep working through removals
+    Trie wide;
+    for (int c = 0; c < 40; c++) wide.insert(string(1, static_cast<char>('!' + c)) + "key", c);
+    assert(wide.getResourcesByPrefix("").size() == 40);
+    assert(wide.getResourcesByPrefix("#k") == vector<int>{2});
+    for (int c = 0; c < 40; c += 2) assert(wide.remove(string(1, static_cast<char>('!' + c)) + "key", c));
+    assert(wide.getResourcesByPrefix("").size() == 20 && wide.getResourcesByPrefix("#").empty());
+
+    // Against a brute-force prefix scan over random keys with shared prefixes
+    mt19937 gen(7);
+    vector<pair<string, int>> keys;
+    Trie random;
+    for (int i = 0; i < 3000; i++) {
+        string key;
+        int length = 1 + gen() % 12;
+        for (int j = 0; j < length; j++) key += "abAB "[gen() % 5];
+        keys.push_back(make_pair(key, i));
+        random.insert(key, i);
+    }
+    for (int i = 0; i < 3000; i += 3) assert(random.remove(keys[i].first, keys[i].second));
+    for (int q = 0; q < 300; q++) {
+        string prefix;
+        int length = gen() % 6;
+        for (int j = 0; j < length; j++) prefix += "abAB "[gen() % 5];
+        vector<int> expected;
+        for (int i = 0; i < 3000; i++) {
+            if (i % 3 == 0 || keys[i].first.size() < prefix.size()) continue;
+            bool match = true;
+            for (size_t j = 0; j < prefix.size(); j++) match = match && tolower(keys[i].first[j]) == tolower(prefix[j]);
+            if (match) expected.push_back(i);
+        }
+        vector<int> got = random.getResourcesByPrefix(prefix);
+        sort(got.begin(), got.end());
+        assert(got == expected);
+    }
+
+    cout << "[PASS] Radix Trie Test Passed." << endl;
+}
+
+// Freezing keeps every answer and the structure dump; a mutation thaws the trie first
+void testFrozenTrie() {
+    cout << "\n[TEST] Running Frozen Trie Test..." << endl;
+
+    mt19937 gen(11);
+    Trie live, frozen;
+    for (int i = 0; i < 2000; i++) {
+        string key;
+        int length = 1 + gen() % 10;
+        for (int j = 0; j < length; j++) key += "abcAB "[gen() % 6];
+        live.insert(key, i);
+        frozen.insert(key, i);
+    }
+    // Plus one node wide enough for the binary-searched child keys
+    for (int c = 0; c < 40; c++) {
+        live.insert(string(1, static_cast<char>('!' + c)), 5000 + c);
+        frozen.insert(string(1, static_cast<char>('!' + c)), 5000 + c);
+    }
+    auto structure = live.getStructure();
+    size_t liveMemory = live.getMemoryUsage();
+
+    frozen.freeze();
+    assert(frozen.isFrozen() && !live.isFrozen());
+    assert(frozen.getNodeCount() == live.getNodeCount());
+    assert(frozen.getRevision() == live.getRevision());
+    assert(frozen.getStructure() == structure);
+    assert(frozen.getMemoryUsage() < liveMemory);
+    for (int q = 0; q < 500; q++) {
+        string prefix;
+        int length = gen() % 6;
+        for (int j = 0; j < length; j++) prefix += "abcAB !#"[gen() % 8];
+        assert(frozen.getResourcesByPrefix(prefix) == live.getResourcesByPrefix(prefix));
+    }
+
+    // Short prefixes with big subtrees are served from sorted, deduplicated posting lists
+    FrozenTrie arrays;
+    frozen.exportFrozen(arrays);
+    uint32_t shallow = arrays.locate("a");
+    assert(shallow != FrozenTrie::kNone && arrays.postingOffsets[shallow] < arrays.postingOffsets[shallow + 1]);
+    vector<int> listed = frozen.getResourcesByPrefix("a");
+    assert(is_sorted(listed.begin(), listed.end()) && adjacent_find(listed.begin(), listed.end()) == listed.end());
+
+    // Pages resume after the last ID and add up to the full result, frozen or live
+    for (const string& prefix : vector<string>{"", "a", "ab", "b c", "zz"}) {
+        for (Trie* t : {&frozen, &live}) {
+            vector<int> pages;
+            int64_t after = INT64_MIN;
+            bool more = true;
+            while (more) {
+                vector<int> page = t->getPageByPrefix(prefix, after, 7, more);
+                assert(page.size() <= 7 && (page.size() == 7 || !more));
+                if (page.empty()) break;
+                pages.insert(pages.end(), page.begin(), page.end());
+                after = page.back();
+            }
+            assert(pages == t->getResourcesByPrefix(prefix));
+        }
+    }
+
+    // Deeply nested big subtrees: postings stay within budget, answers unchanged
+    Trie chain;
+    for (int k = 1; k <= 100; k++) {
+        for (int j = 0; j < 10; j++) chain.insert(string(k, 'a'), k * 10 + j);
+    }
+    chain.freeze();
+    FrozenTrie chainArrays;
+    chain.exportFrozen(chainArrays);
+    assert(chainArrays.postings.size() <= FrozenTrie::kPostingBudget * chainArrays.ids.size());
+    assert(chain.getResourcesByPrefix("a").size() == 1000);
+    assert(chain.getResourcesByPrefix(string(95, 'a')).size() == 60);
+
+    // An ID indexed under two keys (title and topic) is listed once
+    Trie twice;
+    twice.insert("Graph Theory", 7);
+    twice.insert("Graphs", 7);
+    twice.insert("Grid", 3);
+    assert(twice.getResourcesByPrefix("gr") == (vector<int>{3, 7}));
+    twice.freeze();
+    assert(twice.getResourcesByPrefix("gr") == (vector<int>{3, 7}));
+
+    // Insert and remove thaw; freezing again gives the same arrays as a fresh export
+    frozen.insert("abc", 9999);
+    assert(!frozen.isFrozen());
+    assert(frozen.remove("abc", 9999));
+    frozen.freeze();
+    FrozenTrie a, b;
+    frozen.exportFrozen(a);
+    live.exportFrozen(b);
+    assert(a.isValid() && a.ids == b.ids && a.labels == b.labels && a.childNodes == b.childNodes);
+    assert(a.postingOffsets == b.postingOffsets && a.postings == b.postings);
+    assert(frozen.getStructure() == structure);
+
+    cout << "[PASS] Frozen Trie Test Passed." << endl;
+}
+
+// Top-k completions match a brute-force ranking of every key under the prefix
+void testTrieCompletion() {
+    cout << "\n[TEST] Running Trie Completion Test..." << endl;
+
+    mt19937 gen(5);
+    map<string, vector<int>> keys;   // Lowercased key -> IDs
+    vector<float> rating(3000);
+    Trie trie;
+    for (int i = 0; i < 3000; i++) {
+        string key;
+        int length = 1 + gen() % 8;
+        for (int j = 0; j < length; j++) key += "abcd "[gen() % 5];
+        rating[i] = static_cast<float>(gen() % 50) / 10.0f; // Many ties
+        trie.insert(key, i);
+        keys[key].push_back(i);
+    }
+    assert(trie.complete("a", 5).empty()); // Not frozen and ranked yet
+    trie.freeze();
+    assert(trie.rankCompletions([&rating](int id) { return rating[id]; }));
+
+    for (const string& prefix : vector<string>{"", "a", "ab", "abc", "d d", "cc", "zz"}) {
+        // Expected order: best rating, then more IDs, then key order
+        vector<tuple<float, int, string, int>> expected;
+        for (const auto& entry : keys) {
+            if (entry.first.compare(0, prefix.size(), prefix) != 0) continue;
+            int best = entry.second[0];
+            for (int id : entry.second) {
+                if (rating[id] > rating[best] || (rating[id] == rating[best] && id < best)) best = id;
+            }
+            expected.push_back(make_tuple(-rating[best], -(int)entry.second.size(), entry.first, best));
+        }
+        sort(expected.begin(), expected.end());
+        for (size_t k : {1, 5, 16, 17, 40, 5000}) {
+            vector<TrieCompletion> got = trie.complete(prefix, k); // Capped at kTopCompletions
+            assert(got.size() == min(min(k, FrozenTrie::kTopCompletions), expected.size()));
+            for (size_t i = 0; i < got.size(); i++) {
+                assert(got[i].key == get<2>(expected[i]));
+                assert(got[i].bestID == get<3>(expected[i]));
+                assert(got[i].count == keys[got[i].key].size());
+            }
+        }
+    }
+
+    // The ranking survives an export/import (as in a snapshot); a damaged one is rejected
+    FrozenTrie ranked;
+    trie.exportFrozen(ranked);
+    FrozenTrie damaged = ranked;
+    Trie loaded;
+    assert(loaded.importFrozen(std::move(ranked)) && loaded.isRanked());
+    for (const string& prefix : vector<string>{"", "a", "d d"}) {
+        vector<TrieCompletion> want = trie.complete(prefix, 16);
+        vector<TrieCompletion> got = loaded.complete(prefix, 16);
+        assert(got.size() == want.size());
+        for (size_t i = 0; i < got.size(); i++) assert(got[i].key == want[i].key && got[i].bestID == want[i].bestID);
+    }
+    damaged.completions.push_back(0);
+    Trie rejected;
+    assert(!rejected.importFrozen(std::move(damaged)));
+
+    // A mutation thaws the trie and drops the ranking until the next freeze
+    trie.insert("abc", 9999);
+    assert(trie.complete("a", 5).empty());
+
+    cout << "[PASS] Trie Completion Test Passed." << endl;
+}
+
+void testNGramIndex() {
+    cout << "\n[TEST] Running N-Gram Substring Index Test..." << endl;
+
+    // Small alphabet: long, multi-block posting lists and many near misses
+    mt19937 gen(23);
+    vector<unique_ptr<Resource>> owned;
+    vector<Resource*> list;
+    for (int i = 0; i < 5000; i++) {
+        string title, topic;
+        int length = 2 + gen() % 14;
+        for (int j = 0; j < length; j++) title += "abcAB "[gen() % 6];
+        topic = string("Topic") + "xyz"[gen() % 3];
+        owned.push_back(make_unique<Resource>(i * 3, title, "", topic, 1, 1.0f, vector<int>{}, 10));
+        list.push_back(owned.back().get());
+    }
+    NGramIndex index;
+    index.build(list);
+    assert(index.size() == list.size());
+
+    auto contains = [](string hay, string needle) {
+        for (char& c : hay) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+        for (char& c : needle) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+        return hay.find(needle) != string::npos;
+    };
+    vector<string> queries = {"", "a", "Ab", "abc", "bab", "ABCA", "a b", "cab ab", "topicx", "picz", "cccccc", "qqq", "aaaaaaaaaaaaaaaaa"};
+    for (int i = 0; i < 40; i++) {
+        string q;
+        int length = 3 + gen() % 5;
+        for (int j = 0; j < length; j++) q += "abc "[gen() % 4];
+        queries.push_back(q);
+    }
+    vector<uint32_t> got;
+    for (const string& q : queries) {
+        vector<uint32_t> expected;
+        for (uint32_t row = 0; row < list.size(); row++) {
+            if (contains(string(list[row]->title), q) || contains(string(list[row]->topic.name()), q)) expected.push_back(row);
+        }
+        NGramIndex::Stats stats;
+        index.find(q, got, &stats);
+        assert(got == expected);
+        assert(stats.candidates >= got.size());
+    }
+
+    // update() after a RELOAD-style edit (rows replaced, holes filled from the end, rows
+    // appended) lays out exactly what a fresh build does, and survives an export/import
+    vector<Resource*> edited = list;
+    vector<char> dirty(list.size(), 0);
+    for (uint32_t row = 0; row < edited.size(); row += 37) {
+        owned.push_back(make_unique<Resource>(edited[row]->id, "cab " + string(edited[row]->title), "", "Topicq", 1, 1.0f, vector<int>{}, 10));
+        edited[row] = owned.back().get();
+        dirty[row] = 1;
+    }
+    for (uint32_t hole = 101; hole + 1 < edited.size(); hole += 301) {
+        edited[hole] = edited.back();
+        dirty[hole] = 1;
+        edited.pop_back();
+    }
+    vector<uint32_t> changedRows;
+    for (uint32_t row = 0; row < edited.size(); row++) {
+        if (dirty[row]) changedRows.push_back(row);
+    }
+    for (int i = 0; i < 50; i++) {
+        owned.push_back(make_unique<Resource>(100000 + i, "bbb aca" + to_string(i), "", "Topicz", 1, 1.0f, vector<int>{}, 10));
+        changedRows.push_back(static_cast<uint32_t>(edited.size()));
+        edited.push_back(owned.back().get());
+    }
+    NGramIndex patched, rebuilt;
+    patched.update(index, edited, changedRows);
+    rebuilt.build(edited);
+    NGramIndex::Arrays a, b;
+    patched.exportArrays(a);
+    rebuilt.exportArrays(b);
+    assert(a.grams == b.grams && a.counts == b.counts && a.skipOffsets == b.skipOffsets && a.data == b.data);
+    assert(a.text == b.text && a.textOffsets == b.textOffsets && a.skips.size() == b.skips.size());
+    for (size_t i = 0; i < a.skips.size(); i++) {
+        assert(a.skips[i].firstRow == b.skips[i].firstRow && a.skips[i].offset == b.skips[i].offset);
+    }
+    assert(NGramIndex::isValid(a, edited.size()));
+    NGramIndex loaded;
+    assert(loaded.importArrays(std::move(a), edited));
+    vector<uint32_t> expected;
+    for (const string& q : queries) {
+        loaded.find(q, got);
+        rebuilt.find(q, expected);
+        assert(got == expected);
+    }
+    b.textOffsets.pop_back();
+    assert(!NGramIndex::isValid(b, edited.size()));
+    assert(!loaded.importArrays(std::move(b), edited));
+
+    // Rebuilding drops the old rows
+    list.resize(10);
+    index.build(list);
+    index.find("topic", got);
+    assert(got.size() == 10);
+
+    // A short query never matches across the end of one row and the start of the next
+    Resource graphs(1, "Shortest Paths", "", "Graphs", 1, 1.0, {}, 10);
+    Resource basics(2, "Graph Basics", "", "Trees", 1, 1.0, {}, 10);
+    index.build({&graphs, &basics});
+    index.find("sg", got);
+    assert(got.empty());
+    index.find("s", got);
+    assert((got == vector<uint32_t>{0, 1}));
+
+    cout << "[PASS] N-Gram Substring Index Test Passed." << endl;
+}
+
+void testTrieFuzzy() {
+    cout << "\n[TEST] Running Trie Fuzzy Search Test..." << endl;
+
+    // Optimal string alignment distance: Levenshtein plus adjacent swaps
+    auto distance = [](const string& a, const string& b) {
+        vector<vector<uint32_t>> d(a.size() + 1, vector<uint32_t>(b.size() + 1));
+        for (size_t i = 0; i <= a.size(); i++) d[i][0] = static_cast<uint32_t>(i);
+        for (size_t j = 0; j <= b.size(); j++) d[0][j] = static_cast<uint32_t>(j);
+        for (size_t i = 1; i <= a.size(); i++) {
+            for (size_t j = 1; j <= b.size(); j++) {
+                d[i][j] = min({d[i - 1][j] + 1, d[i][j - 1] + 1, d[i - 1][j - 1] + (a[i - 1] == b[j - 1] ? 0u : 1u)});
+                if (i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1]) d[i][j] = min(d[i][j], d[i - 2][j - 2] + 1);
+            }
+        }
+        return d[a.size()][b.size()];
+    };
+
+    mt19937 gen(24);
+    vector<string> keys;
+    Trie trie;
+    for (int i = 0; i < 1500; i++) {
+        string key;
+        int length = 1 + gen() % 9;
+        for (int j = 0; j < length; j++) key += "abcd "[gen() % 5];
+        keys.push_back(key);
+        trie.insert(key, i);
+        trie.insert(key, i); // Duplicates come back once
+    }
+    Trie frozen;
+    FrozenTrie arrays;
+    trie.exportFrozen(arrays);
+    frozen.importFrozen(std::move(arrays));
+
+    vector<string> queries = {"", "a", "ab", "ba", "abcd", "dcba", "a bc", "ddddd", "zzz", "Abc", "cabdab"};
+    for (const string& q : queries) {
+        for (uint32_t edits = 0; edits <= 3; edits++) {
+            // Expected: the fewest edits between the query and any prefix of the key
+            vector<pair<uint32_t, int>> expected;
+            string lowered = q;
+            for (char& c : lowered) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+            for (int id = 0; id < (int)keys.size(); id++) {
+                uint32_t best = UINT32_MAX;
+                for (size_t len = 0; len <= keys[id].size(); len++) best = min(best, distance(lowered, keys[id].substr(0, len)));
+                if (best <= min(edits, FrozenTrie::kMaxFuzzyEdits)) expected.push_back(make_pair(best, id));
+            }
+            sort(expected.begin(), expected.end());
+            vector<TrieFuzzyMatch> got = frozen.fuzzySearch(q, edits);
+            vector<TrieFuzzyMatch> live = trie.fuzzySearch(q, edits);
+            assert(got.size() == expected.size() && live.size() == expected.size());
+            for (size_t i = 0; i < got.size(); i++) {
+                assert(got[i].edits == expected[i].first && got[i].id == expected[i].second);
+                assert(live[i].edits == got[i].edits && live[i].id == got[i].id);
+            }
+            // A limit keeps the first matches of the full answer
+            for (size_t limit = 1; limit <= 3; limit++) {
+                vector<TrieFuzzyMatch> first = frozen.fuzzySearch(q, edits, limit);
+                assert(first.size() == min(limit, got.size()));
+                for (size_t i = 0; i < first.size(); i++) assert(first[i].id == got[i].id && first[i].edits == got[i].edits);
+            }
+        }
+    }
+
+    // Pruning: a query far from every key stops two bytes below the root (5 + 25 steps)
+    size_t rows = 0;
+    assert(frozen.fuzzySearch("zzzzzz", 1, 0, &rows).empty());
+    assert(rows <= 30);
+
+    cout << "[PASS] Trie Fuzzy Search Test Passed." << endl;
+}
+
+void testTextIndex() {
+    cout << "\n[TEST] Running Ranked Text Index Test..." << endl;
+
+    // BM25 basics: rarer words and shorter titles score higher
+    vector<unique_ptr<Resource>> owned;
+    vector<Resource*> list;
+    auto add = [&](const string& title, const string& topic, double rating) {
+        owned.push_back(make_unique<Resource>((int)owned.size(), title, "", topic, 1, rating, vector<int>{}, 10));
+        list.push_back(owned.back().get());
+    };
+    add("Dijkstra Shortest Path", "Graphs", 4.0);
+    add("Graph Shortest Path Algorithms Explained In Depth", "Graphs", 5.0);
+    add("Longest Path in a DAG", "Graphs", 3.0);
+    add("Merge Sort", "Sorting", 4.5);
+    TextIndex small;
+    small.build(list);
+    vector<TextIndex::Hit> hits;
+    small.topK("graph SHORTEST path", 10, 0.0, hits);
+    assert(hits.size() == 3 && hits[0].row == 1 && hits[1].row == 0 && hits[2].row == 2);
+    small.topK("shortest path", 10, 0.0, hits);
+    assert(hits[0].row == 0 && hits[1].row == 1);
+    small.topK("shortest path", 10, 1.0, hits); // The rating bonus reorders near ties
+    assert(hits[0].row == 1);
+    small.topK("quantum", 10, 0.0, hits);
+    assert(hits.empty());
+
+    // WAND against scoring every matching row, on many words with skewed frequencies
+    mt19937 gen(25);
+    owned.clear();
+    list.clear();
+    for (int i = 0; i < 20000; i++) {
+        string title;
+        int words = 1 + gen() % 6;
+        for (int w = 0; w < words; w++) {
+            int rank = static_cast<int>(gen() % 60);
+            rank = rank * rank % 300; // Zipf-like: low word numbers are common
+            title += "w" + to_string(rank) + " ";
+        }
+        add(title, "t" + to_string(gen() % 7), static_cast<double>(gen() % 50) / 10.0);
+    }
+    TextIndex index;
+    index.build(list);
+    vector<TextIndex::Hit> expected;
+    size_t prunedRows = 0, allRows = 0;
+    for (int q = 0; q < 200; q++) {
+        string query;
+        int words = 1 + gen() % 4;
+        for (int w = 0; w < words; w++) query += "w" + to_string(gen() % 60 * (gen() % 60) % 300) + " ";
+        if (q % 5 == 0) query += "t3";
+        size_t k = 1 + gen() % 20;
+        double weight = q % 3 == 0 ? 0.5 : 0.0;
+        TextIndex::Stats wand, full;
+        index.topK(query, k, weight, hits, &wand);
+        index.topKExhaustive(query, k, weight, expected, &full);
+        assert(hits.size() == expected.size());
+        for (size_t i = 0; i < hits.size(); i++) {
+            assert(hits[i].row == expected[i].row && hits[i].score == expected[i].score);
+        }
+        prunedRows += wand.scored;
+        allRows += full.scored;
+    }
+    assert(prunedRows <= allRows);
+
+    // update() after RELOAD-style edits ranks like a fresh build, and survives an export/import.
+    // First edit: shorter rows, so the bounds still hold; second: much longer ones, so they are redone.
+    vector<string> queries;
+    for (int q = 0; q < 60; q++) queries.push_back("w" + to_string(gen() % 60 * (gen() % 60) % 300) + " w" + to_string(q) + " new t1");
+    TextIndex current;
+    current.update(index, list, {}); // Nothing changed: a copy
+    for (int round = 0; round < 2; round++) {
+        vector<Resource*> edited = list;
+        vector<char> dirty(list.size(), 0);
+        for (uint32_t row = round; row < edited.size(); row += 29) {
+            string title = round == 0 ? "w" + to_string(row % 300) : string(40, 'x') + " new new w7 w7 w7 w8 w9 w10 w11 w12";
+            owned.push_back(make_unique<Resource>(edited[row]->id, title, "", "t1", 1, 2.5, vector<int>{}, 10));
+            edited[row] = owned.back().get();
+            dirty[row] = 1;
+        }
+        for (uint32_t hole = 57 + round; hole + 1 < edited.size(); hole += 997) {
+            edited[hole] = edited.back();
+            dirty[hole] = 1;
+            edited.pop_back();
+        }
+        vector<uint32_t> changedRows;
+        for (uint32_t row = 0; row < edited.size(); row++) {
+            if (dirty[row]) changedRows.push_back(row);
+        }
+        for (int i = 0; i < 100; i++) {
+            owned.push_back(make_unique<Resource>(50000 + round * 100 + i, "new w" + to_string(i), "", "t9", 1, 4.9, vector<int>{}, 10));
+            changedRows.push_back(static_cast<uint32_t>(edited.size()));
+            edited.push_back(owned.back().get());
+        }
+        TextIndex patched, rebuilt;
+        patched.update(current, edited, changedRows);
+        rebuilt.build(edited);
+        assert(patched.termCount() == rebuilt.termCount());
+        TextIndex::Arrays arrays;
+        patched.exportArrays(arrays);
+        assert(TextIndex::isValid(arrays, edited.size()));
+        assert(current.importArrays(std::move(arrays), edited));
+        for (const string& query : queries) {
+            for (double weight : {0.0, 0.5}) {
+                current.topK(query, 10, weight, hits);
+                rebuilt.topKExhaustive(query, 10, weight, expected);
+                assert(hits.size() == expected.size());
+                for (size_t i = 0; i < hits.size(); i++) {
+                    assert(hits[i].row == expected[i].row && hits[i].score == expected[i].score);
+                }
+            }
+        }
+        list = edited;
+    }
+    TextIndex::Arrays broken;
+    current.exportArrays(broken);
+    broken.terms.back().firstSkip++;
+    assert(!TextIndex::isValid(broken, list.size()));
+
+    // A rare word next to one every row has: once the rare rows fill the top k,
+    // rows with only the common word are skipped without being scored
+    owned.clear();
+    list.clear();
+    for (int i = 0; i < 20000; i++) add(i < 10 || i % 400 == 0 ? "rare common" : "common filler", "Topic", 3.0);
+    index.build(list);
+    TextIndex::Stats wand, full;
+    index.topK("common rare", 10, 0.0, hits, &wand);
+    index.topKExhaustive("common rare", 10, 0.0, expected, &full);
+    assert(hits.size() == 10 && hits[0].row == 0 && hits[9].row == 9);
+    assert(full.scored == 20000 && wand.scored <= 10 + 50);
+
+    cout << "[PASS] Ranked Text Index Test Passed." << endl;
+}
+
+// ======================= Bulk Load Tests =======================
+
+void testBulkLoad() {
+    cout << "\n[TEST] Running Snapshot Bulk Load Test..." << endl;
+
+    // AVL: balanced build from sorted input (duplicates keep the first)
+    auto resources = generateRandomResources(1000, 1);
+    vector<Resource*> sorted;
+    for (auto& r : resources) sorted.push_back(r.get());
+    sorted.insert(sorted.begin() + 10, resources[9].get()); // duplicate ID 10
+
+    AVLTree tree;
+    tree.buildFromSorted(sorted);
+    assert(tree.getNodeCount() == 1000);
+    assert(tree.getMaxBalance() <= 1);
+    assert(tree.getHeight() == 10); // ceil(log2(1001))
+    assert(tree.search(500) == resources[499].get());
+
+    // Trie: frozen export -> import must answer every prefix the same way
+    Trie original;
+    original.insert("binary search", 2);
+    original.insert("binary tree", 3);
+    original.insert("graph", 4);
+    original.insert("graph traversal", 5);
+    original.insert("Graph", 6);
+
+    FrozenTrie exported;
+    original.exportFrozen(exported);
+    assert(exported.nodeCount() == (size_t)original.getNodeCount());
+    FrozenTrie truncated = exported;
+
+    Trie copy;
+    assert(copy.importFrozen(std::move(exported)));
+    assert(copy.isFrozen());
+    assert(copy.getNodeCount() == original.getNodeCount());
+    for (const string& prefix : vector<string>{"b", "binary ", "graph", "g", "x", ""}) {
+        auto a = original.getResourcesByPrefix(prefix);
+        auto b = copy.getResourcesByPrefix(prefix);
+        sort(a.begin(), a.end());
+        sort(b.begin(), b.end());
+        assert(a == b);
+    }
+
+    // Truncated export must be rejected
+    truncated.nodes.erase(truncated.nodes.end() - 2);
+    Trie broken;
+    assert(!broken.importFrozen(std::move(truncated)));
+
+    cout << "[PASS] Snapshot Bulk Load Test Passed." << endl;
+}
+
+// ======================= Incremental Update Tests =======================
+
+void testIncrementalUpdates() {
+    cout << "\n[TEST] Running Incremental Update (RELOAD) Test..." << endl;
+
+    // AVL: removals keep the tree balanced and searchable
+    auto resources = generateRandomResources(1000, 1);
+    AVLTree tree;
+    for (auto& r : resources) tree.insert(r.get());
+    for (int id = 2; id <= 1000; id += 2) assert(tree.remove(id));
+    assert(!tree.remove(2));
+    assert(tree.getNodeCount() == 500);
+    assert(tree.getMaxBalance() <= 1);
+    assert(tree.search(2) == nullptr);
+    assert(tree.search(501) == resources[500].get());
+
+    // replace() swaps the object for an ID without reshaping the tree
+    Resource updated(501, "Updated", "", "Type0", 1, 1.0f, {}, 10);
+    int height = tree.getHeight();
+    assert(tree.replace(&updated));
+    assert(tree.search(501) == &updated);
+    assert(tree.getHeight() == height);
+    assert(!tree.replace(resources[1].get())); // ID 2 was removed
+
+    // Trie: remove unlinks one ID and prunes nodes nothing else uses
+    Trie trie;
+    trie.insert("graph", 1);
+    trie.insert("graph traversal", 2);
+    int before = trie.getNodeCount();
+    trie.insert("grid", 3);
+    assert(trie.remove("grid", 3));
+    assert(trie.getNodeCount() == before);
+    assert(!trie.remove("grid", 3));
+    assert(trie.remove("graph traversal", 2));
+    assert(trie.getResourcesByPrefix("graph") == vector<int>{1});
+    assert(trie.getResourcesByPrefix("graph ").empty());
+
+    cout << "[PASS] Incremental Update Test Passed." << endl;
+}
+
 // ======================= Main Function =======================
 
 int main() {
@@ -228,6 +863,20 @@ int main() {
     // Run Trie tests
     testTrieBasic();
     testTriePerformance();
+    testRadixTrie();
+    testFrozenTrie();
+    testTrieCompletion();
+    testTrieFuzzy();
+
+    // Run substring index tests
+    testNGramIndex();
+    testTextIndex();
+
+    // Run snapshot bulk-load tests
+    testBulkLoad();
+
+    // Run RELOAD building-block tests
+    testIncrementalUpdates();
     
     cout << "\nAll tests completed successfully!" << endl;
     return 0;
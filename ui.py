@@ -38,7 +38,7 @@ if not EXE_PATH:
 # STATE MANAGEMENT
 if 'master_library' not in st.session_state:
     st.session_state.master_library = []
-    raw = run_cpp("LIST")
+    raw = run_cpp("LIST", analysis="NONE")
     st.session_state.master_library = parse_csv_lines(raw)
 
 if 'view_library' not in st.session_state:
@@ -142,7 +142,7 @@ with tab1:
         elif sort_mode == "Topic":
             cmd = "LIST|TOPIC"
 
-        raw_lines = run_cpp(cmd)
+        raw_lines = run_cpp(cmd, analysis="FULL")
         st.session_state.view_library = parse_csv_lines(raw_lines)
         
         # Update navigation history for search results
@@ -198,7 +198,7 @@ with tab2:
 
         if st.button("Generate Path"):
             cmd = f"PLAN|{target_title}"
-            raw_plan = run_cpp(cmd)
+            raw_plan = run_cpp(cmd, analysis="FULL")
             st.session_state.current_plan_data = parse_csv_lines(raw_plan)
             st.session_state.current_analysis = parse_analysis(raw_plan)
 
@@ -266,7 +266,7 @@ with tab3:
 
     if st.button("⚡ Maximize Score"):
         cmd = f"CRAM|{selected_topic}|{time_limit}"
-        raw_cram = run_cpp(cmd)
+        raw_cram = run_cpp(cmd, analysis="FULL")
         st.session_state.current_cram_data = parse_csv_lines(raw_cram)
         st.session_state.current_analysis = parse_analysis(raw_cram)
 
@@ -308,7 +308,7 @@ with tab4:
 
     if st.button("🌟 Get Top Rated"):
         cmd = f"SUGGEST|{k}|{level}"
-        raw_recs = run_cpp(cmd)
+        raw_recs = run_cpp(cmd, analysis="FULL")
         st.session_state.current_recs_data = parse_csv_lines(raw_recs)
         st.session_state.current_analysis = parse_analysis(raw_recs)
 
@@ -461,6 +461,9 @@ with tab5:
             if 'TREE_SEARCH_TIME_US' in analysis:
                 tree_search_time = float(analysis['TREE_SEARCH_TIME_US'])
                 st.metric("Tree Search Time", f"{tree_search_time:.2f} μs")
+            if 'COLUMN_LOOKUP_TIME_US' in analysis:
+                lookup_time = float(analysis['COLUMN_LOOKUP_TIME_US'])
+                st.metric("Column Lookup Time", f"{lookup_time:.2f} μs")
             if 'OPTIMIZER_TIME_US' in analysis:
                 opt_time = float(analysis['OPTIMIZER_TIME_US'])
                 st.metric("Optimizer Time", f"{opt_time:.2f} μs")
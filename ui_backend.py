@@ -5,6 +5,9 @@ Handles communication with C++ backend and data parsing
 
 import streamlit as st
 import subprocess
+import threading
+import itertools
+import socket
 import os
 
 
@@ -17,8 +20,144 @@ def get_exe():
             return os.path.abspath(p)
     return None
 
-def run_cpp(cmd):
-    """Execute C++ backend command and return output lines"""
+class EngineClient:
+    """Keeps one `codecompass_engine --serve` child alive and talks to it
+    over the framed stdin/stdout protocol, so the catalog is only loaded once."""
+
+    def __init__(self, exe_path):
+        self.exe_path = exe_path
+        self.proc = None
+        self.rfile = None
+        self.wfile = None
+        self.lock = threading.Lock()
+        self.ids = itertools.count(1)
+
+    def _alive(self):
+        return self.proc is not None and self.proc.poll() is None
+
+    def _start(self):
+        si = None
+        if os.name == 'nt':
+            si = subprocess.STARTUPINFO()
+            si.dwFlags |= subprocess.STARTF_USESHOWWINDOW
+
+        self.proc = subprocess.Popen(
+            [self.exe_path, "--serve"],
+            stdin=subprocess.PIPE, stdout=subprocess.PIPE, stderr=subprocess.DEVNULL,
+            text=True, bufsize=1, startupinfo=si
+        )
+        self.rfile, self.wfile = self.proc.stdout, self.proc.stdin
+        # Skip anything printed while the engine builds its indexes
+        for line in self.rfile:
+            if line.strip() == "---READY---":
+                return
+        raise RuntimeError("engine exited before becoming ready")
+
+    def _reset(self):
+        if self._alive():
+            self.proc.kill()
+        self.proc = None
+
+    def request(self, cmd):
+        """Send one command and return the lines between its response markers"""
+        with self.lock:
+            try:
+                return self._exchange(cmd)
+            except Exception:
+                # Broken pipe, failed start, closed stream...: the next call starts over
+                self._reset()
+                raise
+
+    def _exchange(self, cmd):
+        if not self._alive():
+            self._start()
+
+        req_id = str(next(self.ids))
+        self.wfile.write(f"{req_id} {cmd}\n")
+        self.wfile.flush()
+
+        lines = []
+        in_response = False
+        for line in self.rfile:
+            line = line.rstrip("\n")
+            if line == f"---RESPONSE {req_id}---":
+                in_response = True
+                continue
+            if line.startswith(f"---END_RESPONSE {req_id}|"):
+                return lines
+            if in_response:
+                lines.append(line)
+
+        raise RuntimeError("engine exited mid-response")
+
+
+class SocketEngineClient(EngineClient):
+    """Same protocol over the Unix socket of `codecompass_engine --socket <path>`.
+    Each connection is its own server-side session (LRU cache, history)."""
+
+    def __init__(self, socket_path):
+        super().__init__(None)
+        self.socket_path = socket_path
+        self.sock = None
+
+    def _alive(self):
+        return self.sock is not None
+
+    def _start(self):
+        sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        try:
+            sock.connect(self.socket_path)
+        except OSError:
+            sock.close()
+            raise
+        self.rfile = sock.makefile("r", encoding="utf-8", newline="\n")
+        self.wfile = sock.makefile("w", encoding="utf-8", newline="\n")
+        self.sock = sock  # Only a connected socket counts as alive
+
+    def _reset(self):
+        if self.sock is not None:
+            self.sock.close()
+        self.sock = None
+
+
+@st.cache_resource
+def get_client(exe_path):
+    """One engine process shared by every Streamlit session"""
+    return EngineClient(exe_path)
+
+
+def get_session_client():
+    """Per-browser-session connection when a shared socket server is configured"""
+    socket_path = os.environ.get("CODECOMPASS_SOCKET")
+    if not socket_path or not hasattr(socket, "AF_UNIX"):
+        return None
+    if 'engine_client' not in st.session_state:
+        st.session_state.engine_client = SocketEngineClient(socket_path)
+    return st.session_state.engine_client
+
+
+def run_cpp_once(exe_path, cmd):
+    """Fallback: one-shot process per command (slow, rebuilds the engine every time)"""
+    si = None
+    if os.name == 'nt':
+        si = subprocess.STARTUPINFO()
+        si.dwFlags |= subprocess.STARTF_USESHOWWINDOW
+
+    full_cmd = [exe_path, cmd]
+    res = subprocess.run(full_cmd, capture_output=True, text=True, startupinfo=si)
+
+    if res.returncode != 0 or not res.stdout.strip():
+        return []
+
+    return res.stdout.strip().splitlines()
+
+
+def run_cpp(cmd, analysis=None):
+    """Execute C++ backend command and return output lines.
+
+    analysis: None (engine default, counters only), "NONE" (results only)
+    or "FULL" (counters plus structure dumps for the visualizations).
+    """
     exe_path = get_exe()
     if not exe_path:
         return []
@@ -47,19 +186,16 @@ def run_cpp(cmd):
                        f"{prev_data['resource'].get('duration')}"]
             return []
 
-        # Rest of the function remains the same
-        si = None
-        if os.name == 'nt':
-            si = subprocess.STARTUPINFO()
-            si.dwFlags |= subprocess.STARTF_USESHOWWINDOW
+        if analysis:
+            cmd = f"@{analysis} {cmd}"
 
-        full_cmd = [exe_path, cmd]
-        res = subprocess.run(full_cmd, capture_output=True, text=True, startupinfo=si)
-
-        if res.returncode != 0 or not res.stdout.strip():
-            return []
+        try:
+            client = get_session_client() or get_client(exe_path)
+            lines = client.request(cmd)
+        except Exception:
+            return run_cpp_once(exe_path, cmd)
 
-        return res.stdout.strip().splitlines()
+        return [line for line in lines if line.strip()]
     except Exception as e:
         st.error(f"Backend Connection Error: {e}")
         return []